@@ -5,10 +5,19 @@
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <atomic>
+#include <csignal>
 
 using namespace nlohmann;
 using namespace std;
 
+// Ctrl+C / SIGTERM时置为false，主线程随后停止引擎并关闭轨迹文件
+static atomic<bool> running(true);
+
+static void onSignal(int) {
+    running = false;
+}
+
 // 更新任务, 通过网络接收新的task.json
 void UpdateTask();
 
@@ -74,36 +83,50 @@ int main() {
         // 创建Context用于存储传感器数据
         Context ctx;
         
+        // 设置SNIPPER_TRACE时录制传感器数据写入，可用snipper_replay回放
+        TraceRecorder recorder;
+        if (const char* trace = getenv("SNIPPER_TRACE")) {
+            if (recorder.open(trace)) {
+                ctx.setRecorder(&recorder);
+                cout << "Recording sensor trace to " << trace << endl;
+            }
+        }
+        
         // 模拟一些传感器数据
         ctx.set("temp", 45);  // 温度45度
         ctx.set("door", "open");  // 门是开着的
         ctx.set("emergency_button", "not_pressed");  // 紧急按钮未按下
 
-        // 创建runtime线程
-        thread runtimeThread([&]() {
-            while (true) {
-                engine.onSensorUpdate();
-                engine.tick(ctx);
-                this_thread::sleep_for(chrono::milliseconds(100));
-            }
-        });
+        // 启动事件驱动的运行循环：传感器更新通过loop.update唤醒引擎，
+        // 没有更新时每100ms定时tick一次，处理依赖时间的规则
+        EngineLoop loop(engine, ctx);
+        loop.set_fallback_interval_ms(100);
+        loop.start();
+
+        signal(SIGINT, onSignal);
+        signal(SIGTERM, onSignal);
 
         // 创建更新任务线程
         thread updateTaskThread([&]() {
-            while (true) {
+            while (running) {
                 UpdateTask();
             }
         });
 
         // 创建执行任务线程
         thread executeTaskThread([&]() {
-            while (true) {
+            while (running) {
                 ExecuteTask();
             }
         });
 
-        // 主线程等待
-        runtimeThread.join();
+        // 主线程等待退出信号，先停止引擎并关闭轨迹文件，再等任务线程结束
+        while (running) {
+            this_thread::sleep_for(chrono::milliseconds(100));
+        }
+        loop.stop();
+        recorder.close();
+        cout << "Snipper stopped." << endl;
         updateTaskThread.join();
         executeTaskThread.join();
         
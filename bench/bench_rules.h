@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <random>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+// 基准测试共用的规则集，并行评估测试和微基准的Engine::tick用例使用相同的规则
+
+// 传感器键名为s0 ~ s{SENSOR_COUNT-1}
+static const int SENSOR_COUNT = 64;
+
+// 生成规则：简单条件、复合条件和表达式交替出现，阈值和优先级由固定种子生成
+inline json makeRules(size_t count) {
+    json rules = json::array();
+    mt19937 rng(42);
+    for (size_t i = 0; i < count; ++i) {
+        string a = "s" + to_string(rng() % SENSOR_COUNT);
+        string b = "s" + to_string(rng() % SENSOR_COUNT);
+        int threshold = static_cast<int>(rng() % 100);
+
+        json when;
+        switch (i % 3) {
+            case 0:
+                when = {{"left", a}, {"op", ">"}, {"right", threshold}};
+                break;
+            case 1:
+                when = {{"all", json::array({
+                    {{"left", a}, {"op", ">="}, {"right", threshold}},
+                    {{"left", b}, {"op", "<"}, {"right", 100 - threshold}}
+                })}};
+                break;
+            default:
+                when = {{"expression", {
+                    {"op", ">"},
+                    {"left", {{"op", "+"}, {"left", a}, {"right", b}}},
+                    {"right", threshold * 2}
+                }}};
+                break;
+        }
+
+        rules.push_back({
+            {"id", "r" + to_string(i)},
+            {"when", when},
+            {"do", json::array({{{"action", "count"}, {"params", json::object()}}})},
+            {"priority", static_cast<int>(rng() % 1000)}
+        });
+    }
+    return {{"rules", rules}};
+}
@@ -0,0 +1,61 @@
+#include "../runtime/runtime.h"
+#include "bench_rules.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <cstdlib>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+// 并行条件评估的扩展性测试
+// 用法: snipper_parallel_bench [最大规则数] [最大线程数]
+// 规则数从1k按10倍递增到最大规则数（默认1M），线程数从1按2倍递增到最大线程数（默认CPU核数）
+
+int main(int argc, char* argv[]) {
+    size_t max_rules = (argc > 1) ? strtoull(argv[1], nullptr, 10) : 1000000;
+    size_t max_threads = (argc > 2) ? strtoull(argv[2], nullptr, 10) : thread::hardware_concurrency();
+    if (max_threads == 0) max_threads = 1;
+
+    cout << "=== 并行规则评估扩展性测试 ===" << endl;
+    cout << "CPU核数: " << thread::hardware_concurrency() << endl;
+    cout << left << setw(10) << "规则数" << setw(8) << "线程" << setw(14) << "tick(ms)"
+         << setw(10) << "加速比" << "触发数" << endl;
+
+    for (size_t count = 1000; count <= max_rules; count *= 10) {
+        Engine engine;
+        size_t fired = 0;
+        engine.register_action("count", [&](const json&, Context&) { fired++; });
+        engine.load(makeRules(count));
+        // 关闭增量评估，每次tick都评估全部条件
+        engine.set_incremental(false);
+
+        Context ctx;
+        mt19937 rng(7);
+        for (int s = 0; s < SENSOR_COUNT; ++s) {
+            ctx.set("s" + to_string(s), static_cast<int>(rng() % 100));
+        }
+
+        int iterations = static_cast<int>(max<size_t>(3, 2000000 / count));
+        double baseline = 0;
+        for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+            engine.set_thread_count(threads);
+            engine.tick(ctx);   // 预热
+
+            fired = 0;
+            auto start = chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i) {
+                engine.tick(ctx);
+            }
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() / iterations;
+            if (threads == 1) baseline = ms;
+
+            cout << left << setw(10) << count << setw(8) << threads << setw(14) << fixed << setprecision(3) << ms
+                 << setw(10) << setprecision(2) << baseline / ms << fired / iterations << endl;
+        }
+    }
+    return 0;
+}
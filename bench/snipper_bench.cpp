@@ -0,0 +1,570 @@
+// 热路径微基准测试：条件/表达式评估、Engine::tick、行为树执行、频率限制、内存存储查询、Cron计算、
+// 窗口聚合内核（各指令集级别对比）
+//
+// 用法：
+//   snipper_bench [--filter 子串] [--output 结果.json] [--baseline 基线.json] [--threshold 比例]
+//                 [--min-time-ms 毫秒] [--repetitions 次数] [--max-rules 数量] [--max-nodes 数量]
+//                 [--max-records 数量] [--max-threads 数量] [--list]
+//
+// 每个用例先倍增迭代次数直到单次运行不少于--min-time-ms，再重复--repetitions次取中位数
+// --output把结果写成JSON；--baseline读取以前写出的结果按用例名比较，
+// 耗时超过基线(1 + --threshold)倍的用例记为回归，有回归时返回1
+// 规模上限默认取较小值以便快速运行，完整规模：--max-rules 1000000 --max-nodes 100000 --max-records 10000000
+
+#include "../runtime/runtime.h"
+#include "../runtime/scheduler/frequency_limiter.h"
+#include "../runtime/scheduler/cron_parser.h"
+#include "../runtime/persistence/memory_storage.h"
+#include "bench_rules.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <map>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+// 执行n次被测操作
+using BenchFn = function<void(size_t n)>;
+
+// 基准用例：setup只在用例被选中时调用，返回的函数持有被测对象
+struct BenchCase {
+    string name;
+    json params;
+    function<BenchFn()> setup;
+};
+
+struct BenchResult {
+    string name;
+    json params;
+    size_t iterations = 0;
+    double ns_per_op = 0;       // 各次重复的中位数
+    double min_ns_per_op = 0;
+    double max_ns_per_op = 0;
+};
+
+struct BenchOptions {
+    string filter;
+    string output;
+    string baseline;
+    double threshold = 0.10;
+    double min_time_ms = 50;
+    int repetitions = 3;
+    size_t max_rules = 100000;
+    size_t max_nodes = 100000;
+    size_t max_records = 100000;
+    size_t max_threads = 4;
+    bool list = false;
+};
+
+static string caseName(const string& group, const json& params) {
+    string name = group;
+    for (auto it = params.begin(); it != params.end(); ++it) {
+        name += "/" + it.key() + "=" + (it->is_string() ? it->get<string>() : it->dump());
+    }
+    return name;
+}
+
+static void addCase(vector<BenchCase>& cases, const string& group, const json& params, function<BenchFn()> setup) {
+    cases.push_back({caseName(group, params), params, move(setup)});
+}
+
+static void setSensors(Context& ctx) {
+    for (int s = 0; s < SENSOR_COUNT; ++s) {
+        ctx.set("s" + to_string(s), s + 1);
+    }
+}
+
+// ---------------- 条件与表达式 ----------------
+
+// depth层all节点，每层width个子节点，叶子全为真，评估时访问全部叶子
+static json makeConditionTree(int depth, int width, int& leaf) {
+    if (depth == 0) {
+        string sensor = "s" + to_string(leaf++ % SENSOR_COUNT);
+        return {{"left", sensor}, {"op", ">"}, {"right", 0}};
+    }
+    json children = json::array();
+    for (int i = 0; i < width; ++i) {
+        children.push_back(makeConditionTree(depth - 1, width, leaf));
+    }
+    return {{"all", children}};
+}
+
+static shared_ptr<Condition> buildCondition(const json& when) {
+    auto condition = make_shared<Condition>();
+    if (when.contains("all")) {
+        for (const auto& child : when["all"]) {
+            condition->all.push_back(buildCondition(child));
+        }
+    } else {
+        condition->left = when["left"];
+        condition->left_slot = SymbolTable::global().intern(condition->left);
+        condition->op = when["op"];
+        condition->right = when["right"];
+        condition->right_value = Scalar::fromJson(condition->right);
+    }
+    return condition;
+}
+
+// depth层求和，每层把width个子表达式用"+"连接成左深链
+static json makeExpressionTree(int depth, int width, int& leaf) {
+    if (depth == 0) {
+        return "s" + to_string(leaf++ % SENSOR_COUNT);
+    }
+    json expr = makeExpressionTree(depth - 1, width, leaf);
+    for (int i = 1; i < width; ++i) {
+        expr = {{"op", "+"}, {"left", expr}, {"right", makeExpressionTree(depth - 1, width, leaf)}};
+    }
+    return expr;
+}
+
+static void addExpressionCases(vector<BenchCase>& cases) {
+    for (int depth : {1, 2, 3, 4}) {
+        for (int width : {2, 4, 8}) {
+            double leaves = pow(width, depth);
+            if (leaves > 4096) continue;
+            json params = {{"depth", depth}, {"width", width}};
+
+            addCase(cases, "condition_eval", params, [depth, width]() -> BenchFn {
+                int leaf = 0;
+                auto condition = buildCondition(makeConditionTree(depth, width, leaf));
+                auto ctx = make_shared<Context>();
+                setSensors(*ctx);
+                return [condition, ctx](size_t n) {
+                    size_t hits = 0;
+                    for (size_t i = 0; i < n; ++i) {
+                        hits += condition->eval(*ctx);
+                    }
+                    if (hits != n) cerr << "condition_eval: unexpected result" << endl;
+                };
+            });
+
+            addCase(cases, "expr_evaluate", params, [depth, width]() -> BenchFn {
+                int leaf = 0;
+                auto expr = ExpressionParser::parse(makeExpressionTree(depth, width, leaf));
+                auto ctx = make_shared<Context>();
+                setSensors(*ctx);
+                return [expr, ctx](size_t n) {
+                    int64_t sum = 0;
+                    for (size_t i = 0; i < n; ++i) {
+                        sum += expr->evaluateScalar(*ctx).asInt();
+                    }
+                    if (sum == 0) cerr << "expr_evaluate: unexpected result" << endl;
+                };
+            });
+        }
+    }
+}
+
+// ---------------- Engine::tick ----------------
+
+// 每次tick修改一个传感器；incremental为false时每次tick评估全部规则
+static void addEngineCases(vector<BenchCase>& cases, const BenchOptions& options) {
+    for (size_t count = 10; count <= options.max_rules; count *= 10) {
+        for (bool incremental : {true, false}) {
+            json params = {{"rules", count}};
+            addCase(cases, incremental ? "engine_tick" : "engine_tick_full", params, [count, incremental]() -> BenchFn {
+                auto engine = make_shared<Engine>();
+                auto fired = make_shared<size_t>(0);
+                engine->register_action("count", [fired](const json&, Context&) { (*fired)++; });
+                engine->load(makeRules(count));
+                engine->set_incremental(incremental);
+
+                auto ctx = make_shared<Context>();
+                setSensors(*ctx);
+                vector<SlotId> slots;
+                for (int s = 0; s < SENSOR_COUNT; ++s) {
+                    slots.push_back(SymbolTable::global().intern("s" + to_string(s)));
+                }
+                engine->tick(*ctx);     // 预热
+                auto step = make_shared<uint64_t>(0);
+                return [engine, ctx, slots, step](size_t n) {
+                    for (size_t i = 0; i < n; ++i) {
+                        uint64_t k = (*step)++;
+                        ctx->setSlot(slots[k % SENSOR_COUNT], Scalar::fromInt(static_cast<int64_t>(k % 100)));
+                        engine->tick(*ctx);
+                    }
+                };
+            });
+        }
+    }
+}
+
+// ---------------- BTExecutor::execute ----------------
+
+// 扇出为10的顺序节点树，叶子交替为条件和动作，全部成功，每次执行访问全部节点
+static shared_ptr<BTNode> makeTree(size_t nodes, size_t& created, int& leaf) {
+    created++;
+    if (nodes <= 1) {
+        string sensor = "s" + to_string(leaf++ % SENSOR_COUNT);
+        if (leaf % 2) {
+            SlotId slot = SymbolTable::global().intern(sensor);
+            return make_shared<BTCondition>(sensor, [slot](Context& ctx) {
+                return ctx.getSlot(slot).asInt() > 0;
+            });
+        }
+        return make_shared<BTAction>(sensor, [](Context&) { return BTStatus::SUCCESS; });
+    }
+    auto sequence = make_shared<BTSequence>("seq");
+    size_t remaining = nodes - 1;
+    size_t fanout = min<size_t>(10, remaining);
+    for (size_t i = 0; i < fanout; ++i) {
+        size_t share = remaining / (fanout - i);
+        sequence->addChild(makeTree(share, created, leaf));
+        remaining -= share;
+    }
+    return sequence;
+}
+
+static void addTreeCases(vector<BenchCase>& cases, const BenchOptions& options) {
+    for (size_t nodes = 10; nodes <= options.max_nodes; nodes *= 10) {
+        addCase(cases, "bt_execute", {{"nodes", nodes}}, [nodes]() -> BenchFn {
+            size_t created = 0;
+            int leaf = 0;
+            auto executor = make_shared<BTExecutor>();
+            executor->setRoot(makeTree(nodes, created, leaf));
+            auto ctx = make_shared<Context>();
+            setSensors(*ctx);
+            return [executor, ctx](size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    if (executor->execute(*ctx) != BTStatus::SUCCESS) {
+                        cerr << "bt_execute: unexpected status" << endl;
+                        return;
+                    }
+                }
+            };
+        });
+    }
+}
+
+// ---------------- FrequencyLimiter::tryAcquire ----------------
+
+// threads个线程同时获取许可；shared为真时竞争同一个标识符，否则每个线程使用自己的标识符
+// 结果为总耗时除以总调用数
+static void addLimiterCases(vector<BenchCase>& cases, const BenchOptions& options) {
+    using snipper::scheduler::FrequencyLimiter;
+    for (size_t threads = 1; threads <= options.max_threads; threads *= 2) {
+        for (bool shared : {true, false}) {
+            if (threads == 1 && !shared) continue;
+            json params = {{"threads", threads}, {"keys", shared ? "shared" : "per_thread"}};
+            addCase(cases, "limiter_try_acquire", params, [threads, shared]() -> BenchFn {
+                auto limiter = make_shared<FrequencyLimiter>();
+                FrequencyLimiter::LimitConfig config;
+                config.maxRequests = 1000;
+                config.windowMs = chrono::milliseconds(100);
+                config.strategy = FrequencyLimiter::Strategy::SLIDING_WINDOW;
+                vector<string> keys;
+                for (size_t t = 0; t < threads; ++t) {
+                    keys.push_back(shared ? "rule" : "rule" + to_string(t));
+                    limiter->setLimit(keys.back(), config);
+                }
+                return [limiter, keys, threads](size_t n) {
+                    vector<thread> workers;
+                    size_t per_thread = (n + threads - 1) / threads;
+                    for (size_t t = 0; t < threads; ++t) {
+                        workers.emplace_back([&, t]() {
+                            for (size_t i = 0; i < per_thread; ++i) {
+                                limiter->tryAcquire(keys[t]);
+                            }
+                        });
+                    }
+                    for (auto& worker : workers) worker.join();
+                };
+            });
+        }
+    }
+}
+
+// ---------------- MemoryStorage::query ----------------
+
+// 10种记录类型，data.value在0-999之间均匀分布；两种查询都命中约10%的记录
+static void addStorageCases(vector<BenchCase>& cases, const BenchOptions& options) {
+    using namespace snipper::persistence;
+    for (size_t records = 10000; records <= options.max_records; records *= 10) {
+        for (string query : {"type", "value"}) {
+            addCase(cases, "storage_query", {{"records", records}, {"by", query}}, [records, query]() -> BenchFn {
+                auto storage = make_shared<MemoryStorage>();
+                storage->connect();
+                mt19937 rng(3);
+                for (size_t i = 0; i < records; ++i) {
+                    storage->insert(DataRecord("rec" + to_string(i), "type" + to_string(i % 10),
+                                               {{"value", static_cast<int>(rng() % 1000)}}));
+                }
+                vector<QueryCondition> conditions;
+                if (query == "type") {
+                    conditions.emplace_back("type", "==", "type3");
+                } else {
+                    conditions.emplace_back("value", ">=", 900);
+                }
+                return [storage, conditions](size_t n) {
+                    for (size_t i = 0; i < n; ++i) {
+                        storage->query(conditions, 0, 100);
+                    }
+                };
+            });
+        }
+    }
+}
+
+// ---------------- CronParser::nextMatch ----------------
+
+static void addCronCases(vector<BenchCase>& cases) {
+    using snipper::scheduler::CronParser;
+    vector<pair<string, string>> expressions = {
+        {"every_minute", "* * * * *"},
+        {"workday_quarter", "*/15 9-17 * * 1-5"},
+        {"monthly", "0 0 1 * *"},
+        {"yearly", "30 4 1 1 *"}
+    };
+    for (const auto& item : expressions) {
+        string expression = item.second;
+        addCase(cases, "cron_next_match", {{"expr", item.first}}, [expression]() -> BenchFn {
+            auto cron = make_shared<CronParser::CronExpression>(CronParser::parse(expression));
+            // 固定起点，结果与运行时刻无关
+            auto from = chrono::system_clock::from_time_t(1700000000);
+            return [cron, from](size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    CronParser::nextMatch(*cron, from + chrono::minutes(i % 1440));
+                }
+            };
+        });
+    }
+}
+
+// ---------------- WindowKernels：各指令集级别对比 ----------------
+
+static void addKernelCases(vector<BenchCase>& cases) {
+    KernelLevel best = WindowKernels::detect();
+    for (const char* op : {"sum", "max", "stddev", "percentile"}) {
+        for (size_t size : {256, 4096, 65536}) {
+            for (int level = KERNEL_SCALAR; level <= best; ++level) {
+                json params = {{"op", op}, {"level", WindowKernels::levelName(static_cast<KernelLevel>(level))}, {"n", size}};
+                string name = op;
+                addCase(cases, "window_kernel", params, [name, size, level]() -> BenchFn {
+                    auto data = make_shared<vector<double>>(size);
+                    auto scratch = make_shared<vector<double>>(size);
+                    mt19937 rng(11);
+                    for (double& value : *data) value = (rng() % 100000) / 100.0;
+                    return [name, data, scratch, level](size_t n) {
+                        WindowKernels::setLevel(static_cast<KernelLevel>(level));
+                        double sink = 0;
+                        for (size_t i = 0; i < n; ++i) {
+                            if (name == "sum") {
+                                sink += WindowKernels::sum(data->data(), data->size());
+                            } else if (name == "max") {
+                                sink += WindowKernels::max(data->data(), data->size());
+                            } else if (name == "stddev") {
+                                sink += WindowKernels::stddev(data->data(), data->size());
+                            } else {
+                                *scratch = *data;
+                                sink += WindowKernels::percentile(scratch->data(), scratch->size(), 95);
+                            }
+                        }
+                        WindowKernels::setLevel(WindowKernels::detect());
+                        if (sink == -1) cout << sink;
+                    };
+                });
+            }
+        }
+    }
+}
+
+// ---------------- 计时与结果比较 ----------------
+
+static double timeRun(const BenchFn& fn, size_t n) {
+    auto start = chrono::steady_clock::now();
+    fn(n);
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+static BenchResult runCase(const BenchCase& bench, const BenchOptions& options) {
+    BenchFn fn = bench.setup();
+    double min_ns = options.min_time_ms * 1e6;
+
+    // 倍增迭代次数直到单次运行足够长，再按比例估算
+    size_t n = 1;
+    double elapsed = timeRun(fn, n);
+    while (elapsed < min_ns) {
+        size_t next = elapsed > 0 ? static_cast<size_t>(n * min_ns * 1.2 / elapsed) : n * 10;
+        n = min(max(next, n + 1), n * 10);
+        elapsed = timeRun(fn, n);
+    }
+
+    vector<double> samples;
+    samples.push_back(elapsed / n);
+    for (int r = 1; r < options.repetitions; ++r) {
+        samples.push_back(timeRun(fn, n) / n);
+    }
+    sort(samples.begin(), samples.end());
+
+    BenchResult result;
+    result.name = bench.name;
+    result.params = bench.params;
+    result.iterations = n;
+    result.ns_per_op = samples[samples.size() / 2];
+    result.min_ns_per_op = samples.front();
+    result.max_ns_per_op = samples.back();
+    return result;
+}
+
+static string formatNs(double ns) {
+    ostringstream out;
+    out << fixed << setprecision(ns < 10 ? 2 : (ns < 1000 ? 1 : 0)) << ns;
+    return out.str();
+}
+
+static json toJson(const vector<BenchResult>& results, const BenchOptions& options) {
+    json cases = json::array();
+    for (const auto& result : results) {
+        cases.push_back({
+            {"name", result.name},
+            {"params", result.params},
+            {"iterations", result.iterations},
+            {"ns_per_op", result.ns_per_op},
+            {"min_ns_per_op", result.min_ns_per_op},
+            {"max_ns_per_op", result.max_ns_per_op}
+        });
+    }
+    return {
+        {"benchmark", "snipper_bench"},
+        {"timestamp", chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count()},
+        {"hardware_concurrency", thread::hardware_concurrency()},
+        {"min_time_ms", options.min_time_ms},
+        {"repetitions", options.repetitions},
+        {"results", cases}
+    };
+}
+
+// 与基线比较，返回回归的用例数
+static int compareBaseline(const vector<BenchResult>& results, const string& path, double threshold) {
+    ifstream file(path);
+    json baseline = file.is_open() ? json::parse(file, nullptr, false) : json();
+    if (baseline.is_discarded() || !baseline.contains("results")) {
+        cerr << "Error: Cannot read baseline " << path << endl;
+        return -1;
+    }
+    map<string, double> previous;
+    for (const auto& item : baseline["results"]) {
+        previous[item.value("name", "")] = item.value("ns_per_op", 0.0);
+    }
+
+    cout << "\n=== 与基线比较 (" << path << ", 阈值 " << threshold * 100 << "%) ===" << endl;
+    cout << left << setw(48) << "用例" << setw(14) << "基线(ns)" << setw(14) << "当前(ns)" << "比值" << endl;
+    int regressions = 0;
+    for (const auto& result : results) {
+        auto it = previous.find(result.name);
+        if (it == previous.end() || it->second <= 0) {
+            cout << left << setw(48) << result.name << setw(14) << "-" << setw(14) << formatNs(result.ns_per_op)
+                 << "新用例" << endl;
+            continue;
+        }
+        double ratio = result.ns_per_op / it->second;
+        string verdict;
+        if (ratio > 1 + threshold) {
+            verdict = "  回归";
+            regressions++;
+        } else if (ratio < 1 - threshold) {
+            verdict = "  改善";
+        }
+        cout << left << setw(48) << result.name << setw(14) << formatNs(it->second) << setw(14)
+             << formatNs(result.ns_per_op) << fixed << setprecision(2) << ratio << verdict << endl;
+    }
+    cout << (regressions ? to_string(regressions) + " 个用例回归" : string("没有回归")) << endl;
+    return regressions;
+}
+
+static void usage() {
+    cerr << "用法: snipper_bench [--filter 子串] [--output 结果.json] [--baseline 基线.json] [--threshold 比例]" << endl;
+    cerr << "                    [--min-time-ms 毫秒] [--repetitions 次数] [--max-rules 数量] [--max-nodes 数量]" << endl;
+    cerr << "                    [--max-records 数量] [--max-threads 数量] [--list]" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    vector<string> args(argv + 1, argv + argc);
+    BenchOptions options;
+    for (size_t i = 0; i < args.size(); ++i) {
+        const string& arg = args[i];
+        bool has_value = i + 1 < args.size();
+        if (arg == "--filter" && has_value) {
+            options.filter = args[++i];
+        } else if (arg == "--output" && has_value) {
+            options.output = args[++i];
+        } else if (arg == "--baseline" && has_value) {
+            options.baseline = args[++i];
+        } else if (arg == "--threshold" && has_value) {
+            options.threshold = max(stod(args[++i]), 0.0);
+        } else if (arg == "--min-time-ms" && has_value) {
+            options.min_time_ms = max(stod(args[++i]), 0.1);
+        } else if (arg == "--repetitions" && has_value) {
+            options.repetitions = max(stoi(args[++i]), 1);
+        } else if (arg == "--max-rules" && has_value) {
+            options.max_rules = stoull(args[++i]);
+        } else if (arg == "--max-nodes" && has_value) {
+            options.max_nodes = stoull(args[++i]);
+        } else if (arg == "--max-records" && has_value) {
+            options.max_records = stoull(args[++i]);
+        } else if (arg == "--max-threads" && has_value) {
+            options.max_threads = max<size_t>(stoull(args[++i]), 1);
+        } else if (arg == "--list") {
+            options.list = true;
+        } else {
+            cerr << "Unknown option: " << arg << endl;
+            usage();
+            return 1;
+        }
+    }
+
+    vector<BenchCase> cases;
+    addExpressionCases(cases);
+    addEngineCases(cases, options);
+    addTreeCases(cases, options);
+    addLimiterCases(cases, options);
+    addStorageCases(cases, options);
+    addCronCases(cases);
+    addKernelCases(cases);
+
+    vector<BenchCase> selected;
+    for (auto& bench : cases) {
+        if (options.filter.empty() || bench.name.find(options.filter) != string::npos) {
+            selected.push_back(move(bench));
+        }
+    }
+    if (options.list) {
+        for (const auto& bench : selected) cout << bench.name << endl;
+        return 0;
+    }
+
+    cout << "=== snipper 微基准测试 (" << selected.size() << " 个用例) ===" << endl;
+    cout << left << setw(48) << "用例" << setw(14) << "ns/op" << setw(14) << "最小" << "迭代次数" << endl;
+    vector<BenchResult> results;
+    for (const auto& bench : selected) {
+        results.push_back(runCase(bench, options));
+        const BenchResult& result = results.back();
+        cout << left << setw(48) << result.name << setw(14) << formatNs(result.ns_per_op) << setw(14)
+             << formatNs(result.min_ns_per_op) << result.iterations << endl;
+    }
+
+    if (!options.output.empty()) {
+        ofstream file(options.output);
+        if (!file.is_open()) {
+            cerr << "Error: Cannot write " << options.output << endl;
+            return 1;
+        }
+        file << toJson(results, options).dump(2) << endl;
+        cout << "结果已写入 " << options.output << endl;
+    }
+
+    if (!options.baseline.empty()) {
+        int regressions = compareBaseline(results, options.baseline, options.threshold);
+        if (regressions != 0) return 1;
+    }
+    return 0;
+}
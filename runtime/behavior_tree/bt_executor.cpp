@@ -5,7 +5,7 @@
 // BTExecutor 实现
 BTExecutor::BTExecutor() 
     : current_status_(BTStatus::FAILURE), is_running_(false), is_paused_(false),
-      execution_count_(0), success_count_(0), failure_count_(0), running_count_(0) {
+      shared_synced_(0), execution_count_(0), success_count_(0), failure_count_(0), running_count_(0) {
 }
 
 void BTExecutor::setRoot(shared_ptr<BTNode> root) {
@@ -34,6 +34,18 @@ BTStatus BTExecutor::execute(Context& ctx) {
     return current_status_;
 }
 
+BTStatus BTExecutor::execute(SharedContext& shared) {
+    {
+        SharedContext::Snapshot snapshot = shared.snapshot();
+        snapshot.syncTo(shared_work_, shared_synced_);
+    }
+    
+    uint64_t before = shared_work_.version();
+    BTStatus status = execute(shared_work_);
+    shared.merge(shared_work_, before, shared_synced_);
+    return status;
+}
+
 void BTExecutor::reset() {
     if (root_) {
         root_->reset();
@@ -2,6 +2,7 @@
 
 #include "bt_node.h"
 #include "../core/context.h"
+#include "../core/shared_context.h"
 #include <memory>
 #include <unordered_map>
 #include <functional>
@@ -20,6 +21,9 @@ public:
     // 执行行为树
     BTStatus execute(Context& ctx);
     
+    // 在共享Context的快照上执行行为树，节点写入的值执行后发布回共享Context
+    BTStatus execute(SharedContext& shared);
+    
     // 重置行为树
     void reset();
     
@@ -60,6 +64,10 @@ private:
     unordered_map<string, BTAction::ActionFunction> action_functions_;
     unordered_map<string, BTCondition::ConditionFunction> condition_functions_;
     
+    // 共享Context的工作副本
+    Context shared_work_;
+    uint64_t shared_synced_;
+    
     // 执行统计
     int execution_count_;
     int success_count_;
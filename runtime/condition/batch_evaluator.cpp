@@ -0,0 +1,109 @@
+#include "batch_evaluator.h"
+
+// 数值列比较内核：无分支，便于编译器向量化
+template <typename Cmp>
+static void compareNumbers(const double* numbers, const uint8_t* numeric, double rhs,
+                           uint8_t* result, size_t count, Cmp cmp) {
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = numeric[i] & static_cast<uint8_t>(cmp(numbers[i], rhs));
+    }
+}
+
+// BatchEvaluator 实现
+void BatchEvaluator::eval(const Condition& condition, const ContextBatch& batch,
+                          const vector<uint8_t>& active, vector<uint8_t>& result) {
+    evalMask(condition, batch, active, result, 0);
+}
+
+void BatchEvaluator::evalMask(const Condition& condition, const ContextBatch& batch,
+                              const vector<uint8_t>& active, vector<uint8_t>& result, size_t depth) {
+    size_t count = batch.size();
+    result.assign(count, 0);
+
+    if (condition.use_expression && condition.expression) {
+        evalRows(condition, batch, active, result);
+        return;
+    }
+
+    // 复合条件：按子条件掩码合并（评估无副作用，与逐个短路评估结果相同）
+    if (!condition.all.empty() || !condition.any.empty()) {
+        if (scratch_.size() <= depth) {
+            scratch_.resize(depth + 1);
+        }
+        bool is_all = !condition.all.empty();
+        const auto& children = is_all ? condition.all : condition.any;
+        if (is_all) {
+            result.assign(count, 1);
+        }
+        for (const auto& child : children) {
+            if (!child) {
+                if (is_all) {
+                    result.assign(count, 0);
+                    return;
+                }
+                continue;
+            }
+            // scratch_在递归中可能扩容，每次重新取引用
+            evalMask(*child, batch, active, scratch_[depth], depth + 1);
+            const vector<uint8_t>& mask = scratch_[depth];
+            if (is_all) {
+                for (size_t i = 0; i < count; ++i) result[i] &= mask[i];
+            } else {
+                for (size_t i = 0; i < count; ++i) result[i] |= mask[i];
+            }
+        }
+        return;
+    }
+
+    if (isColumnCompare(condition)) {
+        compareColumn(condition, batch, active, result);
+    } else {
+        evalRows(condition, batch, active, result);
+    }
+}
+
+bool BatchEvaluator::isColumnCompare(const Condition& condition) {
+    if (condition.left_slot == INVALID_SLOT || !condition.right_value.isNumber()) return false;
+    const string& op = condition.op;
+    return op == ">" || op == "<" || op == ">=" || op == "<=" || op == "==" || op == "!=";
+}
+
+void BatchEvaluator::compareColumn(const Condition& condition, const ContextBatch& batch,
+                                   const vector<uint8_t>& active, vector<uint8_t>& result) {
+    const ContextBatch::Column* column = batch.column(condition.left_slot);
+    if (!column) {
+        // 所有设备都没有该值
+        evalRows(condition, batch, active, result);
+        return;
+    }
+
+    size_t count = batch.size();
+    const double* numbers = column->numbers.data();
+    const uint8_t* numeric = column->numeric.data();
+    double rhs = condition.right_value.asDouble();
+    uint8_t* out = result.data();
+    const string& op = condition.op;
+
+    if (op == ">") compareNumbers(numbers, numeric, rhs, out, count, [](double a, double b) { return a > b; });
+    else if (op == "<") compareNumbers(numbers, numeric, rhs, out, count, [](double a, double b) { return a < b; });
+    else if (op == ">=") compareNumbers(numbers, numeric, rhs, out, count, [](double a, double b) { return a >= b; });
+    else if (op == "<=") compareNumbers(numbers, numeric, rhs, out, count, [](double a, double b) { return a <= b; });
+    else if (op == "==") compareNumbers(numbers, numeric, rhs, out, count, [](double a, double b) { return a == b; });
+    else compareNumbers(numbers, numeric, rhs, out, count, [](double a, double b) { return a != b; });
+
+    // 非数值（缺失、字符串等）按原有类型规则比较
+    for (size_t i = 0; i < count; ++i) {
+        if (!numeric[i] && active[i]) {
+            result[i] = condition.eval(batch.row(i)) ? 1 : 0;
+        }
+    }
+}
+
+void BatchEvaluator::evalRows(const Condition& condition, const ContextBatch& batch,
+                              const vector<uint8_t>& active, vector<uint8_t>& result) {
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (active[i]) {
+            result[i] = condition.eval(batch.row(i)) ? 1 : 0;
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "condition_evaluator.h"
+#include "../core/context_batch.h"
+#include <vector>
+
+using namespace std;
+
+// 批量条件评估：对ContextBatch中的所有设备评估同一个条件
+// 右侧为数值的简单比较条件直接在double列上逐元素比较（编译器可向量化），
+// all/any按掩码合并，其余条件和非数值的设备逐个在行视图上评估
+class BatchEvaluator {
+public:
+    // 评估条件，result[i]为1表示设备i满足条件
+    // 只保证active[i]为1的设备结果正确，其余设备的结果为0
+    void eval(const Condition& condition, const ContextBatch& batch,
+              const vector<uint8_t>& active, vector<uint8_t>& result);
+
+private:
+    vector<vector<uint8_t>> scratch_;   // 按递归深度复用的子条件结果缓冲区
+
+    void evalMask(const Condition& condition, const ContextBatch& batch,
+                  const vector<uint8_t>& active, vector<uint8_t>& result, size_t depth);
+
+    // 简单比较条件是否可按列评估
+    static bool isColumnCompare(const Condition& condition);
+
+    // 在数值列上评估简单比较条件，非数值的设备回退到行视图
+    static void compareColumn(const Condition& condition, const ContextBatch& batch,
+                              const vector<uint8_t>& active, vector<uint8_t>& result);
+
+    // 逐设备在行视图上评估
+    static void evalRows(const Condition& condition, const ContextBatch& batch,
+                         const vector<uint8_t>& active, vector<uint8_t>& result);
+};
@@ -1,36 +1,172 @@
 #include "condition_evaluator.h"
 #include "operators.h"
 #include "../expression/expression.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
 
 // Condition 实现
-Condition::Condition() : use_expression(false) {
+Condition::Condition()
+    : left_slot(INVALID_SLOT), use_expression(false), shared(false),
+      order_(0), adaptive_(false), sample_counter_(0), memo_(0) {
+}
+
+// 计数加一：统计允许少量丢失，不使用原子读改写
+static inline void bump(atomic<uint64_t>& counter, uint64_t delta = 1) {
+    counter.store(counter.load(memory_order_relaxed) + delta, memory_order_relaxed);
+}
+
+static inline uint64_t nowNs() {
+    return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count());
 }
 
 bool Condition::eval(const Context& ctx) const {
+    if (!shared.load(memory_order_relaxed)) return evalNode(ctx);
+    
+    // 共享节点：同一Context版本只评估一次
+    uint64_t memo = memo_.load(memory_order_acquire);
+    if ((memo >> 1) == ctx.version()) {
+        return memo & 1;
+    }
+    bool result = evalNode(ctx);
+    memo_.store((ctx.version() << 1) | (result ? 1 : 0), memory_order_release);
+    return result;
+}
+
+bool Condition::evalNode(const Context& ctx) const {
     // 使用表达式评估
     if (use_expression && expression) {
-        Value result = expression->evaluate(ctx);
-        return result.is_boolean() ? result.get<bool>() : false;
+        Scalar result = expression->evaluateScalar(ctx);
+        return result.isBool() ? result.asBool() : false;
     }
     
     // 处理复合条件
     if (!all.empty()) {
-        for (const auto& cond : all) {
-            if (!cond || !cond->eval(ctx)) return false;
-        }
-        return true;
+        return evalChildren(all, true, ctx);
     }
     
     if (!any.empty()) {
-        for (const auto& cond : any) {
-            if (cond && cond->eval(ctx)) return true;
+        return evalChildren(any, false, ctx);
+    }
+    
+    // 处理简单条件（未解析槽位时走字符串键慢路径）
+    if (left_slot == INVALID_SLOT) {
+        return Eval::cmp(ctx.get(left), op, right);
+    }
+    const Scalar& leftValue = ctx.getSlot(left_slot);
+    if (leftValue.isJson() || right_value.isJson()) {
+        // 对象/数组比较走json路径
+        return Eval::cmp(ctx.getSlotJson(left_slot), op, right);
+    }
+    return Eval::cmp(leftValue, op, right_value);
+}
+
+bool Condition::evalChildren(const vector<shared_ptr<Condition>>& children, bool is_all,
+                             const Context& ctx) const {
+    uint64_t order = order_.load(memory_order_relaxed);
+    if (!adaptive_.load(memory_order_relaxed)) {
+        for (size_t k = 0; k < children.size(); ++k) {
+            const auto& cond = children[order ? (order >> (4 * k)) & 0xF : k];
+            if ((cond && cond->eval(ctx)) != is_all) return !is_all;
+        }
+        return is_all;
+    }
+    
+    // 每16次评估抽样一次耗时
+    bool sample = (sample_counter_.fetch_add(1, memory_order_relaxed) & 0xF) == 0;
+    for (size_t k = 0; k < children.size(); ++k) {
+        size_t index = order ? (order >> (4 * k)) & 0xF : k;
+        const auto& cond = children[index];
+        ChildProfile& profile = profile_[index];
+        uint64_t start = sample ? nowNs() : 0;
+        bool value = cond && cond->eval(ctx);
+        bump(profile.evaluations);
+        if (sample) {
+            bump(profile.cost_ns, nowNs() - start);
+            bump(profile.samples);
+        }
+        if (value != is_all) {
+            bump(profile.decisive);
+            return !is_all;
         }
-        return false;
     }
+    return is_all;
+}
+
+bool Condition::setAdaptive(bool enabled) {
+    size_t count = children().size();
+    if (enabled && (count < 2 || count > MAX_ADAPTIVE_CHILDREN)) return false;
     
-    // 处理简单条件
-    Value leftValue = ctx.get(left);
-    return Eval::cmp(leftValue, op, right);
+    if (enabled && !profile_) {
+        profile_.reset(new ChildProfile[MAX_ADAPTIVE_CHILDREN]);
+    }
+    if (!enabled) {
+        order_.store(0, memory_order_relaxed);
+    }
+    adaptive_.store(enabled, memory_order_relaxed);
+    return true;
+}
+
+void Condition::reorder() {
+    if (!adaptive_.load(memory_order_relaxed) || !profile_) return;
+    
+    vector<size_t> current = evaluationOrder();
+    size_t count = current.size();
+    
+    // 平均耗时：未抽样到的子条件按已知的最大耗时估计
+    vector<double> cost(count, 0.0);
+    double max_cost = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t samples = profile_[i].samples.load(memory_order_relaxed);
+        if (samples) {
+            cost[i] = static_cast<double>(profile_[i].cost_ns.load(memory_order_relaxed)) / samples;
+            max_cost = max(max_cost, cost[i]);
+        } else {
+            cost[i] = -1.0;
+        }
+    }
+    
+    // 排序键：平均耗时/决定率；从未决定结果或从未评估的子条件排在最后
+    vector<double> rank(count, numeric_limits<double>::infinity());
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t evaluations = profile_[i].evaluations.load(memory_order_relaxed);
+        uint64_t decisive = profile_[i].decisive.load(memory_order_relaxed);
+        if (evaluations && decisive) {
+            double c = cost[i] < 0 ? max_cost : cost[i];
+            rank[i] = (c + 1.0) * evaluations / decisive;
+        }
+    }
+    
+    // 稳定排序：排序键相同的子条件保持当前顺序，避免来回抖动
+    stable_sort(current.begin(), current.end(), [&](size_t a, size_t b) {
+        return rank[a] < rank[b];
+    });
+    
+    uint64_t packed = 0;
+    for (size_t k = 0; k < count; ++k) {
+        packed |= static_cast<uint64_t>(current[k]) << (4 * k);
+    }
+    order_.store(packed, memory_order_relaxed);
+    
+    // 统计值减半：近期的数据权重更高
+    for (size_t i = 0; i < count; ++i) {
+        ChildProfile& profile = profile_[i];
+        profile.evaluations.store(profile.evaluations.load(memory_order_relaxed) / 2, memory_order_relaxed);
+        profile.decisive.store(profile.decisive.load(memory_order_relaxed) / 2, memory_order_relaxed);
+        profile.samples.store(profile.samples.load(memory_order_relaxed) / 2, memory_order_relaxed);
+        profile.cost_ns.store(profile.cost_ns.load(memory_order_relaxed) / 2, memory_order_relaxed);
+    }
+}
+
+vector<size_t> Condition::evaluationOrder() const {
+    size_t count = children().size();
+    uint64_t order = order_.load(memory_order_relaxed);
+    vector<size_t> result(count);
+    for (size_t k = 0; k < count; ++k) {
+        result[k] = order ? (order >> (4 * k)) & 0xF : k;
+    }
+    return result;
 }
 
 bool Condition::isEmpty() const {
@@ -39,3 +175,25 @@ bool Condition::isEmpty() const {
            all.empty() && 
            any.empty();
 }
+
+void Condition::collectInputs(vector<SlotId>& slots, bool& time_dependent) const {
+    if (use_expression) {
+        if (expression) expression->collectInputs(slots, time_dependent);
+        return;
+    }
+    
+    for (const auto& cond : all) {
+        if (cond) cond->collectInputs(slots, time_dependent);
+    }
+    for (const auto& cond : any) {
+        if (cond) cond->collectInputs(slots, time_dependent);
+    }
+    
+    if (all.empty() && any.empty()) {
+        if (left_slot != INVALID_SLOT) {
+            slots.push_back(left_slot);
+        } else {
+            time_dependent = true;
+        }
+    }
+}
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <atomic>
 
 using namespace std;
 
@@ -12,8 +13,10 @@ class Condition {
 public:
     // 简单条件（向后兼容）
     string left;    // 左操作数（通常是传感器名称）
+    SlotId left_slot;   // 左操作数槽位（加载时解析）
     string op;      // 操作符 (">", "==", "<", ">=", "<=", "!=")
     Value right;    // 右操作数（比较值）
+    Scalar right_value;     // 右操作数的Scalar形式（加载时转换）
     
     // 复合条件
     vector<shared_ptr<Condition>> all;  // 所有条件都必须满足
@@ -23,6 +26,10 @@ public:
     shared_ptr<class ExprNode> expression;    // 表达式树
     bool use_expression;    // 是否使用表达式
     
+    // 谓词网络：被多条规则共享的节点按Context版本缓存评估结果
+    // 后台重新加载规则时可能被修改，使用原子量
+    atomic<bool> shared;
+    
     Condition();
     
     // 评估条件
@@ -30,5 +37,52 @@ public:
     
     // 检查是否为空条件
     bool isEmpty() const;
+    
+    // 收集条件读取的槽位；条件依赖时间或动态键名时置位time_dependent
+    void collectInputs(vector<SlotId>& slots, bool& time_dependent) const;
+    
+    // 自适应排序：仅用于all/any复合条件（子条件2~MAX_ADAPTIVE_CHILDREN个）
+    // 条件没有副作用，子条件按任意顺序评估结果都相同。开启后统计每个子条件的评估次数、
+    // 决定结果的次数（all中为假、any中为真）和抽样耗时；reorder按"平均耗时/决定率"
+    // 从小到大重排评估顺序，廉价且经常决定结果的子条件先评估
+    static const size_t MAX_ADAPTIVE_CHILDREN = 16;
+    
+    // 开启/关闭统计（关闭时恢复配置顺序）；只能在没有并发评估时调用
+    bool setAdaptive(bool enabled);
+    bool isAdaptive() const { return adaptive_.load(memory_order_relaxed); }
+    
+    // 按统计重排评估顺序，之后统计值减半以跟随数据变化；可与评估并发
+    void reorder();
+    
+    // 当前评估顺序（子条件下标）
+    vector<size_t> evaluationOrder() const;
+    
+private:
+    // 子条件统计；并发评估时允许少量计数丢失
+    struct ChildProfile {
+        atomic<uint64_t> evaluations{0};
+        atomic<uint64_t> decisive{0};
+        atomic<uint64_t> samples{0};
+        atomic<uint64_t> cost_ns{0};
+    };
+    
+    // 评估顺序：每4位一个子条件下标，打包为一个原子量，重排时评估线程总能读到完整的排列；
+    // 0表示配置顺序
+    mutable atomic<uint64_t> order_;
+    atomic<bool> adaptive_;
+    mutable atomic<uint32_t> sample_counter_;
+    unique_ptr<ChildProfile[]> profile_;
+    
+    // 按评估顺序短路评估子条件（is_all: all为true，any为false）
+    bool evalChildren(const vector<shared_ptr<Condition>>& children, bool is_all, const Context& ctx) const;
+    
+    const vector<shared_ptr<Condition>>& children() const { return all.empty() ? any : all; }
+    
+
+    // 缓存：(Context版本 << 1) | 结果，打包为一个原子量，并行评估时无需加锁
+    mutable atomic<uint64_t> memo_;
+    
+    // 不经缓存直接评估
+    bool evalNode(const Context& ctx) const;
 };
 
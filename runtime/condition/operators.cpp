@@ -1,8 +1,19 @@
 #include "operators.h"
 #include <cmath>
 #include <ctime>
+#include <string_view>
 
 // Eval 实现
+bool Eval::cmp(const Scalar& a, const string& op, const Scalar& b) {
+    if (op == "==") return a == b;
+    if (op == "!=") return a != b;
+    if (op == ">") return a > b;
+    if (op == "<") return a < b;
+    if (op == ">=") return a >= b;
+    if (op == "<=") return a <= b;
+    return false;
+}
+
 bool Eval::cmp(const Value& a, const string& op, const Value& b) {
     if (op == "==") return a == b;
     if (op == "!=") return a != b;
@@ -13,131 +24,233 @@ bool Eval::cmp(const Value& a, const string& op, const Value& b) {
     return false;
 }
 
-// 数学运算
-Value Eval::add(const Value& a, const Value& b) {
-    if (a.is_number() && b.is_number()) {
-        return a.get<double>() + b.get<double>();
+// 数学运算（数值结果统一为double）
+Scalar Eval::add(const Scalar& a, const Scalar& b) {
+    if (a.isNumber() && b.isNumber()) {
+        return Scalar::fromDouble(a.asDouble() + b.asDouble());
     }
-    if (a.is_string() && b.is_string()) {
-        return a.get<string>() + b.get<string>();
+    if (a.isString() && b.isString()) {
+        string text;
+        text.reserve(a.str().size() + b.str().size());
+        text.append(a.str()).append(b.str());
+        return Scalar::fromString(text);
     }
-    return Value();
+    return Scalar();
 }
 
-Value Eval::subtract(const Value& a, const Value& b) {
-    if (a.is_number() && b.is_number()) {
-        return a.get<double>() - b.get<double>();
+Scalar Eval::subtract(const Scalar& a, const Scalar& b) {
+    if (a.isNumber() && b.isNumber()) {
+        return Scalar::fromDouble(a.asDouble() - b.asDouble());
     }
-    return Value();
+    return Scalar();
 }
 
-Value Eval::multiply(const Value& a, const Value& b) {
-    if (a.is_number() && b.is_number()) {
-        return a.get<double>() * b.get<double>();
+Scalar Eval::multiply(const Scalar& a, const Scalar& b) {
+    if (a.isNumber() && b.isNumber()) {
+        return Scalar::fromDouble(a.asDouble() * b.asDouble());
     }
-    return Value();
+    return Scalar();
 }
 
-Value Eval::divide(const Value& a, const Value& b) {
-    if (a.is_number() && b.is_number()) {
-        double b_val = b.get<double>();
+Scalar Eval::divide(const Scalar& a, const Scalar& b) {
+    if (a.isNumber() && b.isNumber()) {
+        double b_val = b.asDouble();
         if (b_val != 0) {
-            return a.get<double>() / b_val;
+            return Scalar::fromDouble(a.asDouble() / b_val);
         }
     }
-    return Value();
+    return Scalar();
 }
 
-Value Eval::modulo(const Value& a, const Value& b) {
-    if (a.is_number() && b.is_number()) {
-        double b_val = b.get<double>();
+Scalar Eval::modulo(const Scalar& a, const Scalar& b) {
+    if (a.isNumber() && b.isNumber()) {
+        double b_val = b.asDouble();
         if (b_val != 0) {
-            return fmod(a.get<double>(), b_val);
+            return Scalar::fromDouble(fmod(a.asDouble(), b_val));
         }
     }
-    return Value();
+    return Scalar();
+}
+
+Value Eval::add(const Value& a, const Value& b) {
+    return add(Scalar::fromJson(a), Scalar::fromJson(b)).toJson();
+}
+
+Value Eval::subtract(const Value& a, const Value& b) {
+    return subtract(Scalar::fromJson(a), Scalar::fromJson(b)).toJson();
+}
+
+Value Eval::multiply(const Value& a, const Value& b) {
+    return multiply(Scalar::fromJson(a), Scalar::fromJson(b)).toJson();
+}
+
+Value Eval::divide(const Value& a, const Value& b) {
+    return divide(Scalar::fromJson(a), Scalar::fromJson(b)).toJson();
+}
+
+Value Eval::modulo(const Value& a, const Value& b) {
+    return modulo(Scalar::fromJson(a), Scalar::fromJson(b)).toJson();
 }
 
 // 逻辑运算
+Scalar Eval::logical_and(const Scalar& a, const Scalar& b) {
+    return Scalar::fromBool(a.truthy() && b.truthy());
+}
+
+Scalar Eval::logical_or(const Scalar& a, const Scalar& b) {
+    return Scalar::fromBool(a.truthy() || b.truthy());
+}
+
+Scalar Eval::logical_not(const Scalar& a) {
+    return Scalar::fromBool(!a.truthy());
+}
+
 Value Eval::logical_and(const Value& a, const Value& b) {
-    bool a_val = a.is_boolean() ? a.get<bool>() : (a.is_number() ? a.get<double>() != 0 : !a.is_null());
-    bool b_val = b.is_boolean() ? b.get<bool>() : (b.is_number() ? b.get<double>() != 0 : !b.is_null());
-    return a_val && b_val;
+    return logical_and(Scalar::fromJson(a), Scalar::fromJson(b)).toJson();
 }
 
 Value Eval::logical_or(const Value& a, const Value& b) {
-    bool a_val = a.is_boolean() ? a.get<bool>() : (a.is_number() ? a.get<double>() != 0 : !a.is_null());
-    bool b_val = b.is_boolean() ? b.get<bool>() : (b.is_number() ? b.get<double>() != 0 : !b.is_null());
-    return a_val || b_val;
+    return logical_or(Scalar::fromJson(a), Scalar::fromJson(b)).toJson();
 }
 
 Value Eval::logical_not(const Value& a) {
-    bool a_val = a.is_boolean() ? a.get<bool>() : (a.is_number() ? a.get<double>() != 0 : !a.is_null());
-    return !a_val;
+    return logical_not(Scalar::fromJson(a)).toJson();
 }
 
-// 字符串操作
-Value Eval::string_contains(const Value& str, const Value& substr) {
-    if (str.is_string() && substr.is_string()) {
-        return str.get<string>().find(substr.get<string>()) != string::npos;
+// 字符串操作：用string_view比较，不复制
+Scalar Eval::string_contains(const Scalar& str, const Scalar& substr) {
+    if (str.isString() && substr.isString()) {
+        if (str == substr) return Scalar::fromBool(true);
+        return Scalar::fromBool(str.str().find(substr.str()) != string_view::npos);
     }
-    return false;
+    return Scalar::fromBool(false);
 }
 
-Value Eval::string_starts_with(const Value& str, const Value& prefix) {
-    if (str.is_string() && prefix.is_string()) {
-        const string& s = str.get<string>();
-        const string& p = prefix.get<string>();
-        return s.length() >= p.length() && s.substr(0, p.length()) == p;
+Scalar Eval::string_starts_with(const Scalar& str, const Scalar& prefix) {
+    if (str.isString() && prefix.isString()) {
+        string_view s = str.str();
+        string_view p = prefix.str();
+        return Scalar::fromBool(s.size() >= p.size() && s.compare(0, p.size(), p) == 0);
     }
-    return false;
+    return Scalar::fromBool(false);
 }
 
-Value Eval::string_ends_with(const Value& str, const Value& suffix) {
-    if (str.is_string() && suffix.is_string()) {
-        const string& s = str.get<string>();
-        const string& suf = suffix.get<string>();
-        return s.length() >= suf.length() && s.substr(s.length() - suf.length()) == suf;
+Scalar Eval::string_ends_with(const Scalar& str, const Scalar& suffix) {
+    if (str.isString() && suffix.isString()) {
+        string_view s = str.str();
+        string_view suf = suffix.str();
+        return Scalar::fromBool(s.size() >= suf.size() && s.compare(s.size() - suf.size(), suf.size(), suf) == 0);
     }
-    return false;
+    return Scalar::fromBool(false);
+}
+
+Value Eval::string_contains(const Value& str, const Value& substr) {
+    return string_contains(Scalar::fromJson(str), Scalar::fromJson(substr)).toJson();
+}
+
+Value Eval::string_starts_with(const Value& str, const Value& prefix) {
+    return string_starts_with(Scalar::fromJson(str), Scalar::fromJson(prefix)).toJson();
+}
+
+Value Eval::string_ends_with(const Value& str, const Value& suffix) {
+    return string_ends_with(Scalar::fromJson(str), Scalar::fromJson(suffix)).toJson();
 }
 
 // 时间操作
-Value Eval::time_between(const Value& time, const Value& start, const Value& end) {
-    // 简化实现，实际项目中需要更复杂的时间解析
-    if (time.is_string() && start.is_string() && end.is_string()) {
-        // 这里应该解析时间字符串并比较
-        // 暂时返回false作为占位符
-        return false;
+static const ClockSnapshot& clockOf(const Context& ctx, ClockSnapshot& local) {
+    if (ctx.clock().valid()) return ctx.clock();
+    local = ClockSnapshot::now();
+    return local;
+}
+
+// 时间参数换算为当天的分钟数，无法换算时返回-1
+static int minuteOf(const Scalar& value, const ClockSnapshot* clock) {
+    if (value.isNumber()) {
+        int64_t minute = value.asInt();
+        return (minute >= 0 && minute < 24 * 60) ? static_cast<int>(minute) : -1;
     }
-    return false;
+    if (!value.isString()) return -1;
+
+    if (value.str() == "now") return clock ? clock->minute_of_day : -1;
+    return ClockSnapshot::parseTimeOfDay(value.str());
+}
+
+Scalar Eval::time_between(const Context& ctx, const Scalar& time, const Scalar& start, const Scalar& end) {
+    int from = minuteOf(start, nullptr);
+    int to = minuteOf(end, nullptr);
+    if (from < 0 || to < 0) return Scalar::fromBool(false);
+
+    ClockSnapshot local;
+    int minute = minuteOf(time, &clockOf(ctx, local));
+    if (minute < 0) return Scalar::fromBool(false);
+    if (from <= to) return Scalar::fromBool(minute >= from && minute < to);
+    return Scalar::fromBool(minute >= from || minute < to);
+}
+
+Scalar Eval::day_of_week(const Context& ctx, const Scalar& time) {
+    if (!time.isString()) return Scalar::fromInt(-1);
+    ClockSnapshot local;
+    return Scalar::fromInt(clockOf(ctx, local).day_of_week);
+}
+
+Value Eval::time_between(const Value& time, const Value& start, const Value& end) {
+    static const Context empty;
+    return time_between(empty, Scalar::fromJson(time), Scalar::fromJson(start), Scalar::fromJson(end)).toJson();
 }
 
 Value Eval::day_of_week(const Value& time) {
-    // 简化实现，返回当前星期几
-    if (time.is_string()) {
-        time_t now = std::time(0);
-        struct tm* timeinfo = localtime(&now);
-        return timeinfo->tm_wday; // 0=Sunday, 1=Monday, etc.
-    }
-    return -1;
+    static const Context empty;
+    return day_of_week(empty, Scalar::fromJson(time)).toJson();
+}
+
+// 历史数据操作
+static const HistoryBuffer* historyOf(const Context& ctx, SlotId slot) {
+    const HistoryBuffer* history = ctx.history(slot);
+    return (history && history->size() > 0) ? history : nullptr;
+}
+
+static size_t windowSize(int n) {
+    return n > 0 ? static_cast<size_t>(n) : 1;
+}
+
+Scalar Eval::avg_last_n(const Context& ctx, SlotId slot, int n) {
+    const HistoryBuffer* history = historyOf(ctx, slot);
+    return history ? Scalar::fromDouble(history->average(windowSize(n))) : ctx.getSlot(slot);
+}
+
+Scalar Eval::max_last_n(const Context& ctx, SlotId slot, int n) {
+    const HistoryBuffer* history = historyOf(ctx, slot);
+    return history ? Scalar::fromDouble(history->maximum(windowSize(n))) : ctx.getSlot(slot);
+}
+
+Scalar Eval::trend(const Context& ctx, SlotId slot, int n) {
+    const HistoryBuffer* history = historyOf(ctx, slot);
+    return Scalar::fromDouble(history ? history->trend(windowSize(n)) : 0.0);
+}
+
+Scalar Eval::min_last_n(const Context& ctx, SlotId slot, int n) {
+    const HistoryBuffer* history = historyOf(ctx, slot);
+    return history ? Scalar::fromDouble(history->minimum(windowSize(n))) : ctx.getSlot(slot);
+}
+
+Scalar Eval::stddev_last_n(const Context& ctx, SlotId slot, int n) {
+    const HistoryBuffer* history = historyOf(ctx, slot);
+    return Scalar::fromDouble(history ? history->stddev(windowSize(n)) : 0.0);
+}
+
+Scalar Eval::percentile_last_n(const Context& ctx, SlotId slot, int n, double p) {
+    const HistoryBuffer* history = historyOf(ctx, slot);
+    return history ? Scalar::fromDouble(history->percentile(windowSize(n), p)) : ctx.getSlot(slot);
 }
 
-// 历史数据操作（简化实现）
 Value Eval::avg_last_n(const Context& ctx, const string& var, int n) {
-    // 这里应该从历史数据中计算平均值
-    // 暂时返回当前值作为占位符
-    return ctx.get(var);
+    return avg_last_n(ctx, SymbolTable::global().lookup(var), n).toJson();
 }
 
 Value Eval::max_last_n(const Context& ctx, const string& var, int n) {
-    // 这里应该从历史数据中找最大值
-    // 暂时返回当前值作为占位符
-    return ctx.get(var);
+    return max_last_n(ctx, SymbolTable::global().lookup(var), n).toJson();
 }
 
 Value Eval::trend(const Context& ctx, const string& var, int n) {
-    // 这里应该计算趋势（上升/下降/平稳）
-    // 暂时返回0作为占位符
-    return 0;
+    return trend(ctx, SymbolTable::global().lookup(var), n).toJson();
 }
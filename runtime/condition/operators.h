@@ -6,11 +6,18 @@
 using namespace std;
 
 // 条件评估器
+// 热路径使用Scalar版本；json版本为兼容接口，内部转换为Scalar计算
 struct Eval {
     // 基本比较操作
+    static bool cmp(const Scalar& a, const string& op, const Scalar& b);
     static bool cmp(const Value& a, const string& op, const Value& b);
     
     // 数学运算
+    static Scalar add(const Scalar& a, const Scalar& b);
+    static Scalar subtract(const Scalar& a, const Scalar& b);
+    static Scalar multiply(const Scalar& a, const Scalar& b);
+    static Scalar divide(const Scalar& a, const Scalar& b);
+    static Scalar modulo(const Scalar& a, const Scalar& b);
     static Value add(const Value& a, const Value& b);
     static Value subtract(const Value& a, const Value& b);
     static Value multiply(const Value& a, const Value& b);
@@ -18,20 +25,40 @@ struct Eval {
     static Value modulo(const Value& a, const Value& b);
     
     // 逻辑运算
+    static Scalar logical_and(const Scalar& a, const Scalar& b);
+    static Scalar logical_or(const Scalar& a, const Scalar& b);
+    static Scalar logical_not(const Scalar& a);
     static Value logical_and(const Value& a, const Value& b);
     static Value logical_or(const Value& a, const Value& b);
     static Value logical_not(const Value& a);
     
     // 字符串操作
+    static Scalar string_contains(const Scalar& str, const Scalar& substr);
+    static Scalar string_starts_with(const Scalar& str, const Scalar& prefix);
+    static Scalar string_ends_with(const Scalar& str, const Scalar& suffix);
     static Value string_contains(const Value& str, const Value& substr);
     static Value string_starts_with(const Value& str, const Value& prefix);
     static Value string_ends_with(const Value& str, const Value& suffix);
     
-    // 时间操作
+    // 时间操作：按Context的时钟快照求值
+    // time为"now"时取快照的本地时间，也可以是 "HH:MM" 字符串或当天的分钟数；边界同样是两者之一
+    // （加载时已把常量边界换算为分钟数）。区间为[start, end)，start > end时跨越午夜
+    static Scalar time_between(const Context& ctx, const Scalar& time, const Scalar& start, const Scalar& end);
+    // time为字符串时返回快照的星期（0=周日），否则返回-1
+    static Scalar day_of_week(const Context& ctx, const Scalar& time);
     static Value time_between(const Value& time, const Value& start, const Value& end);
     static Value day_of_week(const Value& time);
     
-    // 历史数据操作（简化实现）
+    // 历史数据操作：按Context中槽位的历史记录计算最近n个样本的平均值、最大/最小值和趋势（最小二乘斜率）
+    // 注册过的窗口长度为O(1)；槽位没有历史样本时平均值、最大/最小值取当前值，趋势为0
+    static Scalar avg_last_n(const Context& ctx, SlotId slot, int n);
+    static Scalar max_last_n(const Context& ctx, SlotId slot, int n);
+    static Scalar min_last_n(const Context& ctx, SlotId slot, int n);
+    static Scalar trend(const Context& ctx, SlotId slot, int n);
+
+    // 最近n个样本的标准差和第p百分位数（0~100）：按样本扫描（向量化内核）；没有历史样本时标准差为0，百分位数取当前值
+    static Scalar stddev_last_n(const Context& ctx, SlotId slot, int n);
+    static Scalar percentile_last_n(const Context& ctx, SlotId slot, int n, double p);
     static Value avg_last_n(const Context& ctx, const string& var, int n);
     static Value max_last_n(const Context& ctx, const string& var, int n);
     static Value trend(const Context& ctx, const string& var, int n);
@@ -0,0 +1,179 @@
+#include "predicate_network.h"
+#include "../expression/expr_program.h"
+
+// PredicateNetwork 实现
+shared_ptr<Condition> PredicateNetwork::intern(const shared_ptr<Condition>& condition) {
+    if (!condition) return condition;
+    references_++;
+
+    // 先合并子节点，父节点的键由子节点编号组成
+    string key;
+    if (condition->use_expression) {
+        condition->expression = internExpr(condition->expression);
+        if (condition->expression && added_.count(condition->expression.get())) {
+            uncompiled_.push_back(condition->expression);
+        }
+        key = "E" + (condition->expression ? to_string(idOf(condition->expression.get())) : string("-"));
+    } else if (!condition->all.empty() || !condition->any.empty()) {
+        key = "C";
+        for (auto& child : condition->all) {
+            child = intern(child);
+            key += "&" + to_string(idOf(child.get()));
+        }
+        for (auto& child : condition->any) {
+            child = intern(child);
+            key += "|" + to_string(idOf(child.get()));
+        }
+    } else {
+        key = "S" + to_string(condition->left_slot) + condition->op + condition->right.dump();
+    }
+
+    auto it = conditions_.find(key);
+    if (it != conditions_.end()) {
+        return it->second;
+    }
+
+    node_ids_[condition.get()] = next_id_++;
+    conditions_.emplace(key, condition);
+    return condition;
+}
+
+shared_ptr<ExprNode> PredicateNetwork::internExpr(const shared_ptr<ExprNode>& node) {
+    if (!node) return node;
+    references_++;
+
+    string key;
+    switch (node->type) {
+        case EXPR_VALUE:
+            key = "v" + node->literal.toJson().dump() + node->value;
+            break;
+        case EXPR_VAR:
+            key = "x" + to_string(node->slot) + ":" + node->value;
+            break;
+        case EXPR_OP:
+            key = "o" + node->op;
+            break;
+        case EXPR_FUNC:
+            key = "f" + node->func_name;
+            break;
+    }
+    key += "(";
+    for (auto& child : node->children) {
+        child = internExpr(child);
+        key += (child ? to_string(idOf(child.get())) : string("-")) + ",";
+    }
+    key += ")";
+
+    auto it = expressions_.find(key);
+    if (it != expressions_.end()) {
+        return it->second;
+    }
+
+    node_ids_[node.get()] = next_id_++;
+    expressions_.emplace(key, node);
+    added_.insert(node.get());
+    return node;
+}
+
+void PredicateNetwork::markShared(const vector<shared_ptr<Condition>>& roots) {
+    unordered_map<const void*, size_t> counts;
+    for (const auto& root : roots) {
+        if (root) countReferences(root.get(), counts);
+    }
+
+    // 依赖时间的节点结果不随Context版本变化，不能缓存
+    shared_nodes_ = 0;
+    for (auto& pair : conditions_) {
+        bool shared = counts[pair.second.get()] > 1 && !isTimeDependent(*pair.second);
+        pair.second->shared.store(shared, memory_order_relaxed);
+        if (shared) shared_nodes_++;
+    }
+    for (auto& pair : expressions_) {
+        bool shared = counts[pair.second.get()] > 1 && !isTimeDependent(*pair.second);
+        pair.second->shared.store(shared, memory_order_relaxed);
+        if (shared) shared_nodes_++;
+    }
+}
+
+void PredicateNetwork::compile() {
+    for (const auto& root : uncompiled_) {
+        if (!root->program) root->program = ExprProgram::compile(*root);
+    }
+    uncompiled_.clear();
+    added_.clear();
+}
+
+void PredicateNetwork::prune(const vector<shared_ptr<Condition>>& roots) {
+    unordered_map<const void*, size_t> reachable;
+    for (const auto& root : roots) {
+        if (root) countReferences(root.get(), reachable);
+    }
+    
+    for (auto it = conditions_.begin(); it != conditions_.end();) {
+        if (reachable.count(it->second.get())) {
+            ++it;
+        } else {
+            node_ids_.erase(it->second.get());
+            it = conditions_.erase(it);
+        }
+    }
+    for (auto it = expressions_.begin(); it != expressions_.end();) {
+        if (reachable.count(it->second.get())) {
+            ++it;
+        } else {
+            node_ids_.erase(it->second.get());
+            it = expressions_.erase(it);
+        }
+    }
+}
+
+void PredicateNetwork::clear() {
+    conditions_.clear();
+    expressions_.clear();
+    node_ids_.clear();
+    added_.clear();
+    uncompiled_.clear();
+    next_id_ = 0;
+    references_ = 0;
+    shared_nodes_ = 0;
+}
+
+json PredicateNetwork::getStats() const {
+    json stats;
+    stats["condition_nodes"] = conditions_.size();
+    stats["expression_nodes"] = expressions_.size();
+    stats["parsed_nodes"] = references_;
+    stats["shared_nodes"] = shared_nodes_;
+    return stats;
+}
+
+size_t PredicateNetwork::idOf(const void* node) const {
+    auto it = node_ids_.find(node);
+    return (it != node_ids_.end()) ? it->second : SIZE_MAX;
+}
+
+template <typename Node>
+bool PredicateNetwork::isTimeDependent(const Node& node) {
+    vector<SlotId> slots;
+    bool time_dependent = false;
+    node.collectInputs(slots, time_dependent);
+    return time_dependent;
+}
+
+void PredicateNetwork::countReferences(Condition* condition, unordered_map<const void*, size_t>& counts) {
+    if (counts[condition]++ > 0) return;
+    if (condition->expression) countReferences(condition->expression.get(), counts);
+    for (const auto& child : condition->all) {
+        if (child) countReferences(child.get(), counts);
+    }
+    for (const auto& child : condition->any) {
+        if (child) countReferences(child.get(), counts);
+    }
+}
+
+void PredicateNetwork::countReferences(ExprNode* node, unordered_map<const void*, size_t>& counts) {
+    if (counts[node]++ > 0) return;
+    for (const auto& child : node->children) {
+        if (child) countReferences(child.get(), counts);
+    }
+}
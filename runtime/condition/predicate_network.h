@@ -0,0 +1,61 @@
+#pragma once
+
+#include "condition_evaluator.h"
+#include "../expression/expression.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+
+using namespace std;
+
+// 谓词网络：加载时对所有规则的条件做结构去重
+// 相同的简单条件、复合条件和表达式子树合并为同一个节点，规则之间共享；
+// 被多处引用的节点标记为shared，评估结果按Context版本缓存，同一版本只计算一次
+// 表达式在合并后才编译字节码（见compile），字节码中的子树指向网络中的节点
+class PredicateNetwork {
+public:
+    // 合并条件树，返回网络中等价的节点
+    shared_ptr<Condition> intern(const shared_ptr<Condition>& condition);
+
+    // 合并表达式树，返回网络中等价的节点
+    shared_ptr<ExprNode> internExpr(const shared_ptr<ExprNode>& node);
+
+    // 合并完成后调用：统计各节点的引用数，标记被多处引用的节点
+    void markShared(const vector<shared_ptr<Condition>>& roots);
+
+    // markShared之后调用：为本次合并新增的表达式根节点编译字节码，共享子树编译为OP_CALL以使用缓存结果
+    // 之前已加入网络的节点可能正被规则集使用，不再修改
+    void compile();
+
+    // 删除不再被roots引用的节点（重新加载规则后调用，网络在多次加载之间复用）
+    void prune(const vector<shared_ptr<Condition>>& roots);
+    
+    // 清空网络
+    void clear();
+
+    // 获取统计信息：节点数、解析节点总数、共享节点数
+    json getStats() const;
+
+private:
+    unordered_map<string, shared_ptr<Condition>> conditions_;
+    unordered_map<string, shared_ptr<ExprNode>> expressions_;
+    unordered_map<const void*, size_t> node_ids_;   // 节点 -> 编号，用于生成父节点的键
+    size_t next_id_ = 0;                            // 编号只增不减，删除节点后不会重复
+    size_t references_ = 0;
+    size_t shared_nodes_ = 0;
+    unordered_set<const ExprNode*> added_;          // 本次合并新增的表达式节点
+    vector<shared_ptr<ExprNode>> uncompiled_;       // 本次合并新增、由条件直接引用的表达式根节点
+
+    // 获取节点编号
+    size_t idOf(const void* node) const;
+
+    // 统计引用数，首次访问时递归子节点
+    void countReferences(Condition* condition, unordered_map<const void*, size_t>& counts);
+    void countReferences(ExprNode* node, unordered_map<const void*, size_t>& counts);
+
+    // 检查节点是否依赖时间
+    template <typename Node>
+    static bool isTimeDependent(const Node& node);
+};
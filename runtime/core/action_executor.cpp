@@ -0,0 +1,229 @@
+#include "action_executor.h"
+#include <iostream>
+#include <chrono>
+#include <functional>
+
+// ActionStats 实现
+void ActionStats::record(uint64_t latency_us, uint64_t exec_us) {
+    executed.fetch_add(1, memory_order_relaxed);
+    total_latency_us.fetch_add(latency_us, memory_order_relaxed);
+    total_exec_us.fetch_add(exec_us, memory_order_relaxed);
+    uint64_t current = max_latency_us.load(memory_order_relaxed);
+    while (latency_us > current &&
+           !max_latency_us.compare_exchange_weak(current, latency_us, memory_order_relaxed)) {
+    }
+}
+
+json ActionStats::toJson() const {
+    uint64_t count = executed.load(memory_order_relaxed);
+    json stats;
+    stats["executed"] = count;
+    stats["dropped"] = dropped.load(memory_order_relaxed);
+    stats["inlined"] = inlined.load(memory_order_relaxed);
+    stats["failed"] = failed.load(memory_order_relaxed);
+    stats["avg_latency_us"] = count ? total_latency_us.load(memory_order_relaxed) / count : 0;
+    stats["max_latency_us"] = max_latency_us.load(memory_order_relaxed);
+    stats["avg_exec_us"] = count ? total_exec_us.load(memory_order_relaxed) / count : 0;
+    return stats;
+}
+
+// ActionExecutor 实现
+ActionExecutor::ActionExecutor(size_t threads, size_t queue_capacity, Profiler* profiler)
+    : next_worker_(0), pending_(0), submitted_(0), stop_(false), profiler_(profiler), has_writes_(false) {
+    if (threads == 0) threads = 1;
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back(new Worker(queue_capacity));
+    }
+    for (auto& worker : workers_) {
+        Worker* w = worker.get();
+        w->thread_ = thread([this, w] { workerLoop(*w); });
+    }
+}
+
+ActionExecutor::~ActionExecutor() {
+    // 先执行完已入队的动作再退出
+    flush();
+    stop_.store(true);
+    for (auto& worker : workers_) {
+        wake(*worker);
+        worker->thread_.join();
+    }
+}
+
+ActionExecutor::SubmitResult ActionExecutor::submit(Task&& task) {
+    const ActionOptions& options = task.binding->options;
+    
+    size_t index;
+    switch (options.ordering) {
+        case ORDER_PER_RULE:
+            index = hash<string>()(task.rule_id) % workers_.size();
+            break;
+        case ORDER_PER_ACTION:
+            index = task.binding->name_hash % workers_.size();
+            break;
+        default:
+            index = next_worker_.fetch_add(1, memory_order_relaxed) % workers_.size();
+            break;
+    }
+    
+    task.enqueue_us = now_us();
+    pending_.fetch_add(1);
+    
+    Worker& worker = *workers_[index];
+    bool pushed = worker.queue.tryPush(move(task));
+    
+    // 无序动作可以放入任意有空位的队列
+    for (size_t i = 1; !pushed && options.ordering == ORDER_UNORDERED && i < workers_.size(); ++i) {
+        Worker& other = *workers_[(index + i) % workers_.size()];
+        if (other.queue.tryPush(move(task))) {
+            wake(other);
+            submitted_.fetch_add(1, memory_order_relaxed);
+            return SUBMITTED;
+        }
+    }
+    
+    if (!pushed) {
+        OverflowPolicy overflow = options.overflow;
+        if (overflow == OVERFLOW_INLINE && options.ordering != ORDER_UNORDERED) {
+            overflow = OVERFLOW_BLOCK;
+        }
+        switch (overflow) {
+            case OVERFLOW_DROP:
+                finishOne();
+                task.binding->stats.dropped.fetch_add(1, memory_order_relaxed);
+                return DROPPED;
+            case OVERFLOW_INLINE:
+                finishOne();
+                task.binding->stats.inlined.fetch_add(1, memory_order_relaxed);
+                return REJECTED;
+            default:
+                while (!worker.queue.tryPush(move(task))) {
+                    wake(worker);
+                    this_thread::yield();
+                }
+                break;
+        }
+    }
+    
+    wake(worker);
+    submitted_.fetch_add(1, memory_order_relaxed);
+    return SUBMITTED;
+}
+
+void ActionExecutor::flush() {
+    unique_lock<mutex> lock(done_mutex_);
+    done_cv_.wait(lock, [this] { return pending_.load() == 0; });
+}
+
+void ActionExecutor::takeWrites(vector<AsyncWrite>& writes) {
+    lock_guard<mutex> lock(writes_mutex_);
+    writes.swap(writes_);
+    writes_.clear();
+    has_writes_.store(false, memory_order_relaxed);
+}
+
+bool ActionExecutor::hasWrites() const {
+    return has_writes_.load(memory_order_relaxed);
+}
+
+size_t ActionExecutor::size() const {
+    return workers_.size();
+}
+
+json ActionExecutor::getStats() const {
+    json stats;
+    json depths = json::array();
+    size_t total = 0;
+    for (const auto& worker : workers_) {
+        size_t depth = worker->queue.size();
+        depths.push_back(depth);
+        total += depth;
+    }
+    stats["workers"] = workers_.size();
+    stats["queue_capacity"] = workers_.empty() ? 0 : workers_[0]->queue.capacity();
+    stats["queue_depth"] = total;
+    stats["queue_depths"] = depths;
+    stats["pending"] = pending_.load();
+    stats["submitted"] = submitted_.load(memory_order_relaxed);
+    return stats;
+}
+
+uint64_t ActionExecutor::now_us() {
+    return chrono::duration_cast<chrono::microseconds>(
+        chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+void ActionExecutor::workerLoop(Worker& worker) {
+    Context scratch;                    // 动作在快照的副本上执行
+    const Context* loaded = nullptr;    // scratch当前对应的快照
+    Task task;
+    
+    while (true) {
+        if (worker.queue.tryPop(task)) {
+            run(task, scratch, loaded);
+            task = Task();
+            finishOne();
+            continue;
+        }
+        if (stop_.load()) return;
+        
+        // 队列为空时休眠，入队时由submit唤醒；超时兜底防止错过唤醒
+        unique_lock<mutex> lock(worker.mutex_);
+        worker.sleeping.store(true);
+        atomic_thread_fence(memory_order_seq_cst);
+        worker.cv.wait_for(lock, chrono::milliseconds(10), [&] {
+            return stop_.load() || !worker.queue.empty();
+        });
+        worker.sleeping.store(false);
+    }
+}
+
+void ActionExecutor::run(Task& task, Context& scratch, const Context*& loaded) {
+    // 快照变化或上一个动作修改过副本时重新载入
+    if (loaded != task.snapshot.get() || scratch.version() != scratch.resetVersion()) {
+        scratch = *task.snapshot;
+        loaded = task.snapshot.get();
+    }
+    
+    uint64_t before = scratch.version();
+    uint64_t start = now_us();
+    try {
+        task.binding->fn(task.step->params, scratch);
+    } catch (const exception& e) {
+        task.binding->stats.failed.fetch_add(1, memory_order_relaxed);
+        cerr << "Error executing action " << task.step->name << " in rule " << task.rule_id << ": " << e.what() << endl;
+    }
+    uint64_t end = now_us();
+    task.binding->stats.record(end - task.enqueue_us, end - start);
+    if (profiler_ && profiler_->enabled()) {
+        profiler_->recordAction(task.binding->profile_id, (end - start) * 1000);
+    }
+    
+    // 收集动作写入的值
+    if (scratch.version() != before) {
+        vector<SlotId> slots;
+        scratch.changedSince(before, slots);
+        lock_guard<mutex> lock(writes_mutex_);
+        for (SlotId slot : slots) {
+            writes_.push_back({task.device, slot, scratch.getSlotJson(slot)});
+        }
+        has_writes_.store(true, memory_order_relaxed);
+    }
+}
+
+void ActionExecutor::wake(Worker& worker) {
+    // 与workerLoop中的栅栏配对：入队与检查休眠标志不能重排
+    atomic_thread_fence(memory_order_seq_cst);
+    if (worker.sleeping.load()) {
+        lock_guard<mutex> lock(worker.mutex_);
+        worker.cv.notify_one();
+    }
+}
+
+void ActionExecutor::finishOne() {
+    if (pending_.fetch_sub(1) == 1) {
+        lock_guard<mutex> lock(done_mutex_);
+        done_cv_.notify_all();
+    }
+}
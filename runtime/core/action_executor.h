@@ -0,0 +1,160 @@
+#pragma once
+
+#include "context.h"
+#include "rule.h"
+#include "bounded_queue.h"
+#include "profiler.h"
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+
+using namespace std;
+
+// 异步动作的顺序保证
+enum ActionOrdering {
+    ORDER_PER_RULE,     // 同一规则触发的动作按触发顺序依次执行
+    ORDER_PER_ACTION,   // 同一动作的所有调用依次执行
+    ORDER_UNORDERED     // 不保证顺序，分派到任意工作线程
+};
+
+// 队列已满时的处理策略
+enum OverflowPolicy {
+    OVERFLOW_BLOCK,     // 等待队列有空位
+    OVERFLOW_DROP,      // 丢弃本次调用
+    OVERFLOW_INLINE     // 在tick线程上同步执行；有顺序保证的动作同步执行会越过队列中更早的调用，改为等待空位
+};
+
+// 动作执行选项（默认同步执行，与原有行为相同）
+struct ActionOptions {
+    bool async;                 // 是否交给动作执行器异步执行
+    ActionOrdering ordering;
+    OverflowPolicy overflow;
+    
+    ActionOptions() : async(false), ordering(ORDER_PER_RULE), overflow(OVERFLOW_BLOCK) {}
+};
+
+// 单个动作的执行统计（微秒）
+struct ActionStats {
+    atomic<uint64_t> executed{0};       // 执行次数
+    atomic<uint64_t> dropped{0};        // 队列满被丢弃的次数
+    atomic<uint64_t> inlined{0};        // 队列满改为同步执行的次数
+    atomic<uint64_t> failed{0};         // 抛出异常的次数
+    atomic<uint64_t> total_latency_us{0};   // 入队到执行完成的总耗时
+    atomic<uint64_t> max_latency_us{0};
+    atomic<uint64_t> total_exec_us{0};      // 动作函数本身的总耗时
+    
+    // 记录一次执行
+    void record(uint64_t latency_us, uint64_t exec_us);
+    
+    json toJson() const;
+};
+
+// 已注册的动作
+struct ActionBinding {
+    string name;
+    ActionFn fn;
+    ActionOptions options;
+    size_t name_hash;
+    uint32_t profile_id;    // 在Profiler中的编号
+    ActionStats stats;
+};
+
+// 动作槽位：加载规则时每个动作名称对应一个槽位，动作步骤直接引用槽位
+// 注册或重新注册动作时只更新槽位中的绑定，已加载的规则不需要重新解析
+struct ActionSlot {
+    string name;
+    shared_ptr<ActionBinding> binding;  // 未注册时为空
+};
+
+// 异步动作写入Context的值，在下一次tick开始时合并
+struct AsyncWrite {
+    size_t device;      // ContextBatch中的设备下标（单Context为SIZE_MAX）
+    SlotId slot;
+    Value value;
+};
+
+// 动作执行器：tick只负责把触发的动作放入有界无锁队列，由工作线程执行
+// 每个工作线程一个队列，按顺序保证选择队列：同一规则或同一动作的调用总是进入同一个队列
+// 动作在触发时刻的Context快照上执行，写入的值通过takeWrites交回引擎
+class ActionExecutor {
+public:
+    // 一次动作调用
+    struct Task {
+        shared_ptr<ActionBinding> binding;
+        shared_ptr<const Rule> rule;            // 规则原型，持有动作步骤，规则集替换后仍然有效
+        const ActionStep* step = nullptr;       // 指向规则原型中的动作步骤
+        string rule_id;
+        shared_ptr<const Context> snapshot;     // 触发时刻的Context
+        size_t device = SIZE_MAX;
+        uint64_t enqueue_us = 0;
+    };
+    
+    // 提交结果
+    enum SubmitResult {
+        SUBMITTED,      // 已入队
+        DROPPED,        // 队列满，已丢弃
+        REJECTED        // 队列满，调用方应同步执行（只用于ORDER_UNORDERED）
+    };
+    
+    // profiler不为空且已开启时记录每次动作的执行耗时
+    ActionExecutor(size_t threads, size_t queue_capacity, Profiler* profiler = nullptr);
+    ~ActionExecutor();
+    
+    ActionExecutor(const ActionExecutor&) = delete;
+    ActionExecutor& operator=(const ActionExecutor&) = delete;
+    
+    // 提交动作调用，按绑定的选项选择队列和溢出策略
+    SubmitResult submit(Task&& task);
+    
+    // 等待所有已提交的动作执行完成
+    void flush();
+    
+    // 取出异步动作写入的值
+    void takeWrites(vector<AsyncWrite>& writes);
+    
+    // 是否有待合并的写入
+    bool hasWrites() const;
+    
+    // 工作线程数
+    size_t size() const;
+    
+    // 队列统计：每个队列的当前深度、容量、累计提交数
+    json getStats() const;
+    
+    // 当前时间（微秒）
+    static uint64_t now_us();
+    
+private:
+    struct Worker {
+        BoundedQueue<Task> queue;
+        thread thread_;
+        mutex mutex_;
+        condition_variable cv;
+        atomic<bool> sleeping{false};
+        
+        explicit Worker(size_t capacity) : queue(capacity) {}
+    };
+    
+    vector<unique_ptr<Worker>> workers_;
+    atomic<size_t> next_worker_;        // 无序动作的轮转位置
+    atomic<size_t> pending_;            // 已提交未完成的调用数
+    atomic<uint64_t> submitted_;
+    atomic<bool> stop_;
+    Profiler* profiler_;
+    
+    mutex done_mutex_;
+    condition_variable done_cv_;
+    
+    mutable mutex writes_mutex_;
+    vector<AsyncWrite> writes_;
+    atomic<bool> has_writes_;
+    
+    void workerLoop(Worker& worker);
+    void run(Task& task, Context& scratch, const Context*& loaded);
+    void wake(Worker& worker);
+    void finishOne();
+};
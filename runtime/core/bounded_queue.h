@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+using namespace std;
+
+// 有界无锁多生产者多消费者队列（基于每个槽位的序号，见Dmitry Vyukov的bounded MPMC queue）
+// 容量向上取整为2的幂；队列满时tryPush返回false，空时tryPop返回false
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        cells_.reset(new Cell[size]);
+        mask_ = size - 1;
+        for (size_t i = 0; i < size; ++i) {
+            cells_[i].sequence.store(i, memory_order_relaxed);
+        }
+        enqueue_pos_.store(0, memory_order_relaxed);
+        dequeue_pos_.store(0, memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    bool tryPush(T&& value) {
+        size_t pos = enqueue_pos_.load(memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;   // 队列已满
+            } else {
+                pos = enqueue_pos_.load(memory_order_relaxed);
+            }
+        }
+        cell->value = move(value);
+        cell->sequence.store(pos + 1, memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& value) {
+        size_t pos = dequeue_pos_.load(memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;   // 队列为空
+            } else {
+                pos = dequeue_pos_.load(memory_order_relaxed);
+            }
+        }
+        value = move(cell->value);
+        cell->value = T();      // 尽早释放元素持有的资源
+        cell->sequence.store(pos + mask_ + 1, memory_order_release);
+        return true;
+    }
+
+    // 当前元素数量（并发修改时为近似值）
+    size_t size() const {
+        size_t enqueued = enqueue_pos_.load(memory_order_relaxed);
+        size_t dequeued = dequeue_pos_.load(memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    size_t capacity() const {
+        return mask_ + 1;
+    }
+
+private:
+    struct Cell {
+        atomic<size_t> sequence;
+        T value;
+    };
+
+    unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    alignas(64) atomic<size_t> enqueue_pos_;
+    alignas(64) atomic<size_t> dequeue_pos_;
+};
@@ -0,0 +1,52 @@
+#include "clock.h"
+#include <chrono>
+
+// ClockSnapshot 实现
+ClockSnapshot ClockSnapshot::now() {
+    uint64_t steady_ms = chrono::duration_cast<chrono::milliseconds>(
+        chrono::steady_clock::now().time_since_epoch()
+    ).count();
+    time_t wall_time = chrono::system_clock::to_time_t(chrono::system_clock::now());
+
+    // 同一秒内多次tick复用本地时间的换算结果
+    static thread_local ClockSnapshot last;
+    if (last.wall_time != wall_time) {
+        last = at(wall_time);
+    }
+    ClockSnapshot snapshot = last;
+    snapshot.steady_ms = steady_ms;
+    return snapshot;
+}
+
+ClockSnapshot ClockSnapshot::at(time_t wall_time, uint64_t steady_ms) {
+    struct tm timeinfo;
+    localtime_r(&wall_time, &timeinfo);     // 并行评估时localtime不可重入
+
+    ClockSnapshot snapshot;
+    snapshot.steady_ms = steady_ms;
+    snapshot.wall_time = static_cast<int64_t>(wall_time);
+    snapshot.minute_of_day = timeinfo.tm_hour * 60 + timeinfo.tm_min;
+    snapshot.day_of_week = timeinfo.tm_wday;
+    return snapshot;
+}
+
+int ClockSnapshot::parseTimeOfDay(string_view text) {
+    // 逐段读取1~2位数字，段之间以':'分隔
+    int parts[3] = {0, 0, 0};
+    size_t count = 0;
+    size_t i = 0;
+    while (count < 3) {
+        size_t start = i;
+        int value = 0;
+        while (i < text.size() && i - start < 2 && text[i] >= '0' && text[i] <= '9') {
+            value = value * 10 + (text[i++] - '0');
+        }
+        if (i == start) return -1;
+        parts[count++] = value;
+        if (i == text.size()) break;
+        if (text[i++] != ':') return -1;
+    }
+    if (i != text.size() || count < 2) return -1;
+    if (parts[0] > 23 || parts[1] > 59 || parts[2] > 59) return -1;
+    return parts[0] * 60 + parts[1];
+}
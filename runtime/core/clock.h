@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <ctime>
+
+using namespace std;
+
+// 时钟快照：引擎每次tick读取一次，同一次tick内的节流计时和时间函数共用
+// 本地时间在读取时换算成当天的分钟数和星期，时间函数求值时只做整数比较
+struct ClockSnapshot {
+    uint64_t steady_ms = 0;     // 单调时钟（毫秒），用于节流和唤醒
+    int64_t wall_time = 0;      // 墙上时间（秒），0表示未读取
+    int minute_of_day = 0;      // 本地时间当天的分钟数，0~1439
+    int day_of_week = 0;        // 本地时间的星期，0=周日
+
+    bool valid() const { return wall_time != 0; }
+
+    // 读取当前时钟；墙上时间与本线程上次读取相同（同一秒）时不再换算本地时间
+    static ClockSnapshot now();
+
+    // 按指定的墙上时间构造（用于测试和回放）
+    static ClockSnapshot at(time_t wall_time, uint64_t steady_ms = 0);
+
+    // 解析 "HH:MM" 或 "HH:MM:SS"（秒向下取整到分钟）为当天的分钟数，格式错误返回-1
+    static int parseTimeOfDay(string_view text);
+};
@@ -1,32 +1,237 @@
 #include "context.h"
+#include "trace.h"
 #include <vector>
+#include <atomic>
+
+// 不存在的槽位返回该值
+static const Scalar NULL_SCALAR;
+
+// 全局版本计数器，实例编号和版本号都从这里分配，保证跨Context唯一
+static atomic<uint64_t> g_version_counter(0);
+
+static uint64_t nextVersion() {
+    return g_version_counter.fetch_add(1, memory_order_relaxed) + 1;
+}
 
 // Context 实现
+Context::Context() : count_(0), recorder_(nullptr), history_version_(0) {
+    uid_ = nextVersion();
+    version_ = reset_version_ = nextVersion();
+}
+
+Context::Context(const Context& other)
+    : values_(other.values_), objects_(other.objects_), present_(other.present_),
+      count_(other.count_), slot_versions_(other.slot_versions_), recorder_(nullptr),
+      history_version_(other.history_version_), clock_(other.clock_) {
+    copyHistory(other);
+    uid_ = nextVersion();
+    version_ = reset_version_ = nextVersion();
+}
+
+Context& Context::operator=(const Context& other) {
+    if (this != &other) {
+        values_ = other.values_;
+        objects_ = other.objects_;
+        present_ = other.present_;
+        count_ = other.count_;
+        slot_versions_ = other.slot_versions_;
+        copyHistory(other);
+        history_version_ = other.history_version_;
+        clock_ = other.clock_;
+        version_ = reset_version_ = nextVersion();
+    }
+    return *this;
+}
+
+void Context::copyFrom(const Context& other) {
+    if (this == &other) return;
+    values_ = other.values_;
+    objects_ = other.objects_;
+    present_ = other.present_;
+    count_ = other.count_;
+    slot_versions_ = other.slot_versions_;
+    copyHistory(other);
+    history_version_ = other.history_version_;
+    clock_ = other.clock_;
+    // 内容与other相同，沿用其版本号不影响按版本缓存的结果
+    version_ = other.version_;
+    reset_version_ = other.reset_version_;
+}
+
+void Context::syncFrom(const Context& other) {
+    if (this == &other) return;
+    if (reset_version_ != other.reset_version_ || version_ > other.version_) {
+        copyFrom(other);
+        return;
+    }
+
+    if (values_.size() < other.values_.size()) {
+        values_.resize(other.values_.size());
+        present_.resize(other.values_.size(), 0);
+        slot_versions_.resize(other.values_.size(), 0);
+    }
+    bool same_history = history_version_ == other.history_version_;
+    for (SlotId slot = 0; slot < other.slot_versions_.size(); ++slot) {
+        if (other.slot_versions_[slot] <= version_) continue;
+        values_[slot] = other.values_[slot];
+        present_[slot] = other.present_[slot];
+        slot_versions_[slot] = other.slot_versions_[slot];
+        if (values_[slot].isJson()) {
+            if (slot >= objects_.size()) {
+                objects_.resize(slot + 1);
+            }
+            objects_[slot] = slot < other.objects_.size() ? other.objects_[slot] : Value();
+        }
+        if (same_history && slot < other.history_.size() && other.history_[slot]) {
+            history_[slot].reset(new HistoryBuffer(*other.history_[slot]));
+        }
+    }
+    if (!same_history) {
+        copyHistory(other);
+        history_version_ = other.history_version_;
+    }
+    count_ = other.count_;
+    clock_ = other.clock_;
+    version_ = other.version_;
+}
+
+void Context::copyValues(const Context& other) {
+    if (this == &other) return;
+    values_ = other.values_;
+    objects_ = other.objects_;
+    present_ = other.present_;
+    count_ = other.count_;
+    slot_versions_ = other.slot_versions_;
+    history_.clear();
+    history_version_ = 0;
+    clock_ = other.clock_;
+    version_ = reset_version_ = nextVersion();
+}
+
 void Context::set(const string& key, const Value& value) {
-    data_[key] = value;
+    setSlot(SymbolTable::global().intern(key), value);
+}
+
+void Context::set(const string& key, const Scalar& value) {
+    setSlot(SymbolTable::global().intern(key), value);
 }
 
 Value Context::get(const string& key) const {
-    auto it = data_.find(key);
-    return (it != data_.end()) ? it->second : Value();
+    return getSlotJson(SymbolTable::global().lookup(key));
 }
 
 bool Context::has(const string& key) const {
-    return data_.find(key) != data_.end();
+    return hasSlot(SymbolTable::global().lookup(key));
+}
+
+void Context::setSlot(SlotId slot, const Value& value) {
+    if (slot == INVALID_SLOT) return;
+    if (recorder_) recorder_->record(slot, value);
+    touch(slot);
+    values_[slot] = Scalar::fromJson(value);
+    recordHistory(slot, values_[slot]);
+    if (values_[slot].isJson()) {
+        if (slot >= objects_.size()) {
+            objects_.resize(slot + 1);
+        }
+        objects_[slot] = value;
+    }
+}
+
+void Context::setSlot(SlotId slot, const Scalar& value) {
+    if (slot == INVALID_SLOT) return;
+    if (recorder_) recorder_->record(slot, value);
+    touch(slot);
+    values_[slot] = value;
+    recordHistory(slot, value);
+}
+
+const Scalar& Context::getSlot(SlotId slot) const {
+    return hasSlot(slot) ? values_[slot] : NULL_SCALAR;
+}
+
+Value Context::getSlotJson(SlotId slot) const {
+    if (!hasSlot(slot)) return Value();
+    const Scalar& value = values_[slot];
+    if (value.isJson()) {
+        return slot < objects_.size() ? objects_[slot] : Value();
+    }
+    return value.toJson();
+}
+
+bool Context::hasSlot(SlotId slot) const {
+    return slot < present_.size() && present_[slot];
 }
 
 vector<string> Context::keys() const {
     vector<string> result;
-    for (const auto& pair : data_) {
-        result.push_back(pair.first);
+    const SymbolTable& symbols = SymbolTable::global();
+    for (SlotId slot = 0; slot < present_.size(); ++slot) {
+        if (present_[slot]) {
+            result.push_back(symbols.name(slot));
+        }
     }
     return result;
 }
 
 void Context::clear() {
-    data_.clear();
+    values_.clear();
+    objects_.clear();
+    present_.clear();
+    slot_versions_.clear();
+    history_.clear();
+    history_version_ = 0;
+    count_ = 0;
+    version_ = reset_version_ = nextVersion();
 }
 
 size_t Context::size() const {
-    return data_.size();
+    return count_;
+}
+
+void Context::trackHistory(SlotId slot, size_t window) {
+    if (slot == INVALID_SLOT) return;
+    if (slot >= history_.size()) {
+        history_.resize(slot + 1);
+    }
+    if (!history_[slot]) {
+        history_[slot].reset(new HistoryBuffer());
+    }
+    history_[slot]->addWindow(window);
+    history_version_ = nextVersion();
+}
+
+void Context::copyHistory(const Context& other) {
+    history_.clear();
+    history_.resize(other.history_.size());
+    for (size_t slot = 0; slot < other.history_.size(); ++slot) {
+        if (other.history_[slot]) {
+            history_[slot].reset(new HistoryBuffer(*other.history_[slot]));
+        }
+    }
+}
+
+uint64_t Context::slotVersion(SlotId slot) const {
+    return slot < slot_versions_.size() ? slot_versions_[slot] : 0;
+}
+
+void Context::changedSince(uint64_t since, vector<SlotId>& slots) const {
+    for (SlotId slot = 0; slot < slot_versions_.size(); ++slot) {
+        if (slot_versions_[slot] > since) {
+            slots.push_back(slot);
+        }
+    }
+}
+
+void Context::touch(SlotId slot) {
+    if (slot >= values_.size()) {
+        values_.resize(slot + 1);
+        present_.resize(slot + 1, 0);
+        slot_versions_.resize(slot + 1, 0);
+    }
+    if (!present_[slot]) {
+        present_[slot] = 1;
+        count_++;
+    }
+    version_ = slot_versions_[slot] = nextVersion();
 }
@@ -1,8 +1,14 @@
 #pragma once
 
+#include "symbol_table.h"
+#include "scalar.h"
+#include "history.h"
+#include "clock.h"
 #include <nlohmann/json.hpp>
 #include <string>
+#include <vector>
 #include <unordered_map>
+#include <memory>
 
 using namespace nlohmann;
 using namespace std;
@@ -10,27 +16,117 @@ using namespace std;
 // 值类型，支持多种数据类型
 using Value = json;
 
+class TraceRecorder;
+
 // 上下文类，存储传感器数据
+// 数据按符号表槽位以Scalar存储；字符串键和json接口为慢路径适配
+// 每次写入都会为槽位打上全局递增的版本号，引擎据此只重新评估受影响的规则
 class Context {
 public:
+    Context();
+    Context(const Context& other);
+    Context& operator=(const Context& other);
+
+    // 复制另一个Context的数据并延续其版本历史（版本号、槽位版本号、重置版本号均不变）
+    // 与赋值不同，之后用changedSince仍能找出相对原版本新写入的槽位，用于写时复制
+    void copyFrom(const Context& other);
+
+    // 把other的较早副本（copyFrom或syncFrom得到，之后未被修改）更新为other：只复制版本号更新的槽位，
+    // 结果与copyFrom相同；不是较早副本（other发生过clear、来自其他Context）时整体复制
+    void syncFrom(const Context& other);
+
+    // 复制另一个Context的数据和时钟快照，不复制历史记录（异步动作的快照用），版本号与赋值相同重新分配
+    void copyValues(const Context& other);
+
     // 设置键值对
     void set(const string& key, const Value& value);
-    
+    void set(const string& key, const Scalar& value);
+
     // 获取值
     Value get(const string& key) const;
-    
+
     // 检查键是否存在
     bool has(const string& key) const;
-    
+
+    // 按槽位设置值
+    void setSlot(SlotId slot, const Value& value);
+    void setSlot(SlotId slot, const Scalar& value);
+
+    // 按槽位获取值（不存在时返回空值的引用，不拷贝）
+    const Scalar& getSlot(SlotId slot) const;
+
+    // 按槽位获取json值（对象/数组等非标量值从这里取）
+    Value getSlotJson(SlotId slot) const;
+
+    // 检查槽位是否有值
+    bool hasSlot(SlotId slot) const;
+
     // 获取所有键
     vector<string> keys() const;
-    
+
     // 清空上下文
     void clear();
-    
+
     // 获取上下文大小
     size_t size() const;
-    
+
+    // 实例编号（构造和拷贝时分配，用于区分不同的Context）
+    uint64_t uid() const { return uid_; }
+
+    // 最近一次修改的版本号
+    uint64_t version() const { return version_; }
+
+    // 最近一次整体重置（构造、拷贝、clear）的版本号
+    uint64_t resetVersion() const { return reset_version_; }
+
+    // 槽位最近一次写入的版本号（未写入为0）
+    uint64_t slotVersion(SlotId slot) const;
+
+    // 收集版本号大于since的槽位
+    void changedSince(uint64_t since, vector<SlotId>& slots) const;
+
+    // 历史记录：为槽位保留最近写入的数值样本（布尔和非数字值不记录），按窗口长度维护增量聚合
+    // 由引擎按表达式中引用的 (变量, 窗口长度) 注册，未注册的槽位写入时没有额外开销
+    // 拷贝和赋值时一并拷贝；clear()删除全部历史记录和注册
+    void trackHistory(SlotId slot, size_t window);
+
+    // 槽位的历史记录（未注册时返回nullptr）
+    const HistoryBuffer* history(SlotId slot) const {
+        return slot < history_.size() ? history_[slot].get() : nullptr;
+    }
+
+    // 时钟快照：引擎在每次tick开始时写入，时间函数按它求值（未写入时读取当前时钟）
+    // 拷贝和赋值时一并拷贝，异步动作的快照与触发时的tick一致
+    void setClock(const ClockSnapshot& clock) { clock_ = clock; }
+    const ClockSnapshot& clock() const { return clock_; }
+
+    // 挂接轨迹录制器，之后的每次写入都会被记录（nullptr取消；拷贝出的Context不继承）
+    void setRecorder(TraceRecorder* recorder) { recorder_ = recorder; }
+
 private:
-    unordered_map<string, Value> data_;
+    vector<Scalar> values_;     // 按槽位索引的值
+    vector<Value> objects_;     // JSON类型槽位的完整json值（按需分配）
+    vector<uint8_t> present_;   // 槽位是否已设置
+    size_t count_;              // 已设置的槽位数量
+    vector<uint64_t> slot_versions_;    // 槽位写入版本号
+    uint64_t uid_;
+    uint64_t version_;
+    uint64_t reset_version_;
+    TraceRecorder* recorder_;
+    vector<unique_ptr<HistoryBuffer>> history_;     // 按槽位索引，未注册为空
+    uint64_t history_version_;  // 最近一次注册历史窗口的版本号（注册不是写入，syncFrom据此判断是否整体复制历史记录）
+    ClockSnapshot clock_;
+
+    // 已注册历史记录的槽位写入数值时追加样本
+    void recordHistory(SlotId slot, const Scalar& value) {
+        if (slot < history_.size() && history_[slot] && value.isNumber()) {
+            history_[slot]->push(value.asDouble());
+        }
+    }
+
+    // 深拷贝另一个Context的历史记录
+    void copyHistory(const Context& other);
+
+    // 确保槽位存在，标记为已设置并更新版本号
+    void touch(SlotId slot);
 };
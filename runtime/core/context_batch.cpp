@@ -0,0 +1,150 @@
+#include "context_batch.h"
+#include <unordered_map>
+#include <cmath>
+
+// 超过该范围的整数转换为double会丢失精度，不走列式数值比较
+static const int64_t EXACT_DOUBLE_INT = int64_t(1) << 53;
+
+// ContextBatch 实现
+ContextBatch::ContextBatch(size_t devices) : rule_set_version_(0) {
+    resize(devices);
+}
+
+size_t ContextBatch::size() const {
+    return rows_.size();
+}
+
+size_t ContextBatch::addDevice() {
+    resize(rows_.size() + 1);
+    return rows_.size() - 1;
+}
+
+void ContextBatch::resize(size_t devices) {
+    rows_.resize(devices);
+    for (auto& column : columns_) {
+        if (column.values.empty()) continue;
+        column.values.resize(devices);
+        column.numbers.resize(devices, 0.0);
+        column.numeric.resize(devices, 0);
+    }
+    for (auto& times : last_fire_) {
+        times.resize(devices, 0);
+    }
+    for (auto& flags : done_) {
+        flags.resize(devices, 0);
+    }
+}
+
+void ContextBatch::set(size_t device, const string& key, const Value& value) {
+    setSlot(device, SymbolTable::global().intern(key), value);
+}
+
+void ContextBatch::set(size_t device, const string& key, const Scalar& value) {
+    setSlot(device, SymbolTable::global().intern(key), value);
+}
+
+void ContextBatch::setSlot(size_t device, SlotId slot, const Value& value) {
+    if (slot == INVALID_SLOT || device >= rows_.size()) return;
+    rows_[device].setSlot(slot, value);
+    storeColumn(device, slot, rows_[device].getSlot(slot));
+}
+
+void ContextBatch::setSlot(size_t device, SlotId slot, const Scalar& value) {
+    if (slot == INVALID_SLOT || device >= rows_.size()) return;
+    rows_[device].setSlot(slot, value);
+    storeColumn(device, slot, value);
+}
+
+Value ContextBatch::get(size_t device, const string& key) const {
+    return rows_.at(device).get(key);
+}
+
+const Scalar& ContextBatch::getSlot(size_t device, SlotId slot) const {
+    return rows_.at(device).getSlot(slot);
+}
+
+const Context& ContextBatch::row(size_t device) const {
+    return rows_.at(device);
+}
+
+const ContextBatch::Column* ContextBatch::column(SlotId slot) const {
+    if (slot >= columns_.size() || columns_[slot].values.empty()) return nullptr;
+    return &columns_[slot];
+}
+
+void ContextBatch::clear() {
+    for (auto& row : rows_) {
+        row.clear();
+    }
+    columns_.clear();
+}
+
+Context& ContextBatch::mutableRow(size_t device) {
+    return rows_[device];
+}
+
+void ContextBatch::syncRow(size_t device, uint64_t since) {
+    const Context& row = rows_[device];
+
+    // 行视图被整体清空过：所有列都需要按行视图重新填写
+    if (row.resetVersion() > since) {
+        for (SlotId slot = 0; slot < columns_.size(); ++slot) {
+            if (!columns_[slot].values.empty()) {
+                storeColumn(device, slot, row.getSlot(slot));
+            }
+        }
+    }
+
+    vector<SlotId> changed;
+    row.changedSince(since, changed);
+    for (SlotId slot : changed) {
+        storeColumn(device, slot, row.getSlot(slot));
+    }
+}
+
+void ContextBatch::bindRules(uint64_t version, const vector<string>& rule_ids) {
+    if (version == rule_set_version_) return;
+
+    unordered_map<string, size_t> previous;
+    for (size_t i = 0; i < rule_ids_.size(); ++i) {
+        previous.emplace(rule_ids_[i], i);
+    }
+
+    vector<vector<uint64_t>> last_fire(rule_ids.size());
+    vector<vector<uint8_t>> done(rule_ids.size());
+    for (size_t i = 0; i < rule_ids.size(); ++i) {
+        auto it = previous.find(rule_ids[i]);
+        if (it != previous.end()) {
+            last_fire[i] = move(last_fire_[it->second]);
+            done[i] = move(done_[it->second]);
+            previous.erase(it);     // ID重复时只迁移给第一条
+        } else {
+            last_fire[i].assign(rows_.size(), 0);
+            done[i].assign(rows_.size(), 0);
+        }
+    }
+
+    last_fire_ = move(last_fire);
+    done_ = move(done);
+    rule_ids_ = rule_ids;
+    rule_set_version_ = version;
+}
+
+void ContextBatch::storeColumn(size_t device, SlotId slot, const Scalar& value) {
+    if (slot >= columns_.size()) {
+        columns_.resize(slot + 1);
+    }
+    Column& column = columns_[slot];
+    if (column.values.empty()) {
+        column.values.resize(rows_.size());
+        column.numbers.assign(rows_.size(), 0.0);
+        column.numeric.assign(rows_.size(), 0);
+    }
+
+    column.values[device] = value;
+    bool exact = value.isNumber() &&
+        (value.type() == ScalarType::DOUBLE ? !std::isnan(value.asDouble())
+                                            : (value.asInt() < EXACT_DOUBLE_INT && value.asInt() > -EXACT_DOUBLE_INT));
+    column.numbers[device] = exact ? value.asDouble() : 0.0;
+    column.numeric[device] = exact ? 1 : 0;
+}
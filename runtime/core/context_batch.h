@@ -0,0 +1,75 @@
+#pragma once
+
+#include "context.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// 批量上下文：一组设备共用一套规则时的传感器数据
+// 数据按槽位列式存储（每个槽位一列，每个设备一行），数值列额外保存为连续的double数组，
+// 引擎据此对所有设备一次性评估同一个条件；每个设备另有一个行视图Context，
+// 用于无法列式评估的条件和执行动作，动作写入的值会同步回列
+class ContextBatch {
+public:
+    // 一个槽位的数据列
+    struct Column {
+        vector<Scalar> values;      // 各设备的值
+        vector<double> numbers;     // 数值的double形式（非数值为0）
+        vector<uint8_t> numeric;    // 是否为可按double精确比较的数值
+    };
+
+    explicit ContextBatch(size_t devices = 0);
+
+    // 设备数量
+    size_t size() const;
+
+    // 添加一个设备，返回设备下标
+    size_t addDevice();
+
+    // 调整设备数量（新设备没有任何数据）
+    void resize(size_t devices);
+
+    // 设置设备的值
+    void set(size_t device, const string& key, const Value& value);
+    void set(size_t device, const string& key, const Scalar& value);
+    void setSlot(size_t device, SlotId slot, const Value& value);
+    void setSlot(size_t device, SlotId slot, const Scalar& value);
+
+    // 获取设备的值
+    Value get(size_t device, const string& key) const;
+    const Scalar& getSlot(size_t device, SlotId slot) const;
+
+    // 设备的行视图
+    const Context& row(size_t device) const;
+
+    // 槽位的数据列（没有任何设备设置过该槽位时返回nullptr）
+    const Column* column(SlotId slot) const;
+
+    // 清空所有设备的数据（保留设备数量）
+    void clear();
+
+private:
+    friend class Engine;
+
+    vector<Context> rows_;      // 每个设备的行视图
+    vector<Column> columns_;    // 按槽位索引的数据列
+
+    // 每个设备的规则状态，按规则下标存储（由Engine维护）
+    uint64_t rule_set_version_;             // 绑定的规则集版本
+    vector<string> rule_ids_;               // 绑定时的规则ID，规则集变化时按ID迁移状态
+    vector<vector<uint64_t>> last_fire_;    // [规则][设备] 上次触发时间
+    vector<vector<uint8_t>> done_;          // [规则][设备] ONCE模式规则已触发
+
+    // 可修改的行视图（动作执行用），修改后需调用syncRow
+    Context& mutableRow(size_t device);
+
+    // 将行视图中版本号大于since的修改同步到数据列
+    void syncRow(size_t device, uint64_t since);
+
+    // 绑定规则集，规则集变化时按规则ID迁移每个设备的状态
+    void bindRules(uint64_t version, const vector<string>& rule_ids);
+
+    // 更新数据列中的一个值
+    void storeColumn(size_t device, SlotId slot, const Scalar& value);
+};
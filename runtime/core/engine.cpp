@@ -5,26 +5,259 @@
 #include <thread>
 #include <chrono>
 #include <algorithm>
+#include <atomic>
+#include <unordered_set>
+
+// 规则集版本号，跨Engine实例唯一
+static atomic<uint64_t> g_rule_set_version(0);
+
+// 收集表达式中历史函数引用的 (变量槽位, 窗口长度)；窗口长度须为常量
+static void collectHistoryWindows(const ExprNode& node, vector<pair<SlotId, uint32_t>>& windows) {
+    if (node.type == EXPR_FUNC && node.children.size() >= 2 && node.children[0] && node.children[1] &&
+        ExprNode::isHistoryFunction(node.func_name)) {
+        const ExprNode& var = *node.children[0];
+        const ExprNode& n = *node.children[1];
+        if (var.type == EXPR_VAR && var.slot != INVALID_SLOT && n.type == EXPR_VALUE && n.literal.isNumber()) {
+            int64_t size = max<int64_t>(1, n.literal.asInt());
+            windows.emplace_back(var.slot, static_cast<uint32_t>(min<int64_t>(size, HistoryBuffer::MAX_WINDOW)));
+        }
+    }
+    for (const auto& child : node.children) {
+        if (child) collectHistoryWindows(*child, windows);
+    }
+}
+
+static void collectHistoryWindows(const Condition& condition, vector<pair<SlotId, uint32_t>>& windows) {
+    if (condition.use_expression) {
+        if (condition.expression) collectHistoryWindows(*condition.expression, windows);
+        return;
+    }
+    for (const auto& child : condition.all) {
+        if (child) collectHistoryWindows(*child, windows);
+    }
+    for (const auto& child : condition.any) {
+        if (child) collectHistoryWindows(*child, windows);
+    }
+}
 
 // Engine 实现
+Engine::Engine()
+    : built_version_(0), pending_(nullptr), retired_(nullptr),
+      incremental_(true), last_ctx_uid_(0), last_ctx_version_(0), evaluations_(0),
+      shared_synced_(0), ready_dirty_(true), exclusive_groups_(false),
+      history_ctx_uid_(0), history_version_(0), adaptive_ordering_(false), adaptive_version_(0), adaptive_ticks_(0), profile_version_(0), profiling_(false),
+      action_snapshot_uid_(0), action_snapshot_version_(0) {
+    active_.version = ++g_rule_set_version;
+    built_version_ = active_.version;
+}
+
+Engine::~Engine() {
+    wait_for_load();
+    delete pending_.exchange(nullptr);
+    delete retired_.exchange(nullptr);
+}
+
 void Engine::register_action(const string& name, ActionFn fn) {
-    actions_[name] = fn;
+    register_action(name, fn, ActionOptions());
+}
+
+void Engine::register_action(const string& name, ActionFn fn, const ActionOptions& options) {
+    auto binding = make_shared<ActionBinding>();
+    binding->name = name;
+    binding->fn = fn;
+    binding->options = options;
+    binding->name_hash = hash<string>()(name);
+    binding->profile_id = profiler_.actionId(name);
+    
+    lock_guard<mutex> lock(build_mutex_);
+    bindAction(name)->binding = binding;
+}
+
+void Engine::set_action_workers(size_t threads, size_t queue_capacity) {
+    executor_.reset();      // 析构时执行完已入队的动作
+    if (threads > 0) {
+        executor_.reset(new ActionExecutor(threads, queue_capacity, &profiler_));
+    }
+}
+
+void Engine::flush_actions() {
+    if (executor_) executor_->flush();
+}
+
+json Engine::get_action_stats() const {
+    json stats;
+    stats["executor"] = executor_ ? executor_->getStats() : json(nullptr);
+    json actions = json::object();
+    lock_guard<mutex> lock(build_mutex_);
+    for (const auto& pair : actions_) {
+        const shared_ptr<ActionBinding>& binding = pair.second->binding;
+        if (binding && binding->options.async) {
+            actions[pair.first] = binding->stats.toJson();
+        }
+    }
+    stats["actions"] = actions;
+    return stats;
 }
 
 void Engine::load(const json& cfg) {
-    rules_.clear();
-    group_manager_ = RuleGroupManager();
+    // 先等待进行中的后台加载，避免它晚于本次加载生效
+    wait_for_load();
+    publishRuleSet(buildRuleSet(cfg));
+    installPendingRules();
+}
+
+void Engine::load_async(const json& cfg) {
+    wait_for_load();
+    loader_ = thread([this, cfg] {
+        publishRuleSet(buildRuleSet(cfg));
+    });
+}
+
+void Engine::wait_for_load() {
+    if (loader_.joinable()) {
+        loader_.join();
+    }
+}
+
+const shared_ptr<ActionSlot>& Engine::bindAction(const string& name) {
+    shared_ptr<ActionSlot>& slot = actions_[name];
+    if (!slot) {
+        slot = make_shared<ActionSlot>();
+        slot->name = name;
+    }
+    return slot;
+}
+
+RuleSet* Engine::buildRuleSet(const json& cfg) {
+    lock_guard<mutex> lock(build_mutex_);
+    
+    // 释放上次替换下来的规则集
+    delete retired_.exchange(nullptr, memory_order_acquire);
+    
+    unique_ptr<RuleSet> set(new RuleSet());
+    unordered_map<string, shared_ptr<const Rule>> prototypes;
+    vector<shared_ptr<Condition>> roots;
+    bool parsed = false;
     
     if (cfg.contains("rules") && cfg["rules"].is_array()) {
+        set->rules.reserve(cfg["rules"].size());
+        roots.reserve(cfg["rules"].size());
         for (const auto& ruleJson : cfg["rules"]) {
-            Rule rule;
-            parseRule(ruleJson, rule);
-            rules_.push_back(rule);
+            // 配置文本未变化的规则复用上次解析的原型
+            string source = ruleJson.dump();
+            auto it = prototypes_.find(source);
+            shared_ptr<const Rule> prototype;
+            if (it != prototypes_.end()) {
+                prototype = it->second;
+            } else {
+                shared_ptr<Rule> rule = make_shared<Rule>();
+                parseRule(ruleJson, *rule);
+                rule->condition = network_.intern(rule->condition);
+                if (rule->condition) {
+                    rule->condition->collectInputs(rule->inputs, rule->time_dependent);
+                }
+                sort(rule->inputs.begin(), rule->inputs.end());
+                rule->inputs.erase(unique(rule->inputs.begin(), rule->inputs.end()), rule->inputs.end());
+                prototype = rule;
+                parsed = true;
+            }
+            
+            set->rules.push_back(*prototype);
+            set->rules.back().source = prototype;
+            roots.push_back(prototype->condition);
+            prototypes.emplace(move(source), move(prototype));
+        }
+    }
+    
+    // 删除的规则不再占用网络节点；规则有增删时重新统计共享节点
+    if (parsed || prototypes.size() != prototypes_.size()) {
+        network_.prune(roots);
+        network_.markShared(roots);
+        network_.compile();
+        expression_cache_.prune();
+    }
+    prototypes_.swap(prototypes);
+    
+    // 规则组冲突处理策略
+    if (cfg.contains("groups") && cfg["groups"].is_object()) {
+        for (auto it = cfg["groups"].begin(); it != cfg["groups"].end(); ++it) {
+            GroupPolicy policy;
+            if (GroupPolicy::fromJson(it.value(), policy)) {
+                set->group_policies.emplace_back(it.key(), policy);
+            } else {
+                cerr << "Invalid mode for rule group " << it.key() << ": " << it.value().dump() << endl;
+            }
         }
+    }
+    
+    // 历史函数引用的窗口，tick时注册到Context
+    for (const auto& root : roots) {
+        if (root) collectHistoryWindows(*root, set->history_windows);
+    }
+    sort(set->history_windows.begin(), set->history_windows.end());
+    set->history_windows.erase(unique(set->history_windows.begin(), set->history_windows.end()),
+                               set->history_windows.end());
+    
+    set->version = ++g_rule_set_version;
+    set->buildDependencyIndex();
+    set->buildIndexes();
+    
+    // 记录每条规则在上一个构建的规则集中的句柄，替换时直接迁移状态
+    set->base_version = built_version_;
+    set->previous.resize(set->rules.size());
+    for (size_t i = 0; i < set->rules.size(); ++i) {
+        auto it = built_ids_.find(set->rules[i].id);
+        set->previous[i] = (it != built_ids_.end()) ? it->second : INVALID_RULE;
+    }
+    built_ids_ = set->rule_ids;
+    built_version_ = set->version;
+    
+    // 未注册的动作只在加载时报告一次，tick时直接跳过
+    for (const auto& rule : set->rules) {
+        for (const auto& step : rule.actions) {
+            if (!step.slot->binding) {
+                cerr << "Unknown action: " << step.name << " in rule " << rule.id << endl;
+            }
+        }
+    }
+    
+    return set.release();
+}
+
+void Engine::publishRuleSet(RuleSet* incoming) {
+    // 上一个还未被tick取走的规则集直接作废
+    delete pending_.exchange(incoming, memory_order_acq_rel);
+}
+
+void Engine::installPendingRules() {
+    RuleSet* incoming = pending_.exchange(nullptr, memory_order_acquire);
+    if (!incoming) return;
+    
+    // 迁移同ID规则的运行状态；条件未变化的规则保留上次评估结果
+    bool mapped = (incoming->base_version == active_.version);
+    for (size_t i = 0; i < incoming->rules.size(); ++i) {
+        Rule& rule = incoming->rules[i];
+        RuleHandle old = mapped ? incoming->previous[i] : active_.find(rule.id);
+        if (old >= active_.rules.size()) continue;
         
-        // 按优先级排序规则
-        sort_rules_by_priority();
+        const Rule& prev = active_.rules[old];
+        rule.last_fire = prev.last_fire;
+        rule.disabled = prev.disabled;
+        if (rule.condition == prev.condition) {
+            rule.cached_result = prev.cached_result;
+            rule.cache_valid = prev.cache_valid;
+        }
     }
+    
+    swap(active_, *incoming);
+    delete retired_.exchange(incoming, memory_order_acq_rel);
+    
+    // 规则组的启用状态和冲突处理策略不跨加载保留，策略以新配置为准
+    group_manager_ = RuleGroupManager();
+    for (const auto& item : active_.group_policies) {
+        group_manager_.setGroupPolicy(item.first, item.second);
+    }
+    ready_dirty_ = true;
 }
 
 void Engine::onSensorUpdate() {
@@ -34,34 +267,363 @@ void Engine::onSensorUpdate() {
 }
 
 void Engine::tick(Context& ctx) {
-    auto now = now_ms();
-    for (auto& rule : rules_) {
-        if (!rule.shouldExecute(now)) continue;
-        
-        // 检查规则组状态
+    // 本次tick的节流计时和时间函数共用一个时钟快照
+    ClockSnapshot clock = ClockSnapshot::now();
+    auto now = clock.steady_ms;
+    ctx.setClock(clock);
+    installPendingRules();
+    
+    // 合并上次tick之后异步动作写入的值
+    if (executor_ && executor_->hasWrites()) {
+        executor_->takeWrites(async_writes_);
+        for (const auto& write : async_writes_) {
+            ctx.setSlot(write.slot, write.value);
+        }
+        async_writes_.clear();
+    }
+    
+    if (!active_.history_windows.empty()) {
+        prepareHistory(ctx);
+    }
+    
+    // 根据Context的版本号判断哪些规则需要重新评估
+    if (!incremental_ || ctx.uid() != last_ctx_uid_ || ctx.resetVersion() > last_ctx_version_) {
+        invalidateAllRules();
+    } else if (ctx.version() != last_ctx_version_) {
+        invalidateChangedRules(ctx, last_ctx_version_);
+    }
+    last_ctx_uid_ = ctx.uid();
+    last_ctx_version_ = ctx.version();
+    
+    if (ready_dirty_) {
+        rebuildReadyRules(now);
+    } else {
+        wakeRules(now);
+    }
+    // 规则组策略在tick中途变化时从下一次tick开始生效
+    bool limited = exclusive_groups_;
+    if (limited) {
+        group_left_ = group_limit_;
+    }
+    
+    beginProfiling();
+    if (adaptive_ordering_ || adaptive_version_) {
+        adaptConditions();
+    }
+    
+    // 并行模式：先在工作线程上评估条件，快照版本即当前Context版本
+    uint64_t snapshot_version = ctx.version();
+    bool prefetched = false;
+    if (pool_ && active_.rules.size() > PARALLEL_GRAIN) {
+        prefetchConditions(ctx);
+        prefetched = true;
+    }
+    
+    // 只遍历就绪的规则，节流中和已禁用的规则不参与
+    for (size_t word = 0; word < ready_.size(); ++word) {
+        uint64_t bits = ready_[word];
+        while (bits) {
+            uint32_t bit = __builtin_ctzll(bits);
+            bits &= bits - 1;
+            RuleHandle handle = active_.order[word * 64 + bit];
+            Rule& rule = active_.rules[handle];
+            
+            // 所在规则组本次tick已达到触发上限，不再评估
+            if (limited && group_left_[active_.rule_group[handle]] == 0) continue;
+            
+            // 检查条件（输入未变化时复用上次结果）
+            // 之前的动作修改了Context时预评估结果已过期，重新评估
+            if (prefetched && prefetched_[handle] && ctx.version() == snapshot_version) {
+                rule.cached_result = (prefetched_[handle] == 2);
+                rule.cache_valid = true;
+                evaluations_++;
+            } else if (!rule.cache_valid || rule.time_dependent) {
+                rule.cached_result = evalCondition(handle, ctx);
+                rule.cache_valid = true;
+                evaluations_++;
+            }
+            if (!rule.cached_result) continue;
+            
+            // 执行动作
+            runActions(rule, ctx);
+            
+            // 动作修改了Context时，后续规则需要看到新值
+            if (ctx.version() != last_ctx_version_) {
+                if (ctx.resetVersion() > last_ctx_version_) {
+                    invalidateAllRules();
+                } else {
+                    invalidateChangedRules(ctx, last_ctx_version_);
+                }
+                last_ctx_version_ = ctx.version();
+            }
+            
+            rule.updateLastFire(now);
+            sleepRule(handle, now);
+            if (limited) {
+                group_left_[active_.rule_group[handle]]--;
+            }
+            if (profiling_) {
+                profiler_.recordFire(profile_rules_[handle]);
+            }
+            
+            // 动作中启用/禁用了规则或规则组：重建后继续处理排在后面的规则
+            if (ready_dirty_) {
+                rebuildReadyRules(now);
+                bits = (bit == 63) ? 0 : ready_[word] & (~0ULL << (bit + 1));
+            }
+        }
+    }
+}
+
+void Engine::tick(SharedContext& shared) {
+    {
+        SharedContext::Snapshot snapshot = shared.snapshot();
+        snapshot.syncTo(shared_work_, shared_synced_);
+    }
+    
+    uint64_t before = shared_work_.version();
+    tick(shared_work_);
+    shared.merge(shared_work_, before, shared_synced_);
+}
+
+void Engine::tick_batch(ContextBatch& batch) {
+    ClockSnapshot clock = ClockSnapshot::now();
+    auto now = clock.steady_ms;
+    size_t devices = batch.size();
+    if (devices == 0) return;
+    for (size_t d = 0; d < devices; ++d) {
+        batch.mutableRow(d).setClock(clock);
+    }
+    installPendingRules();
+    
+    // 合并上次tick之后异步动作写入的值
+    if (executor_ && executor_->hasWrites()) {
+        executor_->takeWrites(async_writes_);
+        for (const auto& write : async_writes_) {
+            if (write.device < devices) {
+                batch.setSlot(write.device, write.slot, write.value);
+            }
+        }
+        async_writes_.clear();
+    }
+    
+    if (batch.rule_set_version_ != active_.version) {
+        vector<string> ids;
+        ids.reserve(active_.rules.size());
+        for (const auto& rule : active_.rules) {
+            ids.push_back(rule.id);
+        }
+        batch.bindRules(active_.version, ids);
+    }
+    if (ready_dirty_) {
+        rebuildGroupLimits();
+    }
+    if (exclusive_groups_) {
+        batch_group_left_.resize(group_limit_.size() * devices);
+        for (size_t g = 0; g < group_limit_.size(); ++g) {
+            fill_n(batch_group_left_.begin() + g * devices, devices, group_limit_[g]);
+        }
+    }
+    beginProfiling();
+    
+    for (RuleHandle r : active_.order) {
+        const Rule& rule = active_.rules[r];
+        if (rule.disabled || !rule.condition) continue;
         if (!group_manager_.shouldExecuteRule(rule)) continue;
         
-        // 检查条件
-        if (!rule.condition || !rule.condition->eval(ctx)) continue;
+        // 按设备检查节流和ONCE状态
+        vector<uint64_t>& last_fire = batch.last_fire_[r];
+        vector<uint8_t>& done = batch.done_[r];
+        uint32_t* group_left = exclusive_groups_ ? &batch_group_left_[active_.rule_group[r] * devices] : nullptr;
+        batch_active_.resize(devices);
+        bool any_active = false;
+        for (size_t d = 0; d < devices; ++d) {
+            batch_active_[d] = !done[d] && !(now - last_fire[d] < rule.throttle_ms) &&
+                               !(group_left && group_left[d] == 0);
+            any_active = any_active || batch_active_[d];
+        }
+        if (!any_active) continue;
         
-        // 执行动作
-        for (auto& step : rule.actions) {
-            auto it = actions_.find(step.name);
-            if (it != actions_.end()) {
-                try {
-                    it->second(step.params, ctx);
-                } catch (const exception& e) {
-                    cerr << "Error executing action " << step.name << " in rule " << rule.id << ": " << e.what() << endl;
-                }
-            } else {
-                cerr << "Unknown action: " << step.name << " in rule " << rule.id << endl;
+        uint64_t start = profiling_ ? Profiler::now_ns() : 0;
+        batch_evaluator_.eval(*rule.condition, batch, batch_active_, batch_match_);
+        size_t evaluated = count(batch_active_.begin(), batch_active_.end(), 1);
+        evaluations_ += evaluated;
+        if (profiling_) {
+            profiler_.recordEval(profile_rules_[r], Profiler::now_ns() - start, evaluated);
+        }
+        
+        // 在匹配设备的行视图上执行动作，写入的值同步回数据列，后续规则可见
+        for (size_t d = 0; d < devices; ++d) {
+            if (!batch_active_[d] || !batch_match_[d]) continue;
+            
+            Context& row = batch.mutableRow(d);
+            uint64_t before = row.version();
+            runActions(rule, row, d);
+            if (row.version() != before) {
+                batch.syncRow(d, before);
+            }
+            
+            last_fire[d] = now;
+            if (rule.mode == ONCE) {
+                done[d] = 1;
             }
+            if (group_left) {
+                group_left[d]--;
+            }
+            if (profiling_) {
+                profiler_.recordFire(profile_rules_[r]);
+            }
+        }
+    }
+}
+
+void Engine::runActions(const Rule& rule, Context& ctx, size_t device) {
+    for (auto& step : rule.actions) {
+        // 未注册的动作已在加载时报告
+        const shared_ptr<ActionBinding>& binding = step.slot->binding;
+        if (!binding) continue;
+
+        if (!binding->options.async || !executor_) {
+            runInline(*binding, step, rule, ctx);
+            continue;
+        }
+        
+        // 任务持有规则原型，规则集被替换后动作步骤仍然有效
+        if (!rule.source) {
+            runInline(*binding, step, rule, ctx);
+            continue;
+        }
+        
+        // 同一版本的Context只拍一次快照，不含历史记录
+        if (!action_snapshot_ || action_snapshot_uid_ != ctx.uid() || action_snapshot_version_ != ctx.version()) {
+            auto snapshot = make_shared<Context>();
+            snapshot->copyValues(ctx);
+            action_snapshot_ = move(snapshot);
+            action_snapshot_uid_ = ctx.uid();
+            action_snapshot_version_ = ctx.version();
+        }
+        
+        ActionExecutor::Task task;
+        task.binding = binding;
+        task.rule = rule.source;
+        task.step = &rule.source->actions[&step - rule.actions.data()];
+        task.rule_id = rule.id;
+        task.snapshot = action_snapshot_;
+        task.device = device;
+        if (executor_->submit(move(task)) == ActionExecutor::REJECTED) {
+            runInline(*binding, step, rule, ctx);
+        }
+    }
+}
+
+void Engine::runInline(const ActionBinding& binding, const ActionStep& step, const Rule& rule, Context& ctx) {
+    uint64_t start = profiling_ ? Profiler::now_ns() : 0;
+    try {
+        binding.fn(step.params, ctx);
+    } catch (const exception& e) {
+        cerr << "Error executing action " << step.name << " in rule " << rule.id << ": " << e.what() << endl;
+    }
+    if (profiling_) {
+        profiler_.recordAction(binding.profile_id, Profiler::now_ns() - start);
+    }
+}
+
+bool Engine::evalCondition(RuleHandle handle, const Context& ctx) {
+    if (!profiling_) {
+        return active_.rules[handle].condition->eval(ctx);
+    }
+    uint64_t start = Profiler::now_ns();
+    bool result = active_.rules[handle].condition->eval(ctx);
+    profiler_.recordEval(profile_rules_[handle], Profiler::now_ns() - start);
+    return result;
+}
+
+void Engine::beginProfiling() {
+    profiling_ = profiler_.enabled();
+    if (!profiling_ || profile_version_ == active_.version) return;
+    
+    profile_rules_.resize(active_.rules.size());
+    for (size_t i = 0; i < active_.rules.size(); ++i) {
+        profile_rules_[i] = profiler_.ruleId(active_.rules[i].id);
+    }
+    profile_version_ = active_.version;
+}
+
+bool Engine::isRuleActive(const Rule& rule, uint64_t now) const {
+    if (!rule.shouldExecute(now)) return false;
+    
+    // 检查规则组状态
+    if (!group_manager_.shouldExecuteRule(rule)) return false;
+    
+    return rule.condition != nullptr;
+}
+
+void Engine::rebuildReadyRules(uint64_t now) {
+    ready_.assign((active_.order.size() + 63) / 64, 0);
+    wakeups_.clear();
+    for (uint32_t position = 0; position < active_.order.size(); ++position) {
+        RuleHandle handle = active_.order[position];
+        const Rule& rule = active_.rules[handle];
+        if (isRuleActive(rule, now)) {
+            ready_[position >> 6] |= 1ULL << (position & 63);
+        } else if (!rule.disabled && rule.condition && group_manager_.shouldExecuteRule(rule)) {
+            wakeups_.emplace_back(rule.last_fire + rule.throttle_ms, handle);
+        }
+    }
+    make_heap(wakeups_.begin(), wakeups_.end(), greater<pair<uint64_t, RuleHandle>>());
+    rebuildGroupLimits();
+    ready_dirty_ = false;
+}
+
+void Engine::rebuildGroupLimits() {
+    // 最后一项对应不属于任何组的规则，始终不限
+    group_limit_.assign(active_.group_names.size() + 1, UINT32_MAX);
+    exclusive_groups_ = false;
+    for (size_t g = 0; g < active_.group_names.size(); ++g) {
+        uint32_t limit = group_manager_.getGroupPolicy(active_.group_names[g]).maxFires();
+        if (limit > 0) {
+            group_limit_[g] = limit;
+            exclusive_groups_ = true;
         }
+    }
+}
+
+void Engine::wakeRules(uint64_t now) {
+    while (!wakeups_.empty() && wakeups_.front().first <= now) {
+        RuleHandle handle = wakeups_.front().second;
+        pop_heap(wakeups_.begin(), wakeups_.end(), greater<pair<uint64_t, RuleHandle>>());
+        wakeups_.pop_back();
         
-        rule.updateLastFire(now);
+        uint32_t position = active_.order_position[handle];
+        ready_[position >> 6] |= 1ULL << (position & 63);
     }
 }
 
+void Engine::sleepRule(RuleHandle handle, uint64_t now) {
+    const Rule& rule = active_.rules[handle];
+    if (!rule.disabled && rule.throttle_ms == 0) return;
+    
+    uint32_t position = active_.order_position[handle];
+    ready_[position >> 6] &= ~(1ULL << (position & 63));
+    if (!rule.disabled) {
+        wakeups_.emplace_back(now + rule.throttle_ms, handle);
+        push_heap(wakeups_.begin(), wakeups_.end(), greater<pair<uint64_t, RuleHandle>>());
+    }
+}
+
+void Engine::prefetchConditions(const Context& ctx) {
+    prefetched_.assign(active_.rules.size(), 0);
+    pool_->parallelFor(active_.rules.size(), PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (!isReady(active_.order_position[i])) continue;
+            if (exclusive_groups_ && group_limit_[active_.rule_group[i]] != UINT32_MAX) continue;
+            const Rule& rule = active_.rules[i];
+            if (rule.cache_valid && !rule.time_dependent) continue;
+            prefetched_[i] = evalCondition(static_cast<RuleHandle>(i), ctx) ? 2 : 1;
+        }
+    });
+}
+
 uint64_t Engine::now_ms() {
     return chrono::duration_cast<chrono::milliseconds>(
         chrono::steady_clock::now().time_since_epoch()
@@ -69,62 +631,238 @@ uint64_t Engine::now_ms() {
 }
 
 void Engine::sort_rules_by_priority() {
-    PriorityManager::sortRules(rules_);
+    active_.sortByPriority();
+    ready_dirty_ = true;
 }
 
 void Engine::set_rule_priority(const string& rule_id, int priority) {
-    PriorityManager::setRulePriority(rules_, rule_id, priority);
+    set_rule_priority(find_rule(rule_id), priority);
+}
+
+void Engine::set_rule_priority(RuleHandle handle, int priority) {
+    if (handle >= active_.rules.size()) return;
+    Rule& rule = active_.rules[handle];
+    rule.priority = PriorityManager::normalizePriority(priority);
+    PriorityManager::reorder(active_.rules, active_.order, active_.order_position, handle);
+    ready_dirty_ = true;
+    
+    // 只重排该规则所在的组
+    if (!rule.group.empty()) {
+        vector<RuleHandle>& members = active_.group_rules[rule.group];
+        sort(members.begin(), members.end(), [this](RuleHandle a, RuleHandle b) {
+            return active_.order_position[a] < active_.order_position[b];
+        });
+    }
 }
 
 void Engine::enable_rule_group(const string& group_name) {
     group_manager_.enableGroup(group_name);
+    ready_dirty_ = true;
 }
 
 void Engine::disable_rule_group(const string& group_name) {
     group_manager_.disableGroup(group_name);
+    ready_dirty_ = true;
+}
+
+void Engine::set_rule_group_mode(const string& group_name, GroupMode mode, uint32_t limit) {
+    group_manager_.setGroupPolicy(group_name, GroupPolicy(mode, limit));
+    ready_dirty_ = true;
+}
+
+GroupPolicy Engine::get_rule_group_mode(const string& group_name) const {
+    return group_manager_.getGroupPolicy(group_name);
 }
 
 void Engine::enable_rule(const string& rule_id) {
-    for (auto& rule : rules_) {
-        if (rule.id == rule_id) {
-            rule.enable();
-            return;
-        }
-    }
+    enable_rule(find_rule(rule_id));
 }
 
 void Engine::disable_rule(const string& rule_id) {
-    for (auto& rule : rules_) {
-        if (rule.id == rule_id) {
-            rule.disable();
-            return;
-        }
+    disable_rule(find_rule(rule_id));
+}
+
+void Engine::enable_rule(RuleHandle handle) {
+    if (handle < active_.rules.size()) {
+        active_.rules[handle].enable();
+        ready_dirty_ = true;
+    }
+}
+
+void Engine::disable_rule(RuleHandle handle) {
+    if (handle < active_.rules.size()) {
+        active_.rules[handle].disable();
+        ready_dirty_ = true;
     }
 }
 
-vector<Rule> Engine::get_rules_by_group(const string& group_name) const {
-    return group_manager_.getRulesByGroup(rules_, group_name);
+RuleView Engine::get_rules_by_group(const string& group_name) const {
+    auto it = active_.group_rules.find(group_name);
+    if (it == active_.group_rules.end()) return RuleView();
+    const vector<RuleHandle>& members = it->second;
+    return RuleView(active_.rules.data(), members.data(), members.data() + members.size());
 }
 
 Rule* Engine::get_rule_by_id(const string& rule_id) {
-    for (auto& rule : rules_) {
-        if (rule.id == rule_id) {
-            return &rule;
-        }
-    }
-    return nullptr;
+    return get_rule(find_rule(rule_id));
+}
+
+RuleView Engine::get_all_rules() const {
+    return RuleView(active_.rules.data(), active_.order.data(), active_.order.data() + active_.order.size());
+}
+
+RuleHandle Engine::find_rule(const string& rule_id) const {
+    return active_.find(rule_id);
 }
 
-vector<Rule> Engine::get_all_rules() const {
-    return rules_;
+Rule* Engine::get_rule(RuleHandle handle) {
+    return (handle < active_.rules.size()) ? &active_.rules[handle] : nullptr;
 }
 
 size_t Engine::get_rule_count() const {
-    return rules_.size();
+    return active_.rules.size();
+}
+
+uint64_t Engine::get_evaluation_count() const {
+    return evaluations_;
 }
 
 void Engine::clear_rules() {
-    rules_.clear();
+    wait_for_load();
+    delete pending_.exchange(nullptr);
+    active_.clear();
+    active_.version = ++g_rule_set_version;
+    ready_dirty_ = true;
+    
+    lock_guard<mutex> lock(build_mutex_);
+    network_.clear();
+    expression_cache_.clear();
+    prototypes_.clear();
+    built_ids_.clear();
+    built_version_ = active_.version;
+}
+
+json Engine::get_predicate_stats() const {
+    lock_guard<mutex> lock(build_mutex_);
+    json stats = network_.getStats();
+    stats["cached_expressions"] = expression_cache_.size();
+    stats["expression_cache_hits"] = expression_cache_.hits();
+    return stats;
+}
+
+void Engine::set_incremental(bool enabled) {
+    incremental_ = enabled;
+    invalidateAllRules();
+}
+
+bool Engine::is_incremental() const {
+    return incremental_;
+}
+
+void Engine::prepareHistory(Context& ctx) {
+    // 赋值或clear()会替换Context的历史记录，检查第一个槽位是否仍已注册
+    const auto& windows = active_.history_windows;
+    if (ctx.uid() == history_ctx_uid_ && active_.version == history_version_ && ctx.history(windows[0].first)) {
+        return;
+    }
+    for (const auto& window : windows) {
+        ctx.trackHistory(window.first, window.second);
+    }
+    history_ctx_uid_ = ctx.uid();
+    history_version_ = active_.version;
+}
+
+void Engine::set_adaptive_ordering(bool enabled) {
+    adaptive_ordering_ = enabled;
+}
+
+bool Engine::is_adaptive_ordering() const {
+    return adaptive_ordering_;
+}
+
+void Engine::adaptConditions() {
+    // 关闭或规则集变化：旧条件恢复配置顺序（被新规则集复用的条件随后重新开启）
+    if (!adaptive_ordering_ || adaptive_version_ != active_.version) {
+        for (const auto& cond : adaptive_conditions_) {
+            cond->setAdaptive(false);
+        }
+        adaptive_conditions_.clear();
+        adaptive_version_ = 0;
+        adaptive_ticks_ = 0;
+        if (!adaptive_ordering_) return;
+    }
+    
+    if (adaptive_version_ == 0) {
+        // 收集规则集中的复合条件，共享节点只收集一次
+        unordered_set<const Condition*> visited;
+        vector<shared_ptr<Condition>> stack;
+        for (const Rule& rule : active_.rules) {
+            if (rule.condition) stack.push_back(rule.condition);
+        }
+        while (!stack.empty()) {
+            shared_ptr<Condition> cond = move(stack.back());
+            stack.pop_back();
+            if (!visited.insert(cond.get()).second) continue;
+            for (const auto& child : cond->all.empty() ? cond->any : cond->all) {
+                if (child) stack.push_back(child);
+            }
+            if (cond->setAdaptive(true)) {
+                adaptive_conditions_.push_back(cond);
+            }
+        }
+        adaptive_version_ = active_.version;
+    }
+    
+    if (++adaptive_ticks_ % ADAPT_INTERVAL == 0) {
+        for (const auto& cond : adaptive_conditions_) {
+            cond->reorder();
+        }
+    }
+}
+
+void Engine::set_thread_count(size_t threads) {
+    if (threads <= 1) {
+        pool_.reset();
+    } else if (!pool_ || pool_->size() != threads) {
+        pool_.reset(new WorkerPool(threads));
+    }
+}
+
+size_t Engine::get_thread_count() const {
+    return pool_ ? pool_->size() : 1;
+}
+
+void Engine::set_profiling(bool enabled) {
+    profiler_.setEnabled(enabled);
+}
+
+bool Engine::is_profiling() const {
+    return profiler_.enabled();
+}
+
+json Engine::get_profile() const {
+    return profiler_.collect();
+}
+
+bool Engine::dump_profile(const string& path) const {
+    return profiler_.dumpPrometheus(path);
+}
+
+void Engine::invalidateChangedRules(const Context& ctx, uint64_t since) {
+    changed_slots_.clear();
+    ctx.changedSince(since, changed_slots_);
+    for (SlotId slot : changed_slots_) {
+        if (slot >= active_.slot_rules.size()) continue;
+        for (RuleHandle handle : active_.slot_rules[slot]) {
+            active_.rules[handle].cache_valid = false;
+        }
+    }
+}
+
+void Engine::invalidateAllRules() {
+    for (auto& rule : active_.rules) {
+        rule.cache_valid = false;
+    }
 }
 
 void Engine::parseRule(const json& ruleJson, Rule& rule) {
@@ -141,6 +879,7 @@ void Engine::parseRule(const json& ruleJson, Rule& rule) {
             ActionStep step;
             step.name = actionJson.value("action", "");
             step.params = actionJson.value("params", json::object());
+            step.slot = bindAction(step.name);
             rule.actions.push_back(step);
         }
     }
@@ -165,7 +904,17 @@ void Engine::parseCondition(const json& whenJson, shared_ptr<Condition>& conditi
     if (whenJson.contains("expression")) {
         // 使用表达式条件
         condition->use_expression = true;
-        condition->expression = ExpressionParser::parse(whenJson["expression"]);
+        const json& exprJson = whenJson["expression"];
+        if (exprJson.is_string()) {
+            // 文本表达式：相同文本只解析一次
+            string error;
+            condition->expression = expression_cache_.get(exprJson.get_ref<const string&>(), &error);
+            if (!condition->expression) {
+                cerr << "Invalid expression \"" << exprJson.get_ref<const string&>() << "\": " << error << endl;
+            }
+        } else {
+            condition->expression = ExpressionParser::parseTree(exprJson);
+        }
     } else if (whenJson.contains("all") && whenJson["all"].is_array()) {
         for (const auto& condJson : whenJson["all"]) {
             shared_ptr<Condition> subCond = make_shared<Condition>();
@@ -180,7 +929,9 @@ void Engine::parseCondition(const json& whenJson, shared_ptr<Condition>& conditi
         }
     } else if (whenJson.contains("left")) {
         condition->left = whenJson.value("left", "");
+        condition->left_slot = SymbolTable::global().intern(condition->left);
         condition->op = whenJson.value("op", "");
         condition->right = whenJson["right"];
+        condition->right_value = Scalar::fromJson(condition->right);
     }
 }
@@ -1,59 +1,279 @@
 #pragma once
 
 #include "context.h"
+#include "context_batch.h"
+#include "shared_context.h"
+#include "action_executor.h"
+#include "worker_pool.h"
+#include "profiler.h"
 #include "rule.h"
+#include "rule_set.h"
 #include "../condition/condition_evaluator.h"
+#include "../condition/predicate_network.h"
+#include "../condition/batch_evaluator.h"
 #include "../priority/priority_manager.h"
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <functional>
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 using namespace std;
 
 // 规则引擎
 class Engine {
 public:
-    // 注册动作函数
+    Engine();
+    ~Engine();
+    
+    // 注册动作函数（可在加载规则之后注册，已加载规则中的同名动作步骤随之生效）
+    // 不要与tick并发调用
     void register_action(const string& name, ActionFn fn);
     
-    // 加载规则配置
+    // 注册动作函数并指定执行选项（异步、顺序保证、队列满时的策略）
+    void register_action(const string& name, ActionFn fn, const ActionOptions& options);
+    
+    // 设置异步动作的工作线程数和每个线程的队列容量（0表示不启用，异步动作同步执行）
+    void set_action_workers(size_t threads, size_t queue_capacity = 1024);
+    
+    // 等待所有已提交的异步动作执行完成
+    void flush_actions();
+    
+    // 获取动作执行统计：队列深度、每个异步动作的执行次数和延迟
+    json get_action_stats() const;
+    
+    // 加载规则配置：构建新规则集后立即替换当前规则集
+    // 同ID规则的运行状态（上次触发时间、禁用状态）保留，内容未变化的规则直接复用不重新解析
+    // 规则组的启用/禁用状态和接口设置的冲突处理策略在替换时重置
     void load(const json& cfg);
     
+    // 在后台线程加载规则配置，构建完成后由下一次tick原子地替换当前规则集
+    // tick不等待构建；构建完成前多次调用时只有最后一次的规则集生效
+    void load_async(const json& cfg);
+    
+    // 等待后台加载构建完成（新规则集在下一次tick生效）
+    void wait_for_load();
+    
     // 传感器数据更新
     void onSensorUpdate();
     
     // 执行规则检查
     void tick(Context& ctx);
     
+    // 对共享Context执行规则检查：无锁获取快照并同步到引擎内部的工作Context，
+    // 动作写入的值在tick结束后发布回共享Context
+    void tick(SharedContext& shared);
+    
+    // 对一组设备执行规则检查：同一套规则按优先级逐条对所有设备批量评估，
+    // 每个设备的结果与用独立Context调用tick相同（节流、ONCE状态按设备分别记录）
+    void tick_batch(ContextBatch& batch);
+    
     // 获取当前时间（毫秒）
     static uint64_t now_ms();
     
     // 规则优先级管理
+    // 规则的启用状态、优先级和规则组应通过以下接口修改，直接修改Rule字段不会更新就绪规则集
     void sort_rules_by_priority();
     void set_rule_priority(const string& rule_id, int priority);
+    void set_rule_priority(RuleHandle handle, int priority);
     void enable_rule_group(const string& group_name);
     void disable_rule_group(const string& group_name);
+    
+    // 规则组冲突处理：GROUP_FIRST_MATCH每次tick只触发组内优先级最高的一条条件成立的规则，
+    // GROUP_HIGHEST_N最多触发N条；达到上限后组内其余规则本次tick不再评估
+    // 也可在配置中指定："groups": {"组名": {"mode": "first_match"}}，重新加载时以配置为准
+    void set_rule_group_mode(const string& group_name, GroupMode mode, uint32_t limit = 1);
+    GroupPolicy get_rule_group_mode(const string& group_name) const;
     void enable_rule(const string& rule_id);
     void disable_rule(const string& rule_id);
+    void enable_rule(RuleHandle handle);
+    void disable_rule(RuleHandle handle);
     
-    // 规则查询
-    vector<Rule> get_rules_by_group(const string& group_name) const;
+    // 规则查询（视图按优先级排列，引用引擎内的规则，不拷贝）
+    RuleView get_rules_by_group(const string& group_name) const;
     Rule* get_rule_by_id(const string& rule_id);
-    vector<Rule> get_all_rules() const;
+    RuleView get_all_rules() const;
+    
+    // 规则句柄：加载后保持不变，可代替规则ID避免每次查找
+    RuleHandle find_rule(const string& rule_id) const;
+    Rule* get_rule(RuleHandle handle);
     
     // 获取规则数量
     size_t get_rule_count() const;
     
+    // 累计实际评估的规则条件次数（复用缓存结果的不计，批量评估按设备计）
+    uint64_t get_evaluation_count() const;
+    
     // 清空所有规则
     void clear_rules();
     
+    // 获取谓词网络统计（共享条件节点数、表达式文本缓存大小等）
+    json get_predicate_stats() const;
+    
+    // 增量评估开关（默认开启）：只重新评估输入发生变化的规则
+    void set_incremental(bool enabled);
+    bool is_incremental() const;
+    
+    // 自适应条件排序（默认关闭）：统计all/any中每个子条件的耗时和决定结果的频率，
+    // 每ADAPT_INTERVAL次tick把廉价且经常决定结果的子条件调到前面；条件没有副作用，结果不变
+    // 关闭时恢复配置顺序；开关在下一次tick生效
+    void set_adaptive_ordering(bool enabled);
+    bool is_adaptive_ordering() const;
+    
+    // 条件评估线程数（含调用线程，默认1即单线程）
+    // 大于1时条件在工作线程上并行评估，动作仍按优先级顺序在调用线程执行，结果与单线程一致
+    void set_thread_count(size_t threads);
+    size_t get_thread_count() const;
+    
+    // 性能剖析（默认关闭）：记录每条规则的条件评估耗时和触发次数、每个动作的耗时直方图
+    // 关闭时tick只多一次开关检查；计数按规则ID和动作名称累计，重新加载规则后延续
+    void set_profiling(bool enabled);
+    bool is_profiling() const;
+    
+    // 获取剖析结果（可在任意线程调用）
+    json get_profile() const;
+    
+    // 以Prometheus文本格式写入文件（可供node_exporter等采集）
+    bool dump_profile(const string& path) const;
+    
 private:
-    vector<Rule> rules_;
-    unordered_map<string, ActionFn> actions_;
+    RuleSet active_;                        // 当前生效的规则集，只在tick线程上访问
     RuleGroupManager group_manager_;
     
+    // 规则集构建状态（由build_mutex_保护，可在任意线程构建）
+    mutable mutex build_mutex_;
+    PredicateNetwork network_;              // 规则间共享的条件节点，多次加载之间复用
+    ExpressionCache expression_cache_;      // 表达式文本 -> 已解析的表达式，相同文本只解析一次
+    unordered_map<string, shared_ptr<const Rule>> prototypes_;  // 规则配置文本 -> 解析得到的规则原型
+    unordered_map<string, RuleHandle> built_ids_;   // 最近构建的规则集的规则ID -> 句柄
+    uint64_t built_version_;                // 最近构建的规则集的版本号
+    unordered_map<string, shared_ptr<ActionSlot>> actions_;    // 动作名称 -> 槽位
+    thread loader_;                         // 后台加载线程
+    
+    // 规则集交换：构建线程发布到pending_，tick开始时取出替换active_；
+    // 替换下来的规则集放入retired_，由下一次构建释放，tick不做大块内存释放
+    atomic<RuleSet*> pending_;
+    atomic<RuleSet*> retired_;
+    
+    // 增量评估状态
+    bool incremental_;
+    uint64_t last_ctx_uid_;                 // 上次tick的Context实例
+    uint64_t last_ctx_version_;             // 上次tick结束时已处理到的版本
+    vector<SlotId> changed_slots_;          // 变化槽位缓冲区
+    uint64_t evaluations_;                  // 累计评估次数
+    
+    // 共享Context的工作副本
+    Context shared_work_;
+    uint64_t shared_synced_;                // 工作副本已同步到的快照版本
+    
+    // 批量评估状态
+    BatchEvaluator batch_evaluator_;
+    vector<uint8_t> batch_active_;          // 本条规则需要检查的设备
+    vector<uint8_t> batch_match_;           // 本条规则条件成立的设备
+    
+    // 并行评估状态
+    static constexpr size_t PARALLEL_GRAIN = 256;   // 每个分片的规则数，规则数不超过该值时不并行
+    unique_ptr<WorkerPool> pool_;
+    vector<uint8_t> prefetched_;            // 按句柄的并行预评估结果：0未评估，1为假，2为真
+    
+    // 在工作线程上预评估需要重新计算的规则条件，评估期间Context只读
+    // 限制触发数的规则组（first_match/highest_n）中的规则留给主循环按顺序评估，达到上限后不再评估
+    void prefetchConditions(const Context& ctx);
+    
+    // 规则本次tick是否需要检查条件
+    bool isRuleActive(const Rule& rule, uint64_t now) const;
+    
+    // 就绪规则集：tick只遍历可以执行的规则
+    // 节流中的规则按可再次执行的时间放入最小堆，到期前不再检查；已禁用的规则和所在组已禁用的规则不在集合中
+    vector<uint64_t> ready_;                // 按执行顺序位置的位图
+    vector<pair<uint64_t, RuleHandle>> wakeups_;    // (可再次执行的时间, 句柄) 最小堆
+    bool ready_dirty_;                      // 规则集、优先级、启用状态或规则组变化后需要重建
+    
+    // 重建就绪规则集和唤醒堆
+    void rebuildReadyRules(uint64_t now);
+    
+    // 把节流到期的规则放回就绪规则集
+    void wakeRules(uint64_t now);
+    
+    // 规则触发后不能立即再次执行时移出就绪规则集
+    void sleepRule(RuleHandle handle, uint64_t now);
+    
+    bool isReady(uint32_t position) const {
+        return (ready_[position >> 6] >> (position & 63)) & 1;
+    }
+    
+    // 规则组触发上限：按规则组编号，最后一项对应不属于任何组的规则；不限时为UINT32_MAX
+    vector<uint32_t> group_limit_;          // 随就绪规则集一起重建
+    vector<uint32_t> group_left_;           // 本次tick各组还能触发的规则数
+    vector<uint32_t> batch_group_left_;     // 批量评估时按(规则组, 设备)计
+    bool exclusive_groups_;                 // 是否有限制触发数的规则组
+    
+    // 根据规则组策略重建触发上限
+    void rebuildGroupLimits();
+    
+    // 历史记录注册状态：Context实例或规则集变化后重新注册
+    uint64_t history_ctx_uid_;
+    uint64_t history_version_;
+    
+    // 在Context上注册当前规则集引用的历史窗口
+    void prepareHistory(Context& ctx);
+    
+    // 自适应条件排序状态
+    static constexpr uint64_t ADAPT_INTERVAL = 1024;    // 重排间隔（tick数）
+    bool adaptive_ordering_;
+    uint64_t adaptive_version_;             // adaptive_conditions_对应的规则集版本，0表示未收集
+    uint64_t adaptive_ticks_;
+    vector<shared_ptr<Condition>> adaptive_conditions_;    // 开启统计的复合条件（去重），规则集替换后仍持有
+    
+    // 规则集变化时重新收集复合条件，定期重排（tick线程调用，预评估之前）
+    void adaptConditions();
+    
+    // 性能剖析状态（声明在executor_之前，执行器的工作线程会写入）
+    Profiler profiler_;
+    vector<uint32_t> profile_rules_;        // 句柄 -> 规则在Profiler中的编号
+    uint64_t profile_version_;              // profile_rules_对应的规则集版本
+    bool profiling_;                        // 本次tick是否记录（tick开始时读取开关）
+    
+    // 读取剖析开关，开启时为当前规则集分配Profiler编号
+    void beginProfiling();
+    
+    // 异步动作执行
+    unique_ptr<ActionExecutor> executor_;
+    shared_ptr<const Context> action_snapshot_;     // 最近一次分派异步动作时的Context快照
+    uint64_t action_snapshot_uid_;
+    uint64_t action_snapshot_version_;
+    vector<AsyncWrite> async_writes_;       // 异步动作写入值的缓冲区
+    
+    // 按顺序执行规则的动作；异步动作提交给执行器
+    void runActions(const Rule& rule, Context& ctx, size_t device = SIZE_MAX);
+    
+    // 执行一个同步动作
+    void runInline(const ActionBinding& binding, const ActionStep& step, const Rule& rule, Context& ctx);
+    
+    // 评估规则条件，开启剖析时记录耗时
+    bool evalCondition(RuleHandle handle, const Context& ctx);
+    
+    // 获取动作槽位，不存在时创建（调用方持有build_mutex_）
+    const shared_ptr<ActionSlot>& bindAction(const string& name);
+    
+    // 根据配置构建完整的规则集（持有build_mutex_）
+    RuleSet* buildRuleSet(const json& cfg);
+    
+    // 发布构建好的规则集，替换尚未生效的上一个
+    void publishRuleSet(RuleSet* incoming);
+    
+    // 替换为已发布的规则集（tick线程调用），迁移同ID规则的运行状态
+    void installPendingRules();
+    
+    // 使读取了since之后变化槽位的规则缓存失效
+    void invalidateChangedRules(const Context& ctx, uint64_t since);
+    
+    // 使所有规则缓存失效
+    void invalidateAllRules();
+    
     // 解析规则配置
     void parseRule(const json& ruleJson, Rule& rule);
     void parseCondition(const json& whenJson, shared_ptr<Condition>& condition);
@@ -0,0 +1,185 @@
+#include "engine_loop.h"
+#include <chrono>
+#include <algorithm>
+
+// EngineLoop 实现
+EngineLoop::EngineLoop(Engine& engine, Context& ctx)
+    : engine_(engine), ctx_(ctx), dirty_(false), stop_(false), reconfigured_(false), first_pending_us_(0),
+      min_interval_us_(0), fallback_interval_ms_(100),
+      ticks_(0), event_ticks_(0), timer_ticks_(0), updates_(0),
+      last_latency_us_(0), max_latency_us_(0), total_latency_us_(0) {
+}
+
+EngineLoop::~EngineLoop() {
+    stop();
+}
+
+void EngineLoop::set_min_interval_us(uint64_t interval_us) {
+    lock_guard<mutex> lock(mutex_);
+    min_interval_us_ = interval_us;
+    reconfigured_ = true;
+    cv_.notify_one();
+}
+
+void EngineLoop::set_fallback_interval_ms(uint64_t interval_ms) {
+    lock_guard<mutex> lock(mutex_);
+    fallback_interval_ms_ = interval_ms;
+    reconfigured_ = true;
+    cv_.notify_one();
+}
+
+void EngineLoop::start() {
+    if (thread_.joinable()) return;
+    {
+        lock_guard<mutex> lock(mutex_);
+        stop_ = false;
+    }
+    thread_ = thread(&EngineLoop::run, this);
+}
+
+void EngineLoop::stop() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool EngineLoop::running() const {
+    return thread_.joinable();
+}
+
+void EngineLoop::update(const string& key, const Value& value) {
+    Update update;
+    update.slot = SymbolTable::global().intern(key);
+    update.value = value;
+    update.is_json = true;
+    push(move(update));
+}
+
+void EngineLoop::update(SlotId slot, const Scalar& value) {
+    Update update;
+    update.slot = slot;
+    update.scalar = value;
+    update.is_json = false;
+    push(move(update));
+}
+
+void EngineLoop::update(function<void(Context&)> fn) {
+    Update update;
+    update.slot = INVALID_SLOT;
+    update.is_json = false;
+    update.fn = move(fn);
+    push(move(update));
+}
+
+void EngineLoop::notify() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (!dirty_) first_pending_us_ = now_us();
+        dirty_ = true;
+    }
+    cv_.notify_one();
+}
+
+json EngineLoop::getStats() const {
+    lock_guard<mutex> lock(mutex_);
+    json stats;
+    stats["ticks"] = ticks_;
+    stats["event_ticks"] = event_ticks_;
+    stats["timer_ticks"] = timer_ticks_;
+    stats["updates"] = updates_;
+    stats["coalesced_updates"] = updates_ > event_ticks_ ? updates_ - event_ticks_ : 0;
+    stats["last_latency_us"] = last_latency_us_;
+    stats["max_latency_us"] = max_latency_us_;
+    stats["avg_latency_us"] = event_ticks_ ? total_latency_us_ / event_ticks_ : 0;
+    return stats;
+}
+
+void EngineLoop::push(Update&& update) {
+    {
+        lock_guard<mutex> lock(mutex_);
+        if (!dirty_) first_pending_us_ = now_us();
+        pending_.push_back(move(update));
+        dirty_ = true;
+        updates_++;
+    }
+    cv_.notify_one();
+}
+
+void EngineLoop::run() {
+    uint64_t last_tick_us = 0;
+    unique_lock<mutex> lock(mutex_);
+    
+    while (!stop_) {
+        // 等待更新或定时tick；配置变化时按新配置重新等待
+        if (!dirty_) {
+            auto woken = [this] { return stop_ || dirty_ || reconfigured_; };
+            if (fallback_interval_ms_ > 0) {
+                auto deadline = chrono::steady_clock::now() + chrono::milliseconds(fallback_interval_ms_);
+                cv_.wait_until(lock, deadline, woken);
+            } else {
+                cv_.wait(lock, woken);
+            }
+            if (stop_) break;
+            if (reconfigured_ && !dirty_) {
+                reconfigured_ = false;
+                continue;
+            }
+        }
+        reconfigured_ = false;
+        
+        // 距上次tick不足最小间隔时继续等待，期间的更新合并到同一次tick
+        if (dirty_ && min_interval_us_ > 0) {
+            uint64_t earliest = last_tick_us + min_interval_us_;
+            uint64_t now = now_us();
+            if (now < earliest) {
+                cv_.wait_for(lock, chrono::microseconds(earliest - now), [this] { return stop_; });
+                if (stop_) break;
+            }
+        }
+        
+        bool by_event = dirty_;
+        uint64_t first_pending = first_pending_us_;
+        applying_.swap(pending_);
+        dirty_ = false;
+        lock.unlock();
+        
+        // 在运行线程上应用更新并tick
+        for (auto& update : applying_) {
+            if (update.fn) {
+                update.fn(ctx_);
+            } else if (update.is_json) {
+                ctx_.setSlot(update.slot, update.value);
+            } else {
+                ctx_.setSlot(update.slot, update.scalar);
+            }
+        }
+        applying_.clear();
+        
+        uint64_t start = now_us();
+        engine_.onSensorUpdate();
+        engine_.tick(ctx_);
+        last_tick_us = start;
+        
+        lock.lock();
+        ticks_++;
+        if (by_event) {
+            event_ticks_++;
+            last_latency_us_ = start - min(start, first_pending);
+            max_latency_us_ = max(max_latency_us_, last_latency_us_);
+            total_latency_us_ += last_latency_us_;
+        } else {
+            timer_ticks_++;
+        }
+    }
+}
+
+uint64_t EngineLoop::now_us() {
+    return chrono::duration_cast<chrono::microseconds>(
+        chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
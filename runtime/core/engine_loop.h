@@ -0,0 +1,86 @@
+#pragma once
+
+#include "engine.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+using namespace std;
+
+// 事件驱动的引擎运行循环，取代固定周期轮询
+// 传感器更新通过update写入待处理缓冲区并唤醒运行线程，运行线程合并更新后执行tick；
+// 两次tick之间至少间隔min_interval，期间到达的更新合并为一次tick；
+// 没有更新时按fallback_interval定时tick，保证依赖时间和节流的规则照常触发
+class EngineLoop {
+public:
+    EngineLoop(Engine& engine, Context& ctx);
+    ~EngineLoop();
+    
+    EngineLoop(const EngineLoop&) = delete;
+    EngineLoop& operator=(const EngineLoop&) = delete;
+    
+    // 两次tick的最小间隔（微秒，默认0即收到更新立即tick）
+    void set_min_interval_us(uint64_t interval_us);
+    
+    // 没有更新时的定时tick间隔（毫秒，默认100，0表示只在有更新时tick）
+    void set_fallback_interval_ms(uint64_t interval_ms);
+    
+    // 启动/停止运行线程
+    void start();
+    void stop();
+    bool running() const;
+    
+    // 更新传感器数据并唤醒运行线程（可在任意线程调用）
+    void update(const string& key, const Value& value);
+    void update(SlotId slot, const Scalar& value);
+    
+    // 在运行线程上修改Context（多个值一次提交）
+    void update(function<void(Context&)> fn);
+    
+    // 只唤醒运行线程立即tick
+    void notify();
+    
+    // 运行统计：tick次数、唤醒原因、合并的更新数、更新到tick开始的延迟
+    json getStats() const;
+    
+private:
+    // 待处理的更新
+    struct Update {
+        SlotId slot;
+        Scalar scalar;
+        Value value;
+        bool is_json;
+        function<void(Context&)> fn;
+    };
+    
+    Engine& engine_;
+    Context& ctx_;
+    thread thread_;
+    
+    mutable mutex mutex_;
+    condition_variable cv_;
+    vector<Update> pending_;        // 运行线程下一次tick前应用
+    vector<Update> applying_;       // 运行线程正在应用的更新（与pending_交换，复用内存）
+    bool dirty_;                    // 有未处理的更新或唤醒请求
+    bool stop_;
+    bool reconfigured_;             // 间隔设置已修改，运行线程需重新计算等待时间
+    uint64_t first_pending_us_;     // 最早一个未处理更新的时间
+    
+    uint64_t min_interval_us_;
+    uint64_t fallback_interval_ms_;
+    
+    // 统计
+    uint64_t ticks_;
+    uint64_t event_ticks_;
+    uint64_t timer_ticks_;
+    uint64_t updates_;
+    uint64_t last_latency_us_;
+    uint64_t max_latency_us_;
+    uint64_t total_latency_us_;
+    
+    void run();
+    void push(Update&& update);
+    static uint64_t now_us();
+};
@@ -0,0 +1,203 @@
+#include "history.h"
+#include <cmath>
+
+// HistoryBuffer 实现
+HistoryBuffer::HistoryBuffer() : mask_(0), count_(0) {
+    buffer_.resize(1);
+}
+
+void HistoryBuffer::reserve(size_t capacity) {
+    if (capacity <= buffer_.size()) return;
+
+    size_t size = buffer_.size();
+    while (size < capacity) size <<= 1;
+
+    // 保留的样本按时间顺序放到序号0开始的位置
+    size_t kept = this->size();
+    vector<double> resized(size);
+    for (size_t i = 0; i < kept; ++i) {
+        resized[i] = at(count_ - kept + i);
+    }
+    buffer_.swap(resized);
+    mask_ = size - 1;
+    count_ = kept;
+
+    for (Window& window : windows_) {
+        rebuild(window);
+    }
+}
+
+void HistoryBuffer::addWindow(size_t n) {
+    n = max<size_t>(1, min(n, MAX_WINDOW));
+    for (const Window& window : windows_) {
+        if (window.n == n) return;
+    }
+
+    // 写入新样本前，窗口内最旧的样本仍需留在缓冲区中
+    reserve(n + 1);
+
+    Window window;
+    window.n = n;
+    rebuild(window);
+    windows_.push_back(move(window));
+}
+
+void HistoryBuffer::push(double value) {
+    uint64_t seq = count_;
+    for (Window& window : windows_) {
+        uint64_t size = min<uint64_t>(seq, window.n);   // 写入前窗口内的样本数
+        if (size < window.n) {
+            window.weighted += size * value;
+            window.sum += value;
+        } else {
+            // 最旧的样本移出，其余样本位置减一，新样本位于n-1
+            double oldest = at(seq - window.n);
+            window.sum -= oldest;
+            window.weighted = window.weighted - window.sum + (window.n - 1) * value;
+            window.sum += value;
+        }
+
+        while (!window.max_queue.empty() && at(window.max_queue.back()) <= value) window.max_queue.pop_back();
+        window.max_queue.push_back(seq);
+        while (!window.min_queue.empty() && at(window.min_queue.back()) >= value) window.min_queue.pop_back();
+        window.min_queue.push_back(seq);
+    }
+
+    buffer_[seq & mask_] = value;
+    count_++;
+
+    for (Window& window : windows_) {
+        // 队首样本已移出窗口
+        uint64_t first = count_ > window.n ? count_ - window.n : 0;
+        while (window.max_queue.front() < first) window.max_queue.pop_front();
+        while (window.min_queue.front() < first) window.min_queue.pop_front();
+
+        // 每写满一轮缓冲区重新求和一次，均摊O(1)
+        if ((count_ & mask_) == 0) resum(window);
+    }
+}
+
+void HistoryBuffer::resum(Window& window) const {
+    uint64_t size = min<uint64_t>(count_, window.n);
+    uint64_t first = count_ - size;
+    window.sum = 0.0;
+    window.weighted = 0.0;
+    for (uint64_t seq = first; seq < count_; ++seq) {
+        double value = at(seq);
+        window.sum += value;
+        window.weighted += static_cast<double>(seq - first) * value;
+    }
+}
+
+void HistoryBuffer::rebuild(Window& window) const {
+    window.max_queue.clear();
+    window.min_queue.clear();
+    uint64_t first = count_ - min<uint64_t>(count_, window.n);
+    for (uint64_t seq = first; seq < count_; ++seq) {
+        double value = at(seq);
+        while (!window.max_queue.empty() && at(window.max_queue.back()) <= value) window.max_queue.pop_back();
+        window.max_queue.push_back(seq);
+        while (!window.min_queue.empty() && at(window.min_queue.back()) >= value) window.min_queue.pop_back();
+        window.min_queue.push_back(seq);
+    }
+    resum(window);
+}
+
+HistoryBuffer::Segments HistoryBuffer::segments(size_t n) const {
+    uint64_t first = count_ - n;
+    size_t offset = static_cast<size_t>(first & mask_);
+    size_t first_n = min(n, buffer_.size() - offset);
+    return {buffer_.data() + offset, first_n, buffer_.data(), n - first_n};
+}
+
+const HistoryBuffer::Window* HistoryBuffer::windowFor(size_t& n) const {
+    n = min(n, size());
+    for (const Window& window : windows_) {
+        // 样本数不足窗口长度时，窗口内就是全部样本
+        if (window.n == n || (n == count_ && window.n >= count_)) return &window;
+    }
+    return nullptr;
+}
+
+double HistoryBuffer::average(size_t n) const {
+    const Window* window = windowFor(n);
+    if (n == 0) return 0.0;
+    if (window) return window->sum / n;
+
+    Segments seg = segments(n);
+    return (WindowKernels::sum(seg.first, seg.first_n) + WindowKernels::sum(seg.second, seg.second_n)) / n;
+}
+
+double HistoryBuffer::maximum(size_t n) const {
+    const Window* window = windowFor(n);
+    if (n == 0) return 0.0;
+    if (window) return at(window->max_queue.front());
+
+    Segments seg = segments(n);
+    double result = WindowKernels::max(seg.first, seg.first_n);
+    return seg.second_n ? max(result, WindowKernels::max(seg.second, seg.second_n)) : result;
+}
+
+double HistoryBuffer::minimum(size_t n) const {
+    const Window* window = windowFor(n);
+    if (n == 0) return 0.0;
+    if (window) return at(window->min_queue.front());
+
+    Segments seg = segments(n);
+    double result = WindowKernels::min(seg.first, seg.first_n);
+    return seg.second_n ? min(result, WindowKernels::min(seg.second, seg.second_n)) : result;
+}
+
+double HistoryBuffer::trend(size_t n) const {
+    const Window* window = windowFor(n);
+    if (n < 2) return 0.0;
+
+    double sum = 0.0, weighted = 0.0;
+    if (window) {
+        sum = window->sum;
+        weighted = window->weighted;
+    } else {
+        uint64_t first = count_ - n;
+        for (uint64_t seq = first; seq < count_; ++seq) {
+            sum += at(seq);
+            weighted += static_cast<double>(seq - first) * at(seq);
+        }
+    }
+
+    // x = 0..n-1：Σx = n(n-1)/2，Σx² = (n-1)n(2n-1)/6
+    double m = static_cast<double>(n);
+    double sum_x = m * (m - 1) / 2;
+    double sum_xx = (m - 1) * m * (2 * m - 1) / 6;
+    return (m * weighted - sum_x * sum) / (m * sum_xx - sum_x * sum_x);
+}
+
+double HistoryBuffer::stddev(size_t n) const {
+    const Window* window = windowFor(n);
+    if (n == 0) return 0.0;
+
+    Segments seg = segments(n);
+    double mean = (window ? window->sum : WindowKernels::sum(seg.first, seg.first_n) +
+                                          WindowKernels::sum(seg.second, seg.second_n)) / n;
+    double deviation = WindowKernels::squaredDeviation(seg.first, seg.first_n, mean) +
+                       WindowKernels::squaredDeviation(seg.second, seg.second_n, mean);
+    return sqrt(deviation / n);
+}
+
+double HistoryBuffer::percentile(size_t n, double p) const {
+    windowFor(n);
+    if (n == 0) return 0.0;
+
+    // 选择会重排样本，复制到线程局部的临时数组
+    static thread_local vector<double> scratch;
+    Segments seg = segments(n);
+    scratch.assign(seg.first, seg.first + seg.first_n);
+    scratch.insert(scratch.end(), seg.second, seg.second + seg.second_n);
+    return WindowKernels::percentile(scratch.data(), n, p);
+}
+
+void HistoryBuffer::clear() {
+    count_ = 0;
+    for (Window& window : windows_) {
+        rebuild(window);
+    }
+}
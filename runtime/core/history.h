@@ -0,0 +1,82 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include "window_kernels.h"
+
+using namespace std;
+
+// 单个变量的历史样本：定长环形缓冲区 + 按窗口长度维护的增量聚合
+// 每个注册的窗口长度n维护最近n个样本的：和（平均值）、单调队列（最大/最小值）、
+// 最小二乘所需的加权和（趋势）；写入和查询都是O(1)，与n无关
+// 未注册的窗口长度按缓冲区内的样本扫描计算（O(n)，使用WindowKernels），超出容量时截断为容量
+class HistoryBuffer {
+public:
+    static constexpr size_t MAX_WINDOW = 1 << 16;   // 单个窗口的最大长度
+
+    HistoryBuffer();
+
+    // 注册窗口长度（超过MAX_WINDOW时截断），必要时扩大缓冲区；已有的样本保留
+    void addWindow(size_t n);
+
+    // 写入一个样本
+    void push(double value);
+
+    // 缓冲区内的样本数
+    size_t size() const { return static_cast<size_t>(min<uint64_t>(count_, buffer_.size())); }
+
+    // 最近n个样本（不足n个时取全部）的聚合；没有样本时返回0
+    double average(size_t n) const;
+    double maximum(size_t n) const;
+    double minimum(size_t n) const;
+
+    // 最近n个样本的最小二乘斜率（每个样本的变化量），样本少于2个时返回0
+    double trend(size_t n) const;
+
+    // 最近n个样本的总体标准差与第p百分位数（0~100），按样本扫描
+    double stddev(size_t n) const;
+    double percentile(size_t n, double p) const;
+
+    // 清空样本，保留注册的窗口
+    void clear();
+
+private:
+    struct Window {
+        size_t n;
+        double sum = 0.0;           // 窗口内样本的和
+        double weighted = 0.0;      // 窗口内 Σ x·y，x为样本在窗口内的位置（最旧为0）
+        deque<uint64_t> max_queue;  // 样本序号，对应的值单调递减
+        deque<uint64_t> min_queue;  // 样本序号，对应的值单调递增
+    };
+
+    vector<double> buffer_;         // 容量为2的幂，按序号取模存放
+    uint64_t mask_;
+    uint64_t count_;                // 下一个样本的序号（扩大缓冲区时重新编号）
+    vector<Window> windows_;
+
+    double at(uint64_t seq) const { return buffer_[seq & mask_]; }
+
+    // 最近n个样本在环形缓冲区中的两段连续内存（按时间顺序，second可能为空）
+    struct Segments {
+        const double* first;
+        size_t first_n;
+        const double* second;
+        size_t second_n;
+    };
+    Segments segments(size_t n) const;
+
+    // 把n截断为可用的样本数，返回恰好覆盖最近n个样本的窗口（没有时返回nullptr）
+    const Window* windowFor(size_t& n) const;
+
+    // 按缓冲区内的样本重新计算窗口的和与加权和，消除浮点累积误差
+    void resum(Window& window) const;
+
+    // 按缓冲区内的样本重建窗口的全部状态
+    void rebuild(Window& window) const;
+
+    // 扩大缓冲区到至少capacity个样本，保留的样本从序号0重新编号
+    void reserve(size_t capacity);
+};
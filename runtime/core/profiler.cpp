@@ -0,0 +1,250 @@
+#include "profiler.h"
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdio>
+#include <algorithm>
+
+// 实例编号，跨Profiler实例唯一
+static atomic<uint64_t> g_profiler_uid(0);
+
+// 线程本地缓存：最近一次使用的Profiler及其分片
+struct ShardCache {
+    uint64_t uid = 0;
+    void* shard = nullptr;
+};
+static thread_local ShardCache t_shard_cache;
+
+// 动作耗时所在的桶：上界为2^i微秒
+static size_t bucketOf(uint64_t ns) {
+    uint64_t us = (ns + 999) / 1000;
+    size_t bucket = 0;
+    while (bucket + 1 < ActionCounters::BUCKETS && (1ULL << bucket) < us) {
+        bucket++;
+    }
+    return bucket;
+}
+
+// Prometheus标签值转义
+static string escapeLabel(const string& value) {
+    string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+// Profiler 实现
+Profiler::Profiler() : enabled_(false), uid_(++g_profiler_uid) {
+}
+
+Profiler::~Profiler() {
+}
+
+void Profiler::setEnabled(bool enabled) {
+    enabled_.store(enabled, memory_order_relaxed);
+}
+
+uint32_t Profiler::ruleId(const string& rule_id) {
+    lock_guard<mutex> lock(mutex_);
+    auto result = rule_ids_.emplace(rule_id, static_cast<uint32_t>(rule_names_.size()));
+    if (result.second) {
+        rule_names_.push_back(rule_id);
+    }
+    return result.first->second;
+}
+
+uint32_t Profiler::actionId(const string& name) {
+    lock_guard<mutex> lock(mutex_);
+    auto result = action_ids_.emplace(name, static_cast<uint32_t>(action_names_.size()));
+    if (result.second) {
+        action_names_.push_back(name);
+    }
+    return result.first->second;
+}
+
+Profiler::Shard& Profiler::localShard() {
+    if (t_shard_cache.uid == uid_) {
+        return *static_cast<Shard*>(t_shard_cache.shard);
+    }
+
+    lock_guard<mutex> lock(mutex_);
+    unique_ptr<Shard>& shard = shards_[this_thread::get_id()];
+    if (!shard) {
+        shard.reset(new Shard());
+    }
+    t_shard_cache.uid = uid_;
+    t_shard_cache.shard = shard.get();
+    return *shard;
+}
+
+void Profiler::recordEval(uint32_t rule, uint64_t ns) {
+    recordEval(rule, ns, 1);
+}
+
+void Profiler::recordEval(uint32_t rule, uint64_t ns, uint64_t count) {
+    RuleCounters* counters = localShard().rules.at(rule);
+    if (!counters) return;
+    add(counters->evaluations, count);
+    add(counters->eval_ns, ns);
+}
+
+void Profiler::recordFire(uint32_t rule, uint64_t count) {
+    RuleCounters* counters = localShard().rules.at(rule);
+    if (!counters) return;
+    add(counters->fires, count);
+}
+
+void Profiler::recordAction(uint32_t action, uint64_t ns) {
+    ActionCounters* counters = localShard().actions.at(action);
+    if (!counters) return;
+    add(counters->calls, 1);
+    add(counters->total_ns, ns);
+    add(counters->buckets[bucketOf(ns)], 1);
+}
+
+void Profiler::sumRule(uint32_t id, uint64_t& evaluations, uint64_t& eval_ns, uint64_t& fires) const {
+    evaluations = eval_ns = fires = 0;
+    for (const auto& pair : shards_) {
+        const RuleCounters* counters = pair.second->rules.find(id);
+        if (!counters) continue;
+        evaluations += counters->evaluations.load(memory_order_relaxed);
+        eval_ns += counters->eval_ns.load(memory_order_relaxed);
+        fires += counters->fires.load(memory_order_relaxed);
+    }
+}
+
+void Profiler::sumAction(uint32_t id, uint64_t& calls, uint64_t& total_ns, uint64_t* buckets) const {
+    calls = total_ns = 0;
+    fill(buckets, buckets + ActionCounters::BUCKETS, 0);
+    for (const auto& pair : shards_) {
+        const ActionCounters* counters = pair.second->actions.find(id);
+        if (!counters) continue;
+        calls += counters->calls.load(memory_order_relaxed);
+        total_ns += counters->total_ns.load(memory_order_relaxed);
+        for (size_t b = 0; b < ActionCounters::BUCKETS; ++b) {
+            buckets[b] += counters->buckets[b].load(memory_order_relaxed);
+        }
+    }
+}
+
+json Profiler::collect() const {
+    lock_guard<mutex> lock(mutex_);
+    json result;
+    result["enabled"] = enabled();
+
+    json rules = json::object();
+    for (uint32_t id = 0; id < rule_names_.size(); ++id) {
+        uint64_t evaluations, eval_ns, fires;
+        sumRule(id, evaluations, eval_ns, fires);
+        if (evaluations == 0 && fires == 0) continue;
+
+        json rule;
+        rule["evaluations"] = evaluations;
+        rule["eval_time_us"] = eval_ns / 1000.0;
+        rule["avg_eval_ns"] = evaluations ? eval_ns / evaluations : 0;
+        rule["fires"] = fires;
+        rules[rule_names_[id]] = rule;
+    }
+    result["rules"] = rules;
+
+    json actions = json::object();
+    for (uint32_t id = 0; id < action_names_.size(); ++id) {
+        uint64_t calls, total_ns;
+        uint64_t buckets[ActionCounters::BUCKETS];
+        sumAction(id, calls, total_ns, buckets);
+        if (calls == 0) continue;
+
+        // 直方图只输出非空的桶：上界（微秒，最后一个桶为null）和计数
+        json histogram = json::array();
+        for (size_t b = 0; b < ActionCounters::BUCKETS; ++b) {
+            if (buckets[b] == 0) continue;
+            json bound = (b + 1 < ActionCounters::BUCKETS) ? json(1ULL << b) : json(nullptr);
+            histogram.push_back({{"le_us", bound}, {"count", buckets[b]}});
+        }
+
+        json action;
+        action["calls"] = calls;
+        action["total_us"] = total_ns / 1000.0;
+        action["avg_us"] = total_ns / 1000.0 / calls;
+        action["histogram"] = histogram;
+        actions[action_names_[id]] = action;
+    }
+    result["actions"] = actions;
+    return result;
+}
+
+string Profiler::toPrometheus() const {
+    lock_guard<mutex> lock(mutex_);
+    ostringstream rule_evaluations, rule_seconds, rule_fires, action_duration;
+    // 秒数按纳秒精度定点输出，累计值变大后不丢失分辨率
+    rule_seconds << fixed << setprecision(9);
+    action_duration << fixed << setprecision(9);
+    
+    for (uint32_t id = 0; id < rule_names_.size(); ++id) {
+        uint64_t evaluations, eval_ns, fires;
+        sumRule(id, evaluations, eval_ns, fires);
+        if (evaluations == 0 && fires == 0) continue;
+        
+        string label = "{rule=\"" + escapeLabel(rule_names_[id]) + "\"} ";
+        rule_evaluations << "snipper_rule_evaluations_total" << label << evaluations << "\n";
+        rule_seconds << "snipper_rule_eval_seconds_total" << label << eval_ns / 1e9 << "\n";
+        rule_fires << "snipper_rule_fires_total" << label << fires << "\n";
+    }
+    
+    // Prometheus直方图的桶是累计计数
+    for (uint32_t id = 0; id < action_names_.size(); ++id) {
+        uint64_t calls, total_ns;
+        uint64_t buckets[ActionCounters::BUCKETS];
+        sumAction(id, calls, total_ns, buckets);
+        if (calls == 0) continue;
+        
+        string label = "action=\"" + escapeLabel(action_names_[id]) + "\"";
+        uint64_t cumulative = 0;
+        for (size_t b = 0; b + 1 < ActionCounters::BUCKETS; ++b) {
+            cumulative += buckets[b];
+            action_duration << "snipper_action_duration_seconds_bucket{" << label << ",le=\""
+                            << (1ULL << b) / 1e6 << "\"} " << cumulative << "\n";
+        }
+        action_duration << "snipper_action_duration_seconds_bucket{" << label << ",le=\"+Inf\"} " << calls << "\n";
+        action_duration << "snipper_action_duration_seconds_sum{" << label << "} " << total_ns / 1e9 << "\n";
+        action_duration << "snipper_action_duration_seconds_count{" << label << "} " << calls << "\n";
+    }
+    
+    ostringstream out;
+    out << "# HELP snipper_rule_evaluations_total Number of rule condition evaluations.\n"
+        << "# TYPE snipper_rule_evaluations_total counter\n" << rule_evaluations.str()
+        << "# HELP snipper_rule_eval_seconds_total Time spent evaluating rule conditions.\n"
+        << "# TYPE snipper_rule_eval_seconds_total counter\n" << rule_seconds.str()
+        << "# HELP snipper_rule_fires_total Number of times a rule fired.\n"
+        << "# TYPE snipper_rule_fires_total counter\n" << rule_fires.str()
+        << "# HELP snipper_action_duration_seconds Action execution time.\n"
+        << "# TYPE snipper_action_duration_seconds histogram\n" << action_duration.str();
+    return out.str();
+}
+
+bool Profiler::dumpPrometheus(const string& path) const {
+    string temp = path + ".tmp";
+    {
+        ofstream file(temp, ios::trunc);
+        if (!file) return false;
+        file << toPrometheus();
+        if (!file) return false;
+    }
+    return rename(temp.c_str(), path.c_str()) == 0;
+}
+
+uint64_t Profiler::now_ns() {
+    return chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <memory>
+
+using namespace nlohmann;
+using namespace std;
+
+// 单条规则的计数
+struct RuleCounters {
+    atomic<uint64_t> evaluations{0};    // 条件实际评估次数（复用缓存结果不计）
+    atomic<uint64_t> eval_ns{0};        // 条件评估总耗时
+    atomic<uint64_t> fires{0};          // 触发次数
+};
+
+// 单个动作的耗时直方图：第i个桶的上界为2^i微秒，最后一个桶不设上界
+struct ActionCounters {
+    static constexpr size_t BUCKETS = 26;
+    atomic<uint64_t> calls{0};
+    atomic<uint64_t> total_ns{0};
+    atomic<uint64_t> buckets[BUCKETS] {};
+};
+
+// 按编号索引的计数表，分块分配，块指针发布后不再移动，读线程可以无锁读取
+template <typename T>
+class CounterTable {
+public:
+    static constexpr size_t BLOCK = 256;
+    static constexpr size_t MAX_BLOCKS = 4096;
+
+    CounterTable() : blocks_() {}
+    ~CounterTable() {
+        for (auto& block : blocks_) {
+            delete[] block.load(memory_order_relaxed);
+        }
+    }
+    CounterTable(const CounterTable&) = delete;
+    CounterTable& operator=(const CounterTable&) = delete;
+
+    // 写线程获取计数，所在块不存在时分配（编号超出容量时返回nullptr）
+    T* at(uint32_t id) {
+        size_t index = id / BLOCK;
+        if (index >= MAX_BLOCKS) return nullptr;
+        T* block = blocks_[index].load(memory_order_relaxed);
+        if (!block) {
+            block = new T[BLOCK];
+            blocks_[index].store(block, memory_order_release);
+        }
+        return &block[id % BLOCK];
+    }
+
+    // 读线程获取计数，所在块尚未分配时返回nullptr
+    const T* find(uint32_t id) const {
+        size_t index = id / BLOCK;
+        if (index >= MAX_BLOCKS) return nullptr;
+        const T* block = blocks_[index].load(memory_order_acquire);
+        return block ? &block[id % BLOCK] : nullptr;
+    }
+
+private:
+    atomic<T*> blocks_[MAX_BLOCKS];
+};
+
+// 性能剖析器：记录每条规则的条件评估耗时、触发次数和每个动作的耗时直方图
+// 每个线程写入自己的计数分片（单写者，不需要原子加），读取时汇总所有分片
+// 规则和动作按名称分配稳定编号，重新加载规则后计数延续
+class Profiler {
+public:
+    Profiler();
+    ~Profiler();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    // 开关（关闭时调用方只需检查一次enabled）
+    void setEnabled(bool enabled);
+    bool enabled() const { return enabled_.load(memory_order_relaxed); }
+
+    // 获取规则/动作的编号，首次出现时分配
+    uint32_t ruleId(const string& rule_id);
+    uint32_t actionId(const string& name);
+
+    // 记录（在当前线程的分片上）
+    void recordEval(uint32_t rule, uint64_t ns);
+    void recordEval(uint32_t rule, uint64_t ns, uint64_t count);
+    void recordFire(uint32_t rule, uint64_t count = 1);
+    void recordAction(uint32_t action, uint64_t ns);
+
+    // 汇总所有线程的计数
+    json collect() const;
+
+    // 汇总为Prometheus文本格式
+    string toPrometheus() const;
+
+    // 写入Prometheus文本文件（先写临时文件再改名，读取方不会看到写了一半的文件）
+    bool dumpPrometheus(const string& path) const;
+
+    // 当前时间（纳秒）
+    static uint64_t now_ns();
+
+private:
+    // 一个线程的计数
+    struct Shard {
+        CounterTable<RuleCounters> rules;
+        CounterTable<ActionCounters> actions;
+    };
+
+    atomic<bool> enabled_;
+    uint64_t uid_;                          // 区分不同的Profiler实例，用于线程本地缓存
+
+    mutable mutex mutex_;
+    unordered_map<thread::id, unique_ptr<Shard>> shards_;
+    vector<string> rule_names_;
+    unordered_map<string, uint32_t> rule_ids_;
+    vector<string> action_names_;
+    unordered_map<string, uint32_t> action_ids_;
+
+    // 当前线程的分片
+    Shard& localShard();
+
+    // 汇总所有分片中一条规则/一个动作的计数（调用方持有mutex_）
+    void sumRule(uint32_t id, uint64_t& evaluations, uint64_t& eval_ns, uint64_t& fires) const;
+    void sumAction(uint32_t id, uint64_t& calls, uint64_t& total_ns, uint64_t* buckets) const;
+
+    // 单写者累加
+    static void add(atomic<uint64_t>& counter, uint64_t value) {
+        counter.store(counter.load(memory_order_relaxed) + value, memory_order_relaxed);
+    }
+};
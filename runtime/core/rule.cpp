@@ -3,7 +3,8 @@
 
 // Rule 实现
 Rule::Rule() 
-    : throttle_ms(0), last_fire(0), disabled(false), priority(500) {
+    : throttle_ms(0), last_fire(0), disabled(false), priority(500),
+      time_dependent(false), cached_result(false), cache_valid(false) {
 }
 
 bool Rule::operator<(const Rule& other) const {
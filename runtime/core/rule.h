@@ -4,16 +4,20 @@
 #include <string>
 #include <vector>
 #include <functional>
+#include <iterator>
+#include <memory>
 
 using namespace std;
 
 // 前向声明
 class Condition;
+struct ActionSlot;
 
 // 动作步骤
 struct ActionStep {
     string name;    // 动作名称
     json params;    // 动作参数
+    shared_ptr<ActionSlot> slot;    // 加载时绑定的动作槽位
 };
 
 // 动作函数类型
@@ -38,6 +42,15 @@ public:
     int priority;           // 优先级 (0-1000, 越小优先级越高)
     string group;           // 规则组（可选）
     
+    // 增量评估
+    vector<SlotId> inputs;  // 条件读取的槽位（加载时收集）
+    bool time_dependent;    // 条件依赖时间，每次tick都需评估
+    bool cached_result;     // 上次评估结果
+    bool cache_valid;       // 上次评估结果是否仍然有效
+    
+    // 解析得到的规则原型，重新加载时未变化的规则直接复用；异步动作持有它以保证动作步骤有效
+    shared_ptr<const Rule> source;
+    
     Rule();
     
     // 优先级比较函数，用于排序
@@ -55,3 +68,52 @@ public:
     // 启用规则
     void enable();
 };
+
+// 规则句柄：规则在Engine中的存储下标，加载后不随优先级调整变化
+using RuleHandle = uint32_t;
+constexpr RuleHandle INVALID_RULE = UINT32_MAX;
+
+// 规则视图：按句柄列表引用Engine中的规则，不拷贝
+// 重新加载或清空规则、调整优先级后视图失效，需要重新获取
+class RuleView {
+public:
+    class iterator {
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = Rule;
+        using difference_type = ptrdiff_t;
+        using pointer = const Rule*;
+        using reference = const Rule&;
+        
+        iterator(const Rule* rules, const RuleHandle* handle) : rules_(rules), handle_(handle) {}
+        
+        const Rule& operator*() const { return rules_[*handle_]; }
+        const Rule* operator->() const { return &rules_[*handle_]; }
+        iterator& operator++() { ++handle_; return *this; }
+        iterator operator++(int) { iterator old = *this; ++handle_; return old; }
+        bool operator==(const iterator& other) const { return handle_ == other.handle_; }
+        bool operator!=(const iterator& other) const { return handle_ != other.handle_; }
+        
+    private:
+        const Rule* rules_;
+        const RuleHandle* handle_;
+    };
+    
+    RuleView() : rules_(nullptr), begin_(nullptr), end_(nullptr) {}
+    RuleView(const Rule* rules, const RuleHandle* begin, const RuleHandle* end)
+        : rules_(rules), begin_(begin), end_(end) {}
+    
+    iterator begin() const { return iterator(rules_, begin_); }
+    iterator end() const { return iterator(rules_, end_); }
+    size_t size() const { return end_ - begin_; }
+    bool empty() const { return begin_ == end_; }
+    const Rule& operator[](size_t index) const { return rules_[begin_[index]]; }
+    
+    // 第index条规则的句柄
+    RuleHandle handle(size_t index) const { return begin_[index]; }
+    
+private:
+    const Rule* rules_;
+    const RuleHandle* begin_;
+    const RuleHandle* end_;
+};
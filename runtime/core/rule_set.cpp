@@ -0,0 +1,74 @@
+#include "rule_set.h"
+#include "../priority/priority_manager.h"
+#include <algorithm>
+
+// RuleSet 实现
+RuleHandle RuleSet::find(const string& rule_id) const {
+    auto it = rule_ids.find(rule_id);
+    return (it != rule_ids.end()) ? it->second : INVALID_RULE;
+}
+
+void RuleSet::buildDependencyIndex() {
+    slot_rules.clear();
+    for (size_t i = 0; i < rules.size(); ++i) {
+        for (SlotId slot : rules[i].inputs) {
+            if (slot >= slot_rules.size()) {
+                slot_rules.resize(slot + 1);
+            }
+            slot_rules[slot].push_back(static_cast<RuleHandle>(i));
+        }
+    }
+}
+
+void RuleSet::buildIndexes() {
+    rule_ids.clear();
+    group_rules.clear();
+    group_names.clear();
+    for (size_t i = 0; i < rules.size(); ++i) {
+        const Rule& rule = rules[i];
+        rule_ids.emplace(rule.id, static_cast<RuleHandle>(i));   // ID重复时保留第一条
+        if (!rule.group.empty()) {
+            vector<RuleHandle>& members = group_rules[rule.group];
+            if (members.empty()) {
+                group_names.push_back(rule.group);
+            }
+            members.push_back(static_cast<RuleHandle>(i));
+        }
+    }
+    
+    // 规则组编号按首次出现的顺序分配
+    unordered_map<string, uint32_t> group_index;
+    for (uint32_t g = 0; g < group_names.size(); ++g) {
+        group_index.emplace(group_names[g], g);
+    }
+    rule_group.assign(rules.size(), static_cast<uint32_t>(group_names.size()));
+    for (size_t i = 0; i < rules.size(); ++i) {
+        if (!rules[i].group.empty()) {
+            rule_group[i] = group_index[rules[i].group];
+        }
+    }
+    sortByPriority();
+}
+
+void RuleSet::sortByPriority() {
+    PriorityManager::sortOrder(rules, order, order_position);
+    for (auto& pair : group_rules) {
+        sort(pair.second.begin(), pair.second.end(), [this](RuleHandle a, RuleHandle b) {
+            return order_position[a] < order_position[b];
+        });
+    }
+}
+
+void RuleSet::clear() {
+    rules.clear();
+    order.clear();
+    order_position.clear();
+    rule_ids.clear();
+    group_rules.clear();
+    slot_rules.clear();
+    group_names.clear();
+    rule_group.clear();
+    group_policies.clear();
+    history_windows.clear();
+    previous.clear();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "rule.h"
+#include "../priority/priority_manager.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+using namespace std;
+
+// 规则集：一次加载得到的全部规则及其索引
+// 重新加载时在后台线程构建新的规则集，构建完成后由tick线程整体替换当前规则集
+struct RuleSet {
+    vector<Rule> rules;                     // 按加载顺序存储，下标即规则句柄
+    vector<RuleHandle> order;               // 按优先级排列的句柄（执行顺序）
+    vector<uint32_t> order_position;        // 句柄 -> 在order中的位置
+    unordered_map<string, RuleHandle> rule_ids;             // 规则ID -> 句柄
+    unordered_map<string, vector<RuleHandle>> group_rules;  // 规则组 -> 句柄（按优先级排列）
+    vector<vector<RuleHandle>> slot_rules;  // 槽位 -> 读取该槽位的规则
+    vector<string> group_names;             // 规则组编号 -> 名称
+    vector<uint32_t> rule_group;            // 句柄 -> 规则组编号（不属于任何组的规则为group_names.size()）
+    vector<pair<string, GroupPolicy>> group_policies;   // 配置中"groups"指定的冲突处理策略
+    vector<pair<SlotId, uint32_t>> history_windows;     // 表达式引用的 (变量槽位, 窗口长度)，已去重
+    uint64_t version = 0;                   // 规则集版本号，ContextBatch据此迁移设备状态
+    
+    // 构建时参照的上一个规则集，替换时据此把运行状态迁移到同ID的规则
+    uint64_t base_version = 0;              // 上一个规则集的版本号
+    vector<RuleHandle> previous;            // 句柄 -> 上一个规则集中同ID规则的句柄
+    
+    // 按规则ID查找句柄
+    RuleHandle find(const string& rule_id) const;
+    
+    // 根据各规则收集的输入槽位重建槽位到规则的反向依赖索引
+    void buildDependencyIndex();
+    
+    // 重建规则ID和规则组索引，并按优先级排序
+    void buildIndexes();
+    
+    // 按优先级重排执行顺序和各规则组
+    void sortByPriority();
+    
+    // 清空规则和索引（版本号不变）
+    void clear();
+};
@@ -0,0 +1,221 @@
+#include "scalar.h"
+#include <mutex>
+#include <cstddef>
+
+// 加载时长字符串常量的驻留池，与键名符号表分开
+// 只增不减，按块分配，已发布的块不移动：读取不加锁，写入（加载时）加互斥锁
+class StringPool {
+public:
+    static constexpr uint32_t CHUNK_SIZE = 4096;
+    static constexpr uint32_t MAX_CHUNKS = 4096;
+    static constexpr uint32_t FULL = UINT32_MAX;
+
+    StringPool() {
+        for (auto& chunk : chunks_) chunk.store(nullptr, memory_order_relaxed);
+    }
+
+    ~StringPool() {
+        for (auto& chunk : chunks_) delete[] chunk.load(memory_order_relaxed);
+    }
+
+    // 驻留字符串，返回编号；池已满时返回FULL
+    uint32_t intern(string_view v) {
+        lock_guard<mutex> lock(mutex_);
+        auto it = ids_.find(v);
+        if (it != ids_.end()) return it->second;
+        if (count_ == CHUNK_SIZE * MAX_CHUNKS) return FULL;
+
+        string* chunk = chunks_[count_ / CHUNK_SIZE].load(memory_order_relaxed);
+        if (!chunk) {
+            chunk = new string[CHUNK_SIZE];
+            chunks_[count_ / CHUNK_SIZE].store(chunk, memory_order_release);
+        }
+        string& text = chunk[count_ % CHUNK_SIZE];
+        text.assign(v.data(), v.size());
+        ids_.emplace(string_view(text), count_);
+        return count_++;
+    }
+
+    // 编号只能来自intern，取得编号的线程已经能看到对应的内容
+    const string& name(uint32_t id) const {
+        return chunks_[id / CHUNK_SIZE].load(memory_order_acquire)[id % CHUNK_SIZE];
+    }
+
+    size_t size() const {
+        lock_guard<mutex> lock(mutex_);
+        return count_;
+    }
+
+private:
+    mutable mutex mutex_;
+    unordered_map<string_view, uint32_t> ids_;     // 键指向块中的字符串
+    atomic<string*> chunks_[MAX_CHUNKS];
+    uint32_t count_ = 0;
+};
+
+static StringPool& stringPool() {
+    static StringPool pool;
+    return pool;
+}
+
+// 类型顺序，与json的跨类型比较顺序一致
+static int typeRank(ScalarType type) {
+    switch (type) {
+        case ScalarType::NUL: return 0;
+        case ScalarType::BOOL: return 1;
+        case ScalarType::INT:
+        case ScalarType::DOUBLE: return 2;
+        case ScalarType::JSON: return 3;
+        case ScalarType::STRING: return 4;
+    }
+    return 0;
+}
+
+// Scalar 实现
+Scalar Scalar::fromBool(bool v) {
+    Scalar s;
+    s.i_ = 0;
+    s.b_ = v;
+    s.type_ = ScalarType::BOOL;
+    return s;
+}
+
+Scalar Scalar::fromInt(int64_t v) {
+    Scalar s;
+    s.i_ = v;
+    s.type_ = ScalarType::INT;
+    return s;
+}
+
+Scalar Scalar::fromDouble(double v) {
+    Scalar s;
+    s.d_ = v;
+    s.type_ = ScalarType::DOUBLE;
+    return s;
+}
+
+Scalar Scalar::fromString(string_view v) {
+    return makeString(v, false);
+}
+
+Scalar Scalar::fromLiteral(string_view v) {
+    return makeString(v, true);
+}
+
+Scalar Scalar::makeString(string_view v, bool literal) {
+    Scalar s;
+    s.type_ = ScalarType::STRING;
+    if (v.size() <= INLINE_CAPACITY) {
+        // 内联字符串从对象起始处跨过i_和tail_，未用的字节保持为0
+        static_assert(offsetof(Scalar, tail_) == sizeof(int64_t), "inline string must be contiguous");
+        memcpy(reinterpret_cast<char*>(&s), v.data(), v.size());
+        s.len_ = static_cast<uint8_t>(v.size());
+        return s;
+    }
+    uint32_t id = literal ? stringPool().intern(v) : StringPool::FULL;
+    if (id != StringPool::FULL) {
+        s.s_ = id;
+        s.form_ = STRING_POOLED;
+    } else {
+        s.h_ = new HeapString{{1}, string(v)};
+        s.form_ = STRING_HEAP;
+    }
+    return s;
+}
+
+Scalar Scalar::fromJson(const json& v) {
+    switch (v.type()) {
+        case json::value_t::boolean:
+            return fromBool(v.get<bool>());
+        case json::value_t::number_integer:
+            return fromInt(v.get<int64_t>());
+        case json::value_t::number_unsigned: {
+            // 超出int64范围的无符号数按浮点保存，避免变成负数
+            uint64_t u = v.get<uint64_t>();
+            if (u > static_cast<uint64_t>(INT64_MAX)) return fromDouble(static_cast<double>(u));
+            return fromInt(static_cast<int64_t>(u));
+        }
+        case json::value_t::number_float:
+            return fromDouble(v.get<double>());
+        case json::value_t::string:
+            return fromString(v.get_ref<const string&>());
+        case json::value_t::object:
+        case json::value_t::array:
+        case json::value_t::binary: {
+            Scalar s;
+            s.type_ = ScalarType::JSON;
+            return s;
+        }
+        default:
+            return Scalar();
+    }
+}
+
+json Scalar::toJson() const {
+    switch (type_) {
+        case ScalarType::BOOL: return b_;
+        case ScalarType::INT: return i_;
+        case ScalarType::DOUBLE: return d_;
+        case ScalarType::STRING: return string(str());
+        default: return json();
+    }
+}
+
+const string& Scalar::pooled(uint32_t id) {
+    return stringPool().name(id);
+}
+
+size_t Scalar::pooledStrings() {
+    return stringPool().size();
+}
+
+bool Scalar::truthy() const {
+    switch (type_) {
+        case ScalarType::BOOL: return b_;
+        case ScalarType::INT: return i_ != 0;
+        case ScalarType::DOUBLE: return d_ != 0;
+        case ScalarType::NUL: return false;
+        default: return true;
+    }
+}
+
+bool Scalar::operator==(const Scalar& other) const {
+    if (type_ == other.type_) {
+        switch (type_) {
+            case ScalarType::NUL: return true;
+            case ScalarType::BOOL: return b_ == other.b_;
+            case ScalarType::INT: return i_ == other.i_;
+            case ScalarType::DOUBLE: return d_ == other.d_;
+            case ScalarType::STRING:
+                // 短字符串总是内联，逐字节比较；两个常量比较池编号；其余比较内容
+                if (form_ == STRING_INLINE || other.form_ == STRING_INLINE) {
+                    return len_ == other.len_ && form_ == other.form_ && i_ == other.i_ &&
+                           memcmp(tail_, other.tail_, sizeof(tail_)) == 0;
+                }
+                if (form_ == STRING_POOLED && other.form_ == STRING_POOLED) return s_ == other.s_;
+                return str() == other.str();
+            case ScalarType::JSON: return false;
+        }
+    }
+    if (isNumber() && other.isNumber()) {
+        return asDouble() == other.asDouble();
+    }
+    return false;
+}
+
+bool Scalar::operator<(const Scalar& other) const {
+    if (type_ == ScalarType::INT && other.type_ == ScalarType::INT) {
+        return i_ < other.i_;
+    }
+    if (isNumber() && other.isNumber()) {
+        return asDouble() < other.asDouble();
+    }
+    if (type_ != other.type_) {
+        return typeRank(type_) < typeRank(other.type_);
+    }
+    switch (type_) {
+        case ScalarType::BOOL: return b_ < other.b_;
+        case ScalarType::STRING: return str() < other.str();
+        default: return false;
+    }
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "symbol_table.h"
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+using namespace nlohmann;
+using namespace std;
+
+// 标量类型标签
+enum class ScalarType : uint8_t {
+    NUL,        // 空值
+    BOOL,       // 布尔
+    INT,        // 64位整数
+    DOUBLE,     // 双精度浮点
+    STRING,     // 字符串（短字符串内联，长字符串见Scalar::StringForm）
+    JSON        // 非标量json（对象/数组），内容由持有者另行保存
+};
+
+// 紧凑标量值（16字节），用于传感器数据和表达式求值热路径
+// 与json之间的转换只发生在配置加载和动作参数传递时
+// 字符串：不超过INLINE_CAPACITY字节的直接存放在Scalar内；更长的加载时常量驻留在只增不减的字符串池，
+// 运行时产生的长字符串（传感器值、拼接结果）放在引用计数的堆内存中，不进入字符串池
+class Scalar {
+public:
+    static constexpr size_t INLINE_CAPACITY = 13;
+
+    Scalar() : i_(0), tail_(), len_(0), form_(STRING_INLINE), type_(ScalarType::NUL) {}
+    Scalar(const Scalar& other) { copyBits(other); retain(); }
+    Scalar(Scalar&& other) noexcept { copyBits(other); other.disown(); }
+    ~Scalar() { release(); }
+
+    Scalar& operator=(const Scalar& other) {
+        other.retain();
+        release();
+        copyBits(other);
+        return *this;
+    }
+    Scalar& operator=(Scalar&& other) noexcept {
+        if (this != &other) {
+            release();
+            copyBits(other);
+            other.disown();
+        }
+        return *this;
+    }
+
+    static Scalar fromBool(bool v);
+    static Scalar fromInt(int64_t v);
+    static Scalar fromDouble(double v);
+    static Scalar fromString(string_view v);    // 运行时的值，不驻留
+    static Scalar fromLiteral(string_view v);   // 加载时的常量，长字符串驻留到字符串池
+    static Scalar fromJson(const json& v);
+
+    // 转换为json
+    json toJson() const;
+
+    ScalarType type() const { return type_; }
+    bool isNull() const { return type_ == ScalarType::NUL; }
+    bool isBool() const { return type_ == ScalarType::BOOL; }
+    bool isNumber() const { return type_ == ScalarType::INT || type_ == ScalarType::DOUBLE; }
+    bool isString() const { return type_ == ScalarType::STRING; }
+    bool isJson() const { return type_ == ScalarType::JSON; }
+
+    bool asBool() const { return b_; }
+    int64_t asInt() const {
+        return type_ == ScalarType::INT ? i_ : (type_ == ScalarType::DOUBLE ? static_cast<int64_t>(d_) : 0);
+    }
+    double asDouble() const {
+        return type_ == ScalarType::DOUBLE ? d_ : (type_ == ScalarType::INT ? static_cast<double>(i_) : 0.0);
+    }
+
+    // 获取字符串内容（仅STRING类型有效），不加锁；内联字符串的视图随Scalar失效
+    string_view str() const {
+        if (form_ == STRING_INLINE) return string_view(reinterpret_cast<const char*>(this), len_);
+        if (form_ == STRING_HEAP) return h_->text;
+        return pooled(s_);
+    }
+
+    // 持有堆上的字符串，不能按字节复制
+    bool ownsHeap() const { return form_ == STRING_HEAP; }
+
+    // 堆字符串的引用计数，其他形式返回0
+    uint32_t heapRefs() const { return form_ == STRING_HEAP ? h_->refs.load(memory_order_relaxed) : 0; }
+
+    // 真值判断：布尔取值，数字非零，其余非空即真
+    bool truthy() const;
+
+    // 比较（语义与json一致：数字按数值比较，不同类型按类型顺序比较）
+    bool operator==(const Scalar& other) const;
+    bool operator!=(const Scalar& other) const { return !(*this == other); }
+    bool operator<(const Scalar& other) const;
+    bool operator>(const Scalar& other) const { return other < *this; }
+    bool operator<=(const Scalar& other) const { return !(other < *this); }
+    bool operator>=(const Scalar& other) const { return !(*this < other); }
+
+    // 字符串池中的字符串数
+    static size_t pooledStrings();
+
+private:
+    // 字符串的存放方式
+    enum StringForm : uint8_t {
+        STRING_INLINE,      // 内容在i_和tail_的字节中（非字符串类型也取此值）
+        STRING_POOLED,      // s_为字符串池编号
+        STRING_HEAP         // h_指向引用计数的字符串
+    };
+
+    struct HeapString {
+        atomic<uint32_t> refs;
+        string text;
+    };
+
+    union {
+        int64_t i_;
+        double d_;
+        bool b_;
+        uint32_t s_;
+        HeapString* h_;
+    };
+    char tail_[INLINE_CAPACITY - sizeof(int64_t)];
+    uint8_t len_;           // 内联字符串的长度
+    StringForm form_;
+    ScalarType type_;
+
+    static Scalar makeString(string_view v, bool literal);
+    static const string& pooled(uint32_t id);
+
+    void copyBits(const Scalar& other) {
+        i_ = other.i_;
+        memcpy(tail_, other.tail_, sizeof(tail_));
+        len_ = other.len_;
+        form_ = other.form_;
+        type_ = other.type_;
+    }
+    void retain() const {
+        if (form_ == STRING_HEAP) h_->refs.fetch_add(1, memory_order_relaxed);
+    }
+    void disown() {
+        if (form_ == STRING_HEAP) {
+            form_ = STRING_INLINE;
+            type_ = ScalarType::NUL;
+        }
+    }
+    void release() {
+        if (form_ == STRING_HEAP && h_->refs.fetch_sub(1, memory_order_acq_rel) == 1) delete h_;
+    }
+};
+
+static_assert(sizeof(Scalar) == 16, "Scalar must stay 16 bytes");
@@ -0,0 +1,131 @@
+#include "shared_context.h"
+#include <thread>
+#include <algorithm>
+
+// 写入槽位，JSON类型的值需要完整的json
+static void copySlot(Context& target, const Context& source, SlotId slot) {
+    const Scalar& value = source.getSlot(slot);
+    if (value.isJson()) {
+        target.setSlot(slot, source.getSlotJson(slot));
+    } else {
+        target.setSlot(slot, value);
+    }
+}
+
+// Snapshot 实现
+SharedContext::Snapshot::Snapshot(Snapshot&& other) noexcept
+    : slot_(other.slot_), version_(other.version_) {
+    other.slot_ = nullptr;
+}
+
+SharedContext::Snapshot& SharedContext::Snapshot::operator=(Snapshot&& other) noexcept {
+    if (this != &other) {
+        if (slot_) slot_->refs.fetch_sub(1);
+        slot_ = other.slot_;
+        version_ = other.version_;
+        other.slot_ = nullptr;
+    }
+    return *this;
+}
+
+SharedContext::Snapshot::~Snapshot() {
+    if (slot_) slot_->refs.fetch_sub(1);
+}
+
+const Context& SharedContext::Snapshot::context() const {
+    return slot_->ctx;
+}
+
+void SharedContext::Snapshot::syncTo(Context& local, uint64_t& synced) const {
+    const Context& source = slot_->ctx;
+    if (synced == 0 || source.resetVersion() > synced) {
+        local = source;
+    } else {
+        vector<SlotId> slots;
+        source.changedSince(synced, slots);
+        for (SlotId slot : slots) {
+            copySlot(local, source, slot);
+        }
+    }
+    synced = source.version();
+}
+
+// SharedContext 实现
+SharedContext::SharedContext(size_t ring_size)
+    : ring_size_(min<size_t>(max<size_t>(ring_size, 2), size_t(1) << INDEX_BITS)) {
+    ring_.reset(new Slot[ring_size_]);
+    ring_[0].version = 1;
+    current_.store((uint64_t(1) << INDEX_BITS) | 0);
+}
+
+SharedContext::Snapshot SharedContext::snapshot() const {
+    while (true) {
+        uint64_t token = current_.load();
+        Slot& slot = ring_[token & ((1u << INDEX_BITS) - 1)];
+        uint32_t refs = slot.refs.fetch_add(1);
+        // 增加引用后当前版本未变，说明该元素不会被写入方复用
+        if (!(refs & WRITING) && current_.load() == token) {
+            return Snapshot(&slot, token >> INDEX_BITS);
+        }
+        slot.refs.fetch_sub(1);
+    }
+}
+
+uint64_t SharedContext::version() const {
+    return current_.load() >> INDEX_BITS;
+}
+
+void SharedContext::set(const string& key, const Value& value) {
+    setSlot(SymbolTable::global().intern(key), value);
+}
+
+void SharedContext::setSlot(SlotId slot, const Value& value) {
+    update([&](Context& ctx) { ctx.setSlot(slot, value); });
+}
+
+void SharedContext::setSlot(SlotId slot, const Scalar& value) {
+    update([&](Context& ctx) { ctx.setSlot(slot, value); });
+}
+
+void SharedContext::update(const function<void(Context&)>& fn) {
+    lock_guard<mutex> lock(write_mutex_);
+
+    uint64_t token = current_.load();
+    size_t current_index = token & ((1u << INDEX_BITS) - 1);
+    size_t next_index = claim(current_index);
+
+    // 写时复制：当前版本只会被写入方替换，持有写锁时可以安全读取
+    Slot& next = ring_[next_index];
+    next.ctx.syncFrom(ring_[current_index].ctx);
+    fn(next.ctx);
+    next.version = (token >> INDEX_BITS) + 1;
+
+    next.refs.fetch_sub(WRITING);
+    current_.store((next.version << INDEX_BITS) | next_index);
+}
+
+void SharedContext::merge(const Context& local, uint64_t since, uint64_t base) {
+    vector<SlotId> slots;
+    local.changedSince(since, slots);
+    if (slots.empty()) return;
+    update([&](Context& ctx) {
+        for (SlotId slot : slots) {
+            if (ctx.slotVersion(slot) > base) continue;
+            copySlot(ctx, local, slot);
+        }
+    });
+}
+
+size_t SharedContext::claim(size_t current_index) {
+    while (true) {
+        for (size_t i = 1; i < ring_size_; ++i) {
+            size_t index = (current_index + i) % ring_size_;
+            uint32_t expected = 0;
+            if (ring_[index].refs.compare_exchange_strong(expected, WRITING)) {
+                return index;
+            }
+        }
+        // 所有元素都被快照引用，等待读取方释放
+        this_thread::yield();
+    }
+}
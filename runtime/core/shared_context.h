@@ -0,0 +1,93 @@
+#pragma once
+
+#include "context.h"
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <functional>
+
+using namespace std;
+
+// 多线程共享的Context：写入方以写时复制方式发布新版本，读取方无锁获取一致的快照
+// 内部为固定大小的Context环，每个元素带引用计数；写入方把一个无人引用的元素更新到当前版本
+// （元素保存的是较早发布的版本，只复制之后写入的槽位），修改后原子地发布为当前版本。读取方只做原子加减，不会阻塞写入方，也不会看到写了一半的数据
+class SharedContext {
+private:
+    struct Slot;
+
+public:
+    // 只读快照（RAII，析构时释放）
+    class Snapshot {
+    public:
+        Snapshot() : slot_(nullptr), version_(0) {}
+        Snapshot(Snapshot&& other) noexcept;
+        Snapshot& operator=(Snapshot&& other) noexcept;
+        ~Snapshot();
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        const Context& context() const;
+        const Context* operator->() const { return &context(); }
+
+        // 发布序号，每次发布加1，可用于判断数据是否变化
+        uint64_t version() const { return version_; }
+
+        explicit operator bool() const { return slot_ != nullptr; }
+
+        // 将快照同步到本地Context：synced为上次同步到的快照Context版本（首次为0），
+        // 只复制之后写入的槽位；发布链中发生过clear时整体复制
+        void syncTo(Context& local, uint64_t& synced) const;
+
+    private:
+        friend class SharedContext;
+        Snapshot(Slot* slot, uint64_t version) : slot_(slot), version_(version) {}
+
+        Slot* slot_;
+        uint64_t version_;
+    };
+
+    // ring_size为环中Context的个数，同时持有的快照数超过ring_size-2时写入方需等待快照释放
+    explicit SharedContext(size_t ring_size = 8);
+
+    SharedContext(const SharedContext&) = delete;
+    SharedContext& operator=(const SharedContext&) = delete;
+
+    // 获取当前版本的快照（无锁）
+    Snapshot snapshot() const;
+
+    // 当前发布序号
+    uint64_t version() const;
+
+    // 写入单个值并发布新版本
+    void set(const string& key, const Value& value);
+    void setSlot(SlotId slot, const Value& value);
+    void setSlot(SlotId slot, const Scalar& value);
+
+    // 在新版本上执行多次修改，一次发布
+    void update(const function<void(Context&)>& fn);
+
+    // 将本地Context中版本号大于since的槽位写回并发布（本地执行动作后使用）
+    // base为本地Context同步到的快照Context版本（syncTo的synced）：之后被其他写入方修改过的槽位保留对方的值
+    void merge(const Context& local, uint64_t since, uint64_t base);
+
+private:
+    struct Slot {
+        Context ctx;
+        atomic<uint32_t> refs;      // 读取方引用数，最高位表示写入方占用
+        uint64_t version;
+
+        Slot() : refs(0), version(0) {}
+    };
+
+    static constexpr uint32_t WRITING = 1u << 31;
+    static constexpr uint64_t INDEX_BITS = 8;   // current_低8位为环下标
+
+    unique_ptr<Slot[]> ring_;
+    size_t ring_size_;
+    atomic<uint64_t> current_;      // (发布序号 << INDEX_BITS) | 环下标
+    mutex write_mutex_;             // 写入方之间互斥，读取方不使用
+
+    // 占用一个无人引用的非当前元素
+    size_t claim(size_t current_index);
+};
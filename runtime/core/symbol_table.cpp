@@ -0,0 +1,42 @@
+#include "symbol_table.h"
+#include <mutex>
+
+// SymbolTable 实现
+SymbolTable& SymbolTable::global() {
+    static SymbolTable table;
+    return table;
+}
+
+SlotId SymbolTable::intern(const string& key) {
+    {
+        shared_lock<shared_mutex> lock(mutex_);
+        auto it = slots_.find(key);
+        if (it != slots_.end()) return it->second;
+    }
+
+    unique_lock<shared_mutex> lock(mutex_);
+    auto it = slots_.find(key);
+    if (it != slots_.end()) return it->second;
+
+    SlotId slot = static_cast<SlotId>(names_.size());
+    names_.push_back(key);
+    slots_.emplace(key, slot);
+    return slot;
+}
+
+SlotId SymbolTable::lookup(const string& key) const {
+    shared_lock<shared_mutex> lock(mutex_);
+    auto it = slots_.find(key);
+    return (it != slots_.end()) ? it->second : INVALID_SLOT;
+}
+
+const string& SymbolTable::name(SlotId slot) const {
+    static const string empty;
+    shared_lock<shared_mutex> lock(mutex_);
+    return (slot < names_.size()) ? names_[slot] : empty;
+}
+
+size_t SymbolTable::size() const {
+    shared_lock<shared_mutex> lock(mutex_);
+    return names_.size();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+#include <cstdint>
+
+using namespace std;
+
+// 槽位编号，传感器键名在加载时被映射为稠密整数
+using SlotId = uint32_t;
+
+// 无效槽位
+constexpr SlotId INVALID_SLOT = UINT32_MAX;
+
+// 符号表：键名 <-> 槽位 的双向映射
+// 规则加载和表达式解析时注册键名，运行时只使用槽位访问Context
+class SymbolTable {
+public:
+    // 获取全局符号表
+    static SymbolTable& global();
+
+    // 注册键名，返回其槽位（已注册则返回原槽位）
+    SlotId intern(const string& key);
+
+    // 查找键名对应的槽位，未注册返回INVALID_SLOT
+    SlotId lookup(const string& key) const;
+
+    // 获取槽位对应的键名
+    const string& name(SlotId slot) const;
+
+    // 获取已注册的槽位数量
+    size_t size() const;
+
+private:
+    mutable shared_mutex mutex_;
+    unordered_map<string, SlotId> slots_;
+    deque<string> names_;   // deque扩容时不移动已有元素，name()返回的引用保持有效
+};
@@ -0,0 +1,291 @@
+#include "trace.h"
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+
+// TraceRecorder 实现
+TraceRecorder::TraceRecorder() : start_us_(0), last_us_(0), count_(0), flushed_us_(0), unflushed_(0) {
+}
+
+TraceRecorder::~TraceRecorder() {
+    close();
+}
+
+bool TraceRecorder::open(const string& path) {
+    lock_guard<mutex> lock(mutex_);
+    if (file_.is_open()) file_.close();
+    file_.open(path, ios::binary | ios::trunc);
+    if (!file_) return false;
+    file_.write(TRACE_MAGIC, sizeof(TRACE_MAGIC) - 1);
+    start_us_ = now_us();
+    last_us_ = 0;
+    count_ = 0;
+    flushed_us_ = start_us_;
+    unflushed_ = 0;
+    keys_.clear();
+    return true;
+}
+
+void TraceRecorder::close() {
+    lock_guard<mutex> lock(mutex_);
+    if (file_.is_open()) file_.close();
+}
+
+bool TraceRecorder::isOpen() const {
+    lock_guard<mutex> lock(mutex_);
+    return file_.is_open();
+}
+
+void TraceRecorder::flush() {
+    lock_guard<mutex> lock(mutex_);
+    if (!file_.is_open()) return;
+    file_.flush();
+    flushed_us_ = now_us();
+    unflushed_ = 0;
+}
+
+void TraceRecorder::record(SlotId slot, const Scalar& value) {
+    lock_guard<mutex> lock(mutex_);
+    if (!file_.is_open()) return;
+    writeEvent(now_us() - start_us_, slot, value, Value());
+}
+
+void TraceRecorder::record(SlotId slot, const Value& value) {
+    Scalar scalar = Scalar::fromJson(value);
+    lock_guard<mutex> lock(mutex_);
+    if (!file_.is_open()) return;
+    writeEvent(now_us() - start_us_, slot, scalar, scalar.isJson() ? value : Value());
+}
+
+void TraceRecorder::recordAt(uint64_t time_us, SlotId slot, const Scalar& value, const Value& object) {
+    lock_guard<mutex> lock(mutex_);
+    if (!file_.is_open()) return;
+    writeEvent(time_us, slot, value, object);
+}
+
+uint64_t TraceRecorder::count() const {
+    lock_guard<mutex> lock(mutex_);
+    return count_;
+}
+
+void TraceRecorder::writeVarint(uint64_t value) {
+    char buffer[10];
+    size_t size = 0;
+    while (value >= 0x80) {
+        buffer[size++] = static_cast<char>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    buffer[size++] = static_cast<char>(value);
+    file_.write(buffer, size);
+}
+
+void TraceRecorder::writeEvent(uint64_t time_us, SlotId slot, const Scalar& value, const Value& object) {
+    // 键第一次出现时写入定义
+    auto it = keys_.find(slot);
+    if (it == keys_.end()) {
+        uint32_t id = static_cast<uint32_t>(keys_.size());
+        it = keys_.emplace(slot, id).first;
+        const string& name = SymbolTable::global().name(slot);
+        file_.put('K');
+        writeVarint(id);
+        writeVarint(name.size());
+        file_.write(name.data(), name.size());
+    }
+
+    // 时间不会倒退（多个线程交错写入时按0处理）
+    uint64_t delta = (time_us > last_us_) ? time_us - last_us_ : 0;
+    last_us_ = max(last_us_, time_us);
+
+    file_.put('S');
+    writeVarint(delta);
+    writeVarint(it->second);
+    file_.put(static_cast<char>(value.type()));
+    switch (value.type()) {
+        case ScalarType::NUL:
+            break;
+        case ScalarType::BOOL:
+            file_.put(value.asBool() ? 1 : 0);
+            break;
+        case ScalarType::INT: {
+            int64_t v = value.asInt();
+            writeVarint((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+            break;
+        }
+        case ScalarType::DOUBLE: {
+            double v = value.asDouble();
+            char bytes[8];
+            memcpy(bytes, &v, sizeof(bytes));
+            file_.write(bytes, sizeof(bytes));
+            break;
+        }
+        case ScalarType::STRING: {
+            string_view text = value.str();
+            writeVarint(text.size());
+            file_.write(text.data(), text.size());
+            break;
+        }
+        case ScalarType::JSON: {
+            string text = object.dump();
+            writeVarint(text.size());
+            file_.write(text.data(), text.size());
+            break;
+        }
+    }
+    count_++;
+
+    // 按写入数或时间刷新，被杀死的进程也留下可读的轨迹
+    uint64_t now = now_us();
+    if (++unflushed_ >= FLUSH_EVENTS || now - flushed_us_ >= FLUSH_INTERVAL_US) {
+        file_.flush();
+        flushed_us_ = now;
+        unflushed_ = 0;
+    }
+}
+
+uint64_t TraceRecorder::now_us() {
+    return chrono::duration_cast<chrono::microseconds>(
+        chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+// TraceReader 实现
+TraceReader::TraceReader() : time_us_(0), finished_(false), truncated_(false) {
+}
+
+bool TraceReader::open(const string& path) {
+    file_.open(path, ios::binary);
+    if (!file_) return false;
+    char magic[sizeof(TRACE_MAGIC) - 1];
+    file_.read(magic, sizeof(magic));
+    time_us_ = 0;
+    slots_.clear();
+    finished_ = false;
+    truncated_ = false;
+    return file_ && memcmp(magic, TRACE_MAGIC, sizeof(magic)) == 0;
+}
+
+bool TraceReader::next(TraceEvent& event) {
+    if (readEvent(event)) return true;
+    // 在记录中间遇到文件结束：不完整的末尾记录，而不是格式错误
+    truncated_ = !finished_ && file_.eof();
+    return false;
+}
+
+bool TraceReader::readEvent(TraceEvent& event) {
+    while (true) {
+        int tag = file_.get();
+        if (tag == EOF) {
+            finished_ = true;
+            return false;
+        }
+
+        if (tag == 'K') {
+            uint64_t id;
+            string name;
+            if (!readVarint(id) || !readString(name)) return false;
+            // 录制器按顺序分配键编号
+            if (id != slots_.size()) return false;
+            slots_.push_back(SymbolTable::global().intern(name));
+            continue;
+        }
+        if (tag != 'S') return false;
+
+        uint64_t delta, id;
+        if (!readVarint(delta) || !readVarint(id) || id >= slots_.size()) return false;
+        time_us_ += delta;
+        event.time_us = time_us_;
+        event.slot = slots_[id];
+        event.object = Value();
+
+        int type = file_.get();
+        switch (static_cast<ScalarType>(type)) {
+            case ScalarType::NUL:
+                event.value = Scalar();
+                break;
+            case ScalarType::BOOL:
+                event.value = Scalar::fromBool(file_.get() != 0);
+                break;
+            case ScalarType::INT: {
+                uint64_t raw;
+                if (!readVarint(raw)) return false;
+                event.value = Scalar::fromInt(static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1));
+                break;
+            }
+            case ScalarType::DOUBLE: {
+                char bytes[8];
+                double v;
+                file_.read(bytes, sizeof(bytes));
+                memcpy(&v, bytes, sizeof(v));
+                event.value = Scalar::fromDouble(v);
+                break;
+            }
+            case ScalarType::STRING: {
+                string text;
+                if (!readString(text)) return false;
+                event.value = Scalar::fromString(text);
+                break;
+            }
+            case ScalarType::JSON: {
+                string text;
+                if (!readString(text)) return false;
+                event.object = json::parse(text, nullptr, false);
+                event.value = Scalar::fromJson(event.object);
+                break;
+            }
+            default:
+                return false;
+        }
+        return static_cast<bool>(file_);
+    }
+}
+
+bool TraceReader::finished() const {
+    return finished_;
+}
+
+bool TraceReader::truncated() const {
+    return truncated_;
+}
+
+bool TraceReader::readAll(const string& path, vector<TraceEvent>& events) {
+    TraceReader reader;
+    if (!reader.open(path)) return false;
+    TraceEvent event;
+    while (reader.next(event)) {
+        events.push_back(event);
+    }
+    if (reader.truncated()) {
+        cerr << "Warning: trace " << path << " ends with a truncated record, read "
+             << events.size() << " complete events" << endl;
+        return true;
+    }
+    return reader.finished();
+}
+
+bool TraceReader::readVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = file_.get();
+        if (byte == EOF) return false;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+bool TraceReader::readString(string& value) {
+    uint64_t size;
+    if (!readVarint(size) || size > MAX_STRING) return false;
+    value.resize(size);
+    file_.read(&value[0], size);
+    return static_cast<bool>(file_);
+}
+
+void applyTraceEvent(Context& ctx, const TraceEvent& event) {
+    if (event.value.isJson()) {
+        ctx.setSlot(event.slot, event.object);
+    } else {
+        ctx.setSlot(event.slot, event.value);
+    }
+}
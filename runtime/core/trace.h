@@ -0,0 +1,109 @@
+#pragma once
+
+#include "context.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+
+using namespace std;
+
+// 传感器轨迹文件：按时间顺序记录对Context的写入，用于回放和吞吐量测试
+// 格式：魔数"SNPTRC1\n"之后是记录序列，整数均为无符号varint
+//   'K' 键定义：编号、名称长度、名称（键第一次出现时写入）
+//   'S' 写入：距上一条写入的微秒数、键编号、值
+// 值：类型字节（ScalarType）+ 内容
+//   NUL无内容，BOOL一字节，INT为zigzag编码的varint，DOUBLE为8字节，STRING/JSON为长度和文本
+static const char TRACE_MAGIC[] = "SNPTRC1\n";
+
+// 一次写入
+struct TraceEvent {
+    uint64_t time_us;       // 相对录制开始的时间
+    SlotId slot;
+    Scalar value;
+    Value object;           // value为JSON类型时的完整值
+};
+
+// 轨迹录制器：挂到Context上后记录每一次set
+// 可被多个Context共享，写入加锁；每FLUSH_EVENTS次写入或FLUSH_INTERVAL_US微秒刷新一次文件，
+// 进程被杀死时最多丢失最后一批写入
+class TraceRecorder {
+public:
+    static constexpr uint32_t FLUSH_EVENTS = 256;
+    static constexpr uint64_t FLUSH_INTERVAL_US = 100000;
+
+    TraceRecorder();
+    ~TraceRecorder();
+
+    // 创建轨迹文件，时间从此刻开始计算
+    bool open(const string& path);
+    void close();
+    bool isOpen() const;
+
+    // 把缓冲的写入刷新到文件
+    void flush();
+
+    // 以当前时间记录一次写入
+    void record(SlotId slot, const Scalar& value);
+    void record(SlotId slot, const Value& value);
+
+    // 以指定时间记录（用于生成合成轨迹，时间需要非递减）
+    void recordAt(uint64_t time_us, SlotId slot, const Scalar& value, const Value& object = Value());
+
+    // 已记录的写入数
+    uint64_t count() const;
+
+private:
+    mutable mutex mutex_;
+    ofstream file_;
+    uint64_t start_us_;
+    uint64_t last_us_;
+    uint64_t count_;
+    uint64_t flushed_us_;                   // 上次刷新的时间
+    uint32_t unflushed_;                    // 上次刷新后的写入数
+    unordered_map<SlotId, uint32_t> keys_;  // 槽位 -> 文件中的键编号
+
+    void writeVarint(uint64_t value);
+    void writeEvent(uint64_t time_us, SlotId slot, const Scalar& value, const Value& object);
+    static uint64_t now_us();
+};
+
+// 轨迹读取器
+class TraceReader {
+public:
+    // 字符串/JSON值的最大长度，超过视为格式错误
+    static constexpr uint64_t MAX_STRING = 64ull << 20;
+
+    TraceReader();
+
+    // 打开轨迹文件并检查魔数
+    bool open(const string& path);
+
+    // 读取下一次写入，文件结束或格式错误时返回false
+    bool next(TraceEvent& event);
+
+    // 文件是否完整读完（next返回false后区分正常结束和格式错误）
+    bool finished() const;
+
+    // 文件在记录中间结束（录制进程被杀死时最后一条记录常常不完整）
+    bool truncated() const;
+
+    // 读取整个文件；末尾不完整的记录被丢弃并给出警告，文件中间的格式错误返回false
+    static bool readAll(const string& path, vector<TraceEvent>& events);
+
+private:
+    ifstream file_;
+    uint64_t time_us_;
+    vector<SlotId> slots_;      // 文件中的键编号 -> 槽位
+    bool finished_;
+    bool truncated_;
+
+    bool readEvent(TraceEvent& event);
+    bool readVarint(uint64_t& value);
+    bool readString(string& value);
+};
+
+// 把事件写入Context
+void applyTraceEvent(Context& ctx, const TraceEvent& event);
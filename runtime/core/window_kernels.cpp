@@ -0,0 +1,282 @@
+#include "window_kernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SNIPPER_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+// 各级别实现的函数表
+struct KernelTable {
+    double (*sum)(const double*, size_t);
+    double (*min)(const double*, size_t);
+    double (*max)(const double*, size_t);
+    double (*squaredDeviation)(const double*, size_t, double);
+};
+
+// ---------------- 标量实现 ----------------
+
+static double scalarSum(const double* data, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) sum += data[i];
+    return sum;
+}
+
+static double scalarMin(const double* data, size_t n) {
+    double result = data[0];
+    for (size_t i = 1; i < n; ++i) result = std::min(result, data[i]);
+    return result;
+}
+
+static double scalarMax(const double* data, size_t n) {
+    double result = data[0];
+    for (size_t i = 1; i < n; ++i) result = std::max(result, data[i]);
+    return result;
+}
+
+static double scalarSquaredDeviation(const double* data, size_t n, double mean) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double d = data[i] - mean;
+        sum += d * d;
+    }
+    return sum;
+}
+
+static const KernelTable SCALAR_KERNELS = {scalarSum, scalarMin, scalarMax, scalarSquaredDeviation};
+
+#ifdef SNIPPER_X86_KERNELS
+
+// ---------------- SSE4.1：每次2个，4路累加 ----------------
+
+__attribute__((target("sse4.1")))
+static double sseSum(const double* data, size_t n) {
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd(), acc2 = _mm_setzero_pd(), acc3 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(data + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(data + i + 2));
+        acc2 = _mm_add_pd(acc2, _mm_loadu_pd(data + i + 4));
+        acc3 = _mm_add_pd(acc3, _mm_loadu_pd(data + i + 6));
+    }
+    __m128d acc = _mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3));
+    double sum = _mm_cvtsd_f64(_mm_add_sd(acc, _mm_unpackhi_pd(acc, acc)));
+    for (; i < n; ++i) sum += data[i];
+    return sum;
+}
+
+__attribute__((target("sse4.1")))
+static double sseMin(const double* data, size_t n) {
+    if (n < 4) return scalarMin(data, n);
+    __m128d acc0 = _mm_loadu_pd(data), acc1 = _mm_loadu_pd(data + 2);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_min_pd(acc0, _mm_loadu_pd(data + i));
+        acc1 = _mm_min_pd(acc1, _mm_loadu_pd(data + i + 2));
+    }
+    __m128d acc = _mm_min_pd(acc0, acc1);
+    double result = _mm_cvtsd_f64(_mm_min_sd(acc, _mm_unpackhi_pd(acc, acc)));
+    for (; i < n; ++i) result = std::min(result, data[i]);
+    return result;
+}
+
+__attribute__((target("sse4.1")))
+static double sseMax(const double* data, size_t n) {
+    if (n < 4) return scalarMax(data, n);
+    __m128d acc0 = _mm_loadu_pd(data), acc1 = _mm_loadu_pd(data + 2);
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_max_pd(acc0, _mm_loadu_pd(data + i));
+        acc1 = _mm_max_pd(acc1, _mm_loadu_pd(data + i + 2));
+    }
+    __m128d acc = _mm_max_pd(acc0, acc1);
+    double result = _mm_cvtsd_f64(_mm_max_sd(acc, _mm_unpackhi_pd(acc, acc)));
+    for (; i < n; ++i) result = std::max(result, data[i]);
+    return result;
+}
+
+__attribute__((target("sse4.1")))
+static double sseSquaredDeviation(const double* data, size_t n, double mean) {
+    __m128d m = _mm_set1_pd(mean);
+    __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128d d0 = _mm_sub_pd(_mm_loadu_pd(data + i), m);
+        __m128d d1 = _mm_sub_pd(_mm_loadu_pd(data + i + 2), m);
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(d0, d0));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(d1, d1));
+    }
+    __m128d acc = _mm_add_pd(acc0, acc1);
+    double sum = _mm_cvtsd_f64(_mm_add_sd(acc, _mm_unpackhi_pd(acc, acc)));
+    for (; i < n; ++i) {
+        double d = data[i] - mean;
+        sum += d * d;
+    }
+    return sum;
+}
+
+static const KernelTable SSE4_KERNELS = {sseSum, sseMin, sseMax, sseSquaredDeviation};
+
+// ---------------- AVX2：每次4个，4路累加 ----------------
+
+__attribute__((target("avx2")))
+static double reduceAdd(__m256d v) {
+    __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+}
+
+__attribute__((target("avx2")))
+static double avxSum(const double* data, size_t n) {
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    __m256d acc2 = _mm256_setzero_pd(), acc3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(data + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(data + i + 4));
+        acc2 = _mm256_add_pd(acc2, _mm256_loadu_pd(data + i + 8));
+        acc3 = _mm256_add_pd(acc3, _mm256_loadu_pd(data + i + 12));
+    }
+    double sum = reduceAdd(_mm256_add_pd(_mm256_add_pd(acc0, acc1), _mm256_add_pd(acc2, acc3)));
+    for (; i < n; ++i) sum += data[i];
+    return sum;
+}
+
+__attribute__((target("avx2")))
+static double avxMin(const double* data, size_t n) {
+    if (n < 8) return scalarMin(data, n);
+    __m256d acc0 = _mm256_loadu_pd(data), acc1 = _mm256_loadu_pd(data + 4);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_min_pd(acc0, _mm256_loadu_pd(data + i));
+        acc1 = _mm256_min_pd(acc1, _mm256_loadu_pd(data + i + 4));
+    }
+    __m256d acc = _mm256_min_pd(acc0, acc1);
+    __m128d half = _mm_min_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    double result = _mm_cvtsd_f64(_mm_min_sd(half, _mm_unpackhi_pd(half, half)));
+    for (; i < n; ++i) result = std::min(result, data[i]);
+    return result;
+}
+
+__attribute__((target("avx2")))
+static double avxMax(const double* data, size_t n) {
+    if (n < 8) return scalarMax(data, n);
+    __m256d acc0 = _mm256_loadu_pd(data), acc1 = _mm256_loadu_pd(data + 4);
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_max_pd(acc0, _mm256_loadu_pd(data + i));
+        acc1 = _mm256_max_pd(acc1, _mm256_loadu_pd(data + i + 4));
+    }
+    __m256d acc = _mm256_max_pd(acc0, acc1);
+    __m128d half = _mm_max_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    double result = _mm_cvtsd_f64(_mm_max_sd(half, _mm_unpackhi_pd(half, half)));
+    for (; i < n; ++i) result = std::max(result, data[i]);
+    return result;
+}
+
+__attribute__((target("avx2")))
+static double avxSquaredDeviation(const double* data, size_t n, double mean) {
+    __m256d m = _mm256_set1_pd(mean);
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(data + i), m);
+        __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(data + i + 4), m);
+        acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(d0, d0));
+        acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(d1, d1));
+    }
+    double sum = reduceAdd(_mm256_add_pd(acc0, acc1));
+    for (; i < n; ++i) {
+        double d = data[i] - mean;
+        sum += d * d;
+    }
+    return sum;
+}
+
+static const KernelTable AVX2_KERNELS = {avxSum, avxMin, avxMax, avxSquaredDeviation};
+
+#endif
+
+static const KernelTable* tableFor(KernelLevel level) {
+#ifdef SNIPPER_X86_KERNELS
+    if (level == KERNEL_AVX2) return &AVX2_KERNELS;
+    if (level == KERNEL_SSE4) return &SSE4_KERNELS;
+#endif
+    (void)level;
+    return &SCALAR_KERNELS;
+}
+
+static atomic<KernelLevel> g_level(WindowKernels::detect());
+
+static const KernelTable& kernels() {
+    return *tableFor(g_level.load(memory_order_relaxed));
+}
+
+// WindowKernels 实现
+KernelLevel WindowKernels::detect() {
+#ifdef SNIPPER_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return KERNEL_AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return KERNEL_SSE4;
+#endif
+    return KERNEL_SCALAR;
+}
+
+KernelLevel WindowKernels::level() {
+    return g_level.load(memory_order_relaxed);
+}
+
+KernelLevel WindowKernels::setLevel(KernelLevel level) {
+    KernelLevel actual = std::min(level, detect());
+    g_level.store(actual, memory_order_relaxed);
+    return actual;
+}
+
+const char* WindowKernels::levelName(KernelLevel level) {
+    switch (level) {
+        case KERNEL_AVX2: return "avx2";
+        case KERNEL_SSE4: return "sse4";
+        default: return "scalar";
+    }
+}
+
+double WindowKernels::sum(const double* data, size_t n) {
+    return n ? kernels().sum(data, n) : 0.0;
+}
+
+double WindowKernels::min(const double* data, size_t n) {
+    return n ? kernels().min(data, n) : 0.0;
+}
+
+double WindowKernels::max(const double* data, size_t n) {
+    return n ? kernels().max(data, n) : 0.0;
+}
+
+double WindowKernels::squaredDeviation(const double* data, size_t n, double mean) {
+    return n ? kernels().squaredDeviation(data, n, mean) : 0.0;
+}
+
+double WindowKernels::stddev(const double* data, size_t n) {
+    if (n == 0) return 0.0;
+    const KernelTable& table = kernels();
+    double mean = table.sum(data, n) / n;
+    return sqrt(table.squaredDeviation(data, n, mean) / n);
+}
+
+double WindowKernels::percentile(double* data, size_t n, double p) {
+    if (n == 0) return 0.0;
+    p = std::min(std::max(p, 0.0), 100.0);
+
+    // 第rank个（从0开始）样本，rank为小数时与下一个样本线性插值
+    double rank = p / 100.0 * (n - 1);
+    size_t lower = static_cast<size_t>(rank);
+    nth_element(data, data + lower, data + n);
+    double value = data[lower];
+    if (lower + 1 < n && rank > lower) {
+        // nth_element之后，lower之后的最小值即下一个样本
+        double next = kernels().min(data + lower + 1, n - lower - 1);
+        value += (rank - lower) * (next - value);
+    }
+    return value;
+}
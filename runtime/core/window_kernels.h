@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+// 内核指令集级别
+enum KernelLevel {
+    KERNEL_SCALAR,
+    KERNEL_SSE4,
+    KERNEL_AVX2
+};
+
+// 连续double数组上的窗口聚合内核
+// 启动时按CPU支持选择AVX2、SSE4.1或标量实现（x86以外只有标量实现），不需要额外的编译选项；
+// 向量实现的累加顺序不同，和与标准差和标量实现可能有末位误差
+class WindowKernels {
+public:
+    // CPU支持的最高级别
+    static KernelLevel detect();
+
+    // 当前使用的级别
+    static KernelLevel level();
+
+    // 指定级别（用于测试和基准对比），超过CPU支持时使用支持的最高级别；返回实际级别
+    static KernelLevel setLevel(KernelLevel level);
+
+    static const char* levelName(KernelLevel level);
+
+    // 聚合：n为0时返回0
+    static double sum(const double* data, size_t n);
+    static double min(const double* data, size_t n);
+    static double max(const double* data, size_t n);
+
+    // Σ(x - mean)²
+    static double squaredDeviation(const double* data, size_t n, double mean);
+
+    // 总体标准差（两遍计算）
+    static double stddev(const double* data, size_t n);
+
+    // 第p百分位数（0~100，相邻样本线性插值）；会重排data
+    static double percentile(double* data, size_t n, double p);
+};
@@ -0,0 +1,82 @@
+#include "worker_pool.h"
+#include <algorithm>
+
+// WorkerPool 实现
+WorkerPool::WorkerPool(size_t threads)
+    : job_(nullptr), count_(0), grain_(1), next_(0), active_(0), generation_(0), stop_(false) {
+    for (size_t i = 1; i < threads; ++i) {
+        threads_.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& t : threads_) {
+        t.join();
+    }
+}
+
+size_t WorkerPool::size() const {
+    return threads_.size() + 1;
+}
+
+void WorkerPool::parallelFor(size_t count, size_t grain, const ShardFn& fn) {
+    if (count == 0) return;
+    grain = max<size_t>(grain, 1);
+
+    // 只有一个分片时没有必要唤醒工作线程
+    if (threads_.empty() || count <= grain) {
+        fn(0, count);
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(mutex_);
+        job_ = &fn;
+        count_ = count;
+        grain_ = grain;
+        next_.store(0, memory_order_relaxed);
+        active_ = threads_.size();
+        generation_++;
+    }
+    work_cv_.notify_all();
+
+    runShards();
+
+    unique_lock<mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return active_ == 0; });
+    job_ = nullptr;
+}
+
+void WorkerPool::workerLoop() {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> lock(mutex_);
+            work_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+
+        runShards();
+
+        {
+            lock_guard<mutex> lock(mutex_);
+            if (--active_ == 0) {
+                done_cv_.notify_one();
+            }
+        }
+    }
+}
+
+void WorkerPool::runShards() {
+    while (true) {
+        size_t begin = next_.fetch_add(grain_, memory_order_relaxed);
+        if (begin >= count_) return;
+        (*job_)(begin, min(begin + grain_, count_));
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+using namespace std;
+
+// 固定大小的工作线程池，用于把一段下标区间切分成分片并行处理
+class WorkerPool {
+public:
+    // 分片处理函数，处理 [begin, end) 区间
+    using ShardFn = function<void(size_t begin, size_t end)>;
+
+    // threads为参与计算的线程总数（含调用线程）
+    explicit WorkerPool(size_t threads);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // 参与计算的线程总数
+    size_t size() const;
+
+    // 将 [0, count) 按grain大小切分并行执行，调用线程同样参与，全部完成后返回
+    void parallelFor(size_t count, size_t grain, const ShardFn& fn);
+
+private:
+    vector<thread> threads_;
+    mutex mutex_;
+    condition_variable work_cv_;
+    condition_variable done_cv_;
+
+    // 当前任务
+    const ShardFn* job_;
+    size_t count_;
+    size_t grain_;
+    atomic<size_t> next_;       // 下一个待领取的起始下标
+    size_t active_;             // 仍在处理当前任务的工作线程数
+    uint64_t generation_;       // 任务代数，工作线程据此发现新任务
+    bool stop_;
+
+    void workerLoop();
+    void runShards();
+};
@@ -0,0 +1,286 @@
+#include "expr_infix_parser.h"
+#include <cctype>
+#include <cstdlib>
+#include <cerrno>
+
+static bool isIdentStart(char c) {
+    return isalpha(static_cast<unsigned char>(c)) || c == '_';
+}
+
+static bool isIdentChar(char c) {
+    return isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.';
+}
+
+// InfixParser 实现
+InfixParser::InfixParser(const string& text)
+    : text_(text), pos_(0), depth_(0) {
+}
+
+shared_ptr<ExprNode> InfixParser::parse() {
+    error_.clear();
+    pos_ = 0;
+    depth_ = 0;
+    next();
+
+    shared_ptr<ExprNode> root = parseBinary(1);
+    if (!root) return nullptr;
+    if (token_.type == TOK_ERROR) {
+        return fail(token_.text, token_.pos);
+    }
+    if (token_.type != TOK_END) {
+        return fail("unexpected trailing '" + token_.text + "'", token_.pos);
+    }
+    return root;
+}
+
+void InfixParser::next() {
+    while (pos_ < text_.size() && isspace(static_cast<unsigned char>(text_[pos_]))) pos_++;
+
+    token_.pos = pos_;
+    token_.text.clear();
+    if (pos_ >= text_.size()) {
+        token_.type = TOK_END;
+        return;
+    }
+
+    char c = text_[pos_];
+
+    // 数字：整数或小数，可带指数
+    if (isdigit(static_cast<unsigned char>(c)) ||
+        (c == '.' && pos_ + 1 < text_.size() && isdigit(static_cast<unsigned char>(text_[pos_ + 1])))) {
+        size_t start = pos_;
+        while (pos_ < text_.size() && (isdigit(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '.')) pos_++;
+        if (pos_ < text_.size() && (text_[pos_] == 'e' || text_[pos_] == 'E')) {
+            size_t exponent = pos_ + 1;
+            if (exponent < text_.size() && (text_[exponent] == '+' || text_[exponent] == '-')) exponent++;
+            if (exponent < text_.size() && isdigit(static_cast<unsigned char>(text_[exponent]))) {
+                pos_ = exponent;
+                while (pos_ < text_.size() && isdigit(static_cast<unsigned char>(text_[pos_]))) pos_++;
+            }
+        }
+        token_.type = TOK_NUMBER;
+        token_.text = text_.substr(start, pos_ - start);
+        return;
+    }
+
+    // 字符串：单引号或双引号
+    if (c == '\'' || c == '"') {
+        pos_++;
+        while (pos_ < text_.size() && text_[pos_] != c) {
+            char ch = text_[pos_++];
+            if (ch == '\\' && pos_ < text_.size()) {
+                char escaped = text_[pos_++];
+                switch (escaped) {
+                    case 'n': ch = '\n'; break;
+                    case 't': ch = '\t'; break;
+                    default: ch = escaped; break;
+                }
+            }
+            token_.text += ch;
+        }
+        if (pos_ >= text_.size()) {
+            token_.type = TOK_ERROR;
+            token_.text = "unterminated string";
+            return;
+        }
+        pos_++;
+        token_.type = TOK_STRING;
+        return;
+    }
+
+    if (isIdentStart(c)) {
+        size_t start = pos_;
+        while (pos_ < text_.size() && isIdentChar(text_[pos_])) pos_++;
+        token_.type = TOK_IDENT;
+        token_.text = text_.substr(start, pos_ - start);
+        return;
+    }
+
+    switch (c) {
+        case '(': token_.type = TOK_LPAREN; token_.text = "("; pos_++; return;
+        case ')': token_.type = TOK_RPAREN; token_.text = ")"; pos_++; return;
+        case ',': token_.type = TOK_COMMA; token_.text = ","; pos_++; return;
+        default: break;
+    }
+
+    // 操作符：先匹配两个字符的
+    static const char* two[] = {"&&", "||", "==", "!=", ">=", "<="};
+    for (const char* op : two) {
+        if (text_.compare(pos_, 2, op) == 0) {
+            token_.type = TOK_OPERATOR;
+            token_.text = op;
+            pos_ += 2;
+            return;
+        }
+    }
+    if (string("+-*/%<>!").find(c) != string::npos) {
+        token_.type = TOK_OPERATOR;
+        token_.text = string(1, c);
+        pos_++;
+        return;
+    }
+
+    token_.type = TOK_ERROR;
+    token_.text = string("unexpected character '") + c + "'";
+}
+
+int InfixParser::precedence(const string& op) {
+    if (op == "||") return 1;
+    if (op == "&&") return 2;
+    if (op == "==" || op == "!=") return 3;
+    if (op == "<" || op == ">" || op == "<=" || op == ">=") return 4;
+    if (op == "+" || op == "-") return 5;
+    if (op == "*" || op == "/" || op == "%") return 6;
+    return 0;
+}
+
+shared_ptr<ExprNode> InfixParser::parseBinary(int min_precedence) {
+    shared_ptr<ExprNode> left = parseUnary();
+    if (!left) return nullptr;
+
+    while (token_.type == TOK_OPERATOR) {
+        int prec = precedence(token_.text);
+        if (prec == 0) {
+            return fail("'" + token_.text + "' is not a binary operator", token_.pos);
+        }
+        if (prec < min_precedence) break;
+
+        string op = token_.text;
+        next();
+        shared_ptr<ExprNode> right = parseBinary(prec + 1);
+        if (!right) return nullptr;
+        left = makeOp(op, move(left), move(right));
+    }
+    return left;
+}
+
+shared_ptr<ExprNode> InfixParser::parseUnary() {
+    if (token_.type == TOK_ERROR) return fail(token_.text, token_.pos);
+    if (token_.type == TOK_END) return fail("unexpected end of expression", token_.pos);
+    if (++depth_ > MAX_DEPTH) return fail("expression nested too deeply", token_.pos);
+
+    shared_ptr<ExprNode> node;
+    Token token = token_;
+
+    switch (token.type) {
+        case TOK_OPERATOR: {
+            if (token.text != "-" && token.text != "!") {
+                return fail("unexpected operator '" + token.text + "'", token.pos);
+            }
+            next();
+            shared_ptr<ExprNode> operand = parseUnary();
+            if (!operand) return nullptr;
+            if (token.text == "-") {
+                // 数字字面量直接取负，与JSON中的负数相同
+                if (operand->type == EXPR_VALUE && operand->literal.isNumber()) {
+                    const Scalar& value = operand->literal;
+                    node = makeValue(value.type() == ScalarType::INT ? Scalar::fromInt(-value.asInt())
+                                                                     : Scalar::fromDouble(-value.asDouble()));
+                } else {
+                    node = makeOp("-", makeValue(Scalar::fromInt(0)), operand);
+                }
+            } else {
+                // 没有一元操作节点：!x 表示为 (x || false) == false
+                node = makeOp("==", makeOp("||", operand, makeValue(Scalar::fromBool(false))),
+                              makeValue(Scalar::fromBool(false)));
+            }
+            break;
+        }
+
+        case TOK_NUMBER: {
+            const char* begin = token.text.c_str();
+            char* end = nullptr;
+            errno = 0;
+            if (token.text.find_first_of(".eE") == string::npos) {
+                long long value = strtoll(begin, &end, 10);
+                node = (errno == ERANGE) ? makeValue(Scalar::fromDouble(strtod(begin, nullptr)))
+                                         : makeValue(Scalar::fromInt(value));
+            } else {
+                node = makeValue(Scalar::fromDouble(strtod(begin, &end)));
+            }
+            if (end != begin + token.text.size()) {
+                return fail("invalid number '" + token.text + "'", token.pos);
+            }
+            next();
+            break;
+        }
+
+        case TOK_STRING:
+            node = makeValue(Scalar::fromLiteral(token.text));
+            next();
+            break;
+
+        case TOK_IDENT: {
+            next();
+            if (token.text == "true" || token.text == "false") {
+                node = makeValue(Scalar::fromBool(token.text == "true"));
+            } else if (token.text == "null") {
+                node = makeValue(Scalar());
+            } else if (token_.type == TOK_LPAREN) {
+                // 函数调用
+                node = make_shared<ExprNode>(EXPR_FUNC);
+                node->func_name = token.text;
+                next();
+                if (token_.type != TOK_RPAREN) {
+                    while (true) {
+                        shared_ptr<ExprNode> arg = parseBinary(1);
+                        if (!arg) return nullptr;
+                        node->children.push_back(move(arg));
+                        if (token_.type == TOK_COMMA) {
+                            next();
+                            continue;
+                        }
+                        break;
+                    }
+                }
+                if (token_.type != TOK_RPAREN) {
+                    return fail("missing ')' after arguments of " + token.text, token_.pos);
+                }
+                next();
+            } else {
+                node = make_shared<ExprNode>(EXPR_VAR);
+                node->value = token.text;
+                node->slot = SymbolTable::global().intern(node->value);
+            }
+            break;
+        }
+
+        case TOK_LPAREN:
+            next();
+            node = parseBinary(1);
+            if (!node) return nullptr;
+            if (token_.type != TOK_RPAREN) {
+                return fail("missing ')'", token_.pos);
+            }
+            next();
+            break;
+
+        default:
+            return fail("unexpected '" + token.text + "'", token.pos);
+    }
+
+    depth_--;
+    return node;
+}
+
+shared_ptr<ExprNode> InfixParser::fail(const string& message, size_t pos) {
+    if (error_.empty()) {
+        error_ = "at position " + to_string(pos) + ": " + message;
+    }
+    return nullptr;
+}
+
+shared_ptr<ExprNode> InfixParser::makeValue(const Scalar& value) {
+    auto node = make_shared<ExprNode>(EXPR_VALUE);
+    node->literal = value;
+    node->value = value.toJson().dump();
+    return node;
+}
+
+shared_ptr<ExprNode> InfixParser::makeOp(const string& op, shared_ptr<ExprNode> left, shared_ptr<ExprNode> right) {
+    auto node = make_shared<ExprNode>(EXPR_OP);
+    node->op = op;
+    node->children.push_back(move(left));
+    node->children.push_back(move(right));
+    return node;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "expression.h"
+#include <string>
+#include <memory>
+
+using namespace std;
+
+// 中缀表达式解析（Pratt算法），生成与JSON表达式相同结构的ExprNode树
+// 语法：
+//   - 二元操作符按优先级从低到高：||；&&；== !=；< > <= >=；+ -；* / %，同级左结合
+//   - 一元操作符：-x（数字字面量直接取负，其余为0 - x）、!x（即(x || false) == false）
+//   - 字面量：整数、小数、'字符串'或"字符串"（支持\转义）、true、false、null
+//   - 变量：字母或下划线开头，可包含数字、下划线和点
+//   - 函数调用：name(arg, ...)；括号改变优先级
+class InfixParser {
+public:
+    explicit InfixParser(const string& text);
+
+    // 解析整个表达式；语法错误时返回nullptr，error()给出错误位置和原因
+    shared_ptr<ExprNode> parse();
+
+    const string& error() const { return error_; }
+
+private:
+    static const int MAX_DEPTH = 256;   // 括号和一元操作符的最大嵌套深度
+
+    enum TokenType {
+        TOK_END,
+        TOK_NUMBER,
+        TOK_STRING,
+        TOK_IDENT,
+        TOK_OPERATOR,
+        TOK_LPAREN,
+        TOK_RPAREN,
+        TOK_COMMA,
+        TOK_ERROR
+    };
+
+    struct Token {
+        TokenType type = TOK_END;
+        string text;        // 操作符、标识符、数字原文或解码后的字符串
+        size_t pos = 0;     // 在原文中的位置
+    };
+
+    const string& text_;
+    size_t pos_;
+    Token token_;
+    int depth_;
+    string error_;
+
+    // 读取下一个记号
+    void next();
+
+    // 解析优先级不低于min_precedence的二元表达式
+    shared_ptr<ExprNode> parseBinary(int min_precedence);
+
+    // 解析一元表达式、字面量、变量、函数调用和括号
+    shared_ptr<ExprNode> parseUnary();
+
+    // 二元操作符的优先级，不是二元操作符时返回0
+    static int precedence(const string& op);
+
+    // 记录第一个错误，返回nullptr
+    shared_ptr<ExprNode> fail(const string& message, size_t pos);
+
+    static shared_ptr<ExprNode> makeValue(const Scalar& value);
+    static shared_ptr<ExprNode> makeOp(const string& op, shared_ptr<ExprNode> left, shared_ptr<ExprNode> right);
+};
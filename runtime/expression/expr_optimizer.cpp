@@ -0,0 +1,189 @@
+#include "expr_optimizer.h"
+#include "string_matcher.h"
+#include <iostream>
+
+// 结果与输入无关的函数（按参数计算）
+static bool isPureFunction(const string& name) {
+    return name == "contains" || name == "starts_with" || name == "ends_with";
+}
+
+// 按加载时编译的模式匹配字符串的函数
+static bool isMatchFunction(const string& name) {
+    StringMatcher::Kind kind;
+    return StringMatcher::kindOf(name, kind);
+}
+
+// 有已知实现的函数
+static bool isKnownFunction(const string& name) {
+    return isPureFunction(name) || isMatchFunction(name) || name == "time_between" || name == "day_of_week" ||
+           ExprNode::isHistoryFunction(name);
+}
+
+static bool isKnownOperator(const string& op) {
+    static const char* ops[] = {"+", "-", "*", "/", "%", "&&", "||", "==", "!=", ">", "<", ">=", "<="};
+    for (const char* known : ops) {
+        if (op == known) return true;
+    }
+    return false;
+}
+
+// ExprOptimizer 实现
+shared_ptr<ExprNode> ExprOptimizer::optimize(const shared_ptr<ExprNode>& root, Stats* stats) {
+    if (!root) return root;
+    Stats local;
+    return optimizeNode(root, stats ? *stats : local);
+}
+
+bool ExprOptimizer::isConstant(const ExprNode& node) {
+    return node.type == EXPR_VALUE;
+}
+
+bool ExprOptimizer::isBoolean(const ExprNode& node) {
+    switch (node.type) {
+        case EXPR_VALUE:
+            return node.literal.isBool();
+        case EXPR_OP:
+            return node.children.size() >= 2 && isKnownOperator(node.op) &&
+                   node.op != "+" && node.op != "-" && node.op != "*" && node.op != "/" && node.op != "%";
+        case EXPR_FUNC:
+            return (isPureFunction(node.func_name) || isMatchFunction(node.func_name)) && node.children.size() >= 2;
+        default:
+            return false;
+    }
+}
+
+shared_ptr<ExprNode> ExprOptimizer::makeConstant(const Scalar& value) {
+    auto node = make_shared<ExprNode>(EXPR_VALUE);
+    node->literal = value;
+    node->value = value.toJson().dump();
+    return node;
+}
+
+void ExprOptimizer::prepareTimeArgs(ExprNode& node, Stats& stats) {
+    bool is_between = node.func_name == "time_between";
+    for (auto& child : node.children) {
+        if (!child) continue;
+        bool named = child->type == EXPR_VAR;
+        bool text = child->type == EXPR_VALUE && child->literal.isString();
+        if (!named && !text) continue;
+
+        string_view name = named ? string_view(child->value) : child->literal.str();
+        if (named && name == "now") {
+            child = makeConstant(Scalar::fromLiteral("now"));
+            stats.times++;
+            continue;
+        }
+        int minute = is_between ? ClockSnapshot::parseTimeOfDay(name) : -1;
+        if (minute >= 0) {
+            child = makeConstant(Scalar::fromInt(minute));
+            stats.times++;
+        }
+    }
+}
+
+shared_ptr<ExprNode> ExprOptimizer::prepareMatcher(const shared_ptr<ExprNode>& node, Stats& stats) {
+    StringMatcher::Kind kind = StringMatcher::MATCH_REGEX;
+    StringMatcher::kindOf(node->func_name, kind);
+
+    vector<Scalar> patterns;
+    bool constant = true;
+    for (size_t i = 1; i < node->children.size(); ++i) {
+        shared_ptr<ExprNode>& child = node->children[i];
+        if (child && child->type == EXPR_VAR) {
+            child = makeConstant(Scalar::fromLiteral(child->value));
+        }
+        if (!child || !isConstant(*child)) {
+            constant = false;
+            break;
+        }
+        patterns.push_back(child->literal);
+    }
+
+    node->matcher = nullptr;
+    if (!constant) {
+        cerr << "Pattern of " << node->func_name << "() must be constant" << endl;
+    } else {
+        string error;
+        node->matcher = StringMatcher::compile(kind, patterns, &error);
+        if (node->matcher) {
+            stats.matchers++;
+        } else {
+            cerr << "Invalid pattern in " << node->func_name << "(): " << error << endl;
+        }
+    }
+
+    // 被匹配的值也是常量：直接求值
+    if (isConstant(*node->children[0])) {
+        static const Context empty;
+        stats.folded++;
+        return makeConstant(node->evaluateTree(empty));
+    }
+    return node;
+}
+
+shared_ptr<ExprNode> ExprOptimizer::optimizeNode(const shared_ptr<ExprNode>& node, Stats& stats) {
+    if (node->type == EXPR_VALUE || node->type == EXPR_VAR) return node;
+
+    // 结果恒为空值：未知操作符/函数、参数不足（与ExprNode::evaluateTree的分支一致）
+    bool known = (node->type == EXPR_OP) ? isKnownOperator(node->op) && node->children.size() >= 2
+                                         : isKnownFunction(node->func_name) && !node->children.empty();
+    if (known && node->type == EXPR_FUNC) {
+        size_t required = 2;
+        if (node->func_name == "time_between" || node->func_name == "percentile_last_n") required = 3;
+        if (node->func_name == "day_of_week") required = 1;
+        known = node->children.size() >= required;
+    }
+    if (!known) {
+        stats.folded++;
+        return makeConstant(Scalar());
+    }
+
+    for (auto& child : node->children) {
+        if (child) child = optimizeNode(child, stats);
+    }
+
+    if (node->type == EXPR_FUNC && isMatchFunction(node->func_name)) {
+        return prepareMatcher(node, stats);
+    }
+
+    // 时间和历史函数依赖当前时间或历史数据，不折叠
+    if (node->type == EXPR_FUNC && !isPureFunction(node->func_name)) {
+        if (node->func_name == "time_between" || node->func_name == "day_of_week") {
+            prepareTimeArgs(*node, stats);
+        }
+        return node;
+    }
+
+    const ExprNode& left = *node->children[0];
+    const ExprNode& right = *node->children[1];
+
+    // 全部操作数为常量：在空Context上求值
+    if (isConstant(left) && isConstant(right)) {
+        static const Context empty;
+        stats.folded++;
+        return makeConstant(node->evaluateTree(empty));
+    }
+
+    // 布尔恒等式
+    if (node->type == EXPR_OP && (node->op == "&&" || node->op == "||")) {
+        bool is_and = node->op == "&&";
+        for (int side = 0; side < 2; ++side) {
+            const ExprNode& constant = side ? right : left;
+            const shared_ptr<ExprNode>& other = node->children[side ? 0 : 1];
+            if (!isConstant(constant)) continue;
+
+            bool value = constant.literal.truthy();
+            if (value != is_and) {
+                // x && false -> false；x || true -> true
+                stats.simplified++;
+                return makeConstant(Scalar::fromBool(value));
+            }
+            if (isBoolean(*other)) {
+                // x && true -> x；x || false -> x
+                stats.simplified++;
+                return other;
+            }
+        }
+    }
+    return node;
+}
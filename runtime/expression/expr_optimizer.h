@@ -0,0 +1,48 @@
+#pragma once
+
+#include "expression.h"
+#include <memory>
+
+using namespace std;
+
+// 表达式优化：解析之后、编译字节码之前执行
+// - 常量子表达式折叠为值节点（字面量在解析时已解码为Scalar）
+// - 布尔恒等式化简：x && false、false && x 为false，x || true、true || x 为true；
+//   x && true、x || false 在x本身为布尔值时化简为x
+// - 无论输入如何结果都不变的分支（未知操作符、参数不足的函数）替换为常量
+// - 时间函数的参数：变量now换成字符串常量"now"（求值时取时钟快照），
+//   time_between中写成 "HH:MM" 的变量名或字符串常量换算为当天的分钟数，求值时只做整数比较
+// - matches/contains_any/equals_any：模式参数中的变量名视为字符串常量，编译为StringMatcher；
+//   模式不是常量或正则语法错误时结果为false（输出到cerr）
+// 表达式没有副作用，删除的分支不影响结果；化简后的表达式与原表达式对任意Context求值结果相同
+class ExprOptimizer {
+public:
+    // 优化统计
+    struct Stats {
+        size_t folded = 0;      // 折叠为常量的节点数
+        size_t simplified = 0;  // 按布尔恒等式化简的节点数
+        size_t times = 0;       // 加载时换算的时间参数数
+        size_t matchers = 0;    // 编译的字符串匹配数
+    };
+
+    // 优化表达式树，返回优化后的根节点（可能是新节点）
+    static shared_ptr<ExprNode> optimize(const shared_ptr<ExprNode>& root, Stats* stats = nullptr);
+
+    // 节点是否为常量（值节点）
+    static bool isConstant(const ExprNode& node);
+
+    // 节点的结果是否总是布尔值
+    static bool isBoolean(const ExprNode& node);
+
+private:
+    static shared_ptr<ExprNode> optimizeNode(const shared_ptr<ExprNode>& node, Stats& stats);
+
+    // 时间函数的参数换算（见类注释）
+    static void prepareTimeArgs(ExprNode& node, Stats& stats);
+
+    // 编译字符串匹配函数的模式（见类注释）
+    static shared_ptr<ExprNode> prepareMatcher(const shared_ptr<ExprNode>& node, Stats& stats);
+
+    // 创建常量节点
+    static shared_ptr<ExprNode> makeConstant(const Scalar& value);
+};
@@ -0,0 +1,236 @@
+#include "expr_program.h"
+#include "string_matcher.h"
+#include "../condition/operators.h"
+#include <sstream>
+#include <new>
+
+// 操作符 -> 操作码
+static bool binaryOpCode(const string& op, ExprOpCode& code) {
+    static const pair<const char*, ExprOpCode> table[] = {
+        {"+", OP_ADD}, {"-", OP_SUB}, {"*", OP_MUL}, {"/", OP_DIV}, {"%", OP_MOD},
+        {"&&", OP_JUMP_FALSE}, {"||", OP_JUMP_TRUE},
+        {"==", OP_EQ}, {"!=", OP_NE}, {">", OP_GT}, {"<", OP_LT}, {">=", OP_GE}, {"<=", OP_LE}
+    };
+    for (const auto& item : table) {
+        if (op == item.first) {
+            code = item.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+static const char* opCodeName(ExprOpCode op) {
+    static const char* names[] = {
+        "CONST", "LOAD", "LOAD_KEY", "NIL", "ADD", "SUB", "MUL", "DIV", "MOD",
+        "EQ", "NE", "GT", "LT", "GE", "LE", "CONTAINS", "STARTS_WITH", "ENDS_WITH", "CALL",
+        "JUMP_FALSE", "JUMP_TRUE", "BOOL", "MATCH"
+    };
+    return op <= OP_MATCH ? names[op] : "?";
+}
+
+// ExprProgram 实现
+shared_ptr<const ExprProgram> ExprProgram::compile(const ExprNode& root) {
+    auto program = make_shared<ExprProgram>();
+    if (!program->emit(root, nullptr, 0)) {
+        return nullptr;
+    }
+    return program;
+}
+
+void ExprProgram::push(ExprOpCode op, uint32_t arg, size_t depth) {
+    code_.push_back({op, arg});
+    max_stack_ = max(max_stack_, depth + 1);
+}
+
+bool ExprProgram::emit(const ExprNode& node, const shared_ptr<ExprNode>& owner, size_t depth) {
+    if (depth >= MAX_STACK) return false;
+
+    // 谓词网络中的共享子树不内联，调用节点求值以使用按Context版本缓存的结果
+    if (owner && (node.type == EXPR_OP || node.type == EXPR_FUNC) && node.shared.load(memory_order_relaxed)) {
+        push(OP_CALL, static_cast<uint32_t>(calls_.size()), depth);
+        calls_.push_back(owner);
+        return true;
+    }
+
+    // 与ExprNode::evaluateTree的分支一一对应；不影响结果的子节点不编译
+    switch (node.type) {
+        case EXPR_VALUE:
+            push(OP_CONST, static_cast<uint32_t>(constants_.size()), depth);
+            constants_.push_back(node.literal);
+            return true;
+
+        case EXPR_VAR:
+            if (node.slot != INVALID_SLOT) {
+                push(OP_LOAD, node.slot, depth);
+            } else {
+                push(OP_LOAD_KEY, static_cast<uint32_t>(keys_.size()), depth);
+                keys_.push_back(node.value);
+            }
+            return true;
+
+        case EXPR_OP: {
+            ExprOpCode code;
+            if (node.children.size() < 2 || !binaryOpCode(node.op, code)) {
+                push(OP_NIL, 0, depth);
+                return true;
+            }
+            if (!node.children[0] || !node.children[1]) return false;
+            if (!emit(*node.children[0], node.children[0], depth)) return false;
+            
+            // 逻辑运算短路：左操作数决定结果时跳过右操作数
+            if (code == OP_JUMP_FALSE || code == OP_JUMP_TRUE) {
+                size_t jump = code_.size();
+                push(code, 0, depth);
+                if (!emit(*node.children[1], node.children[1], depth)) return false;
+                push(OP_BOOL, 0, depth);
+                code_[jump].arg = static_cast<uint32_t>(code_.size());
+                return true;
+            }
+            
+            if (!emit(*node.children[1], node.children[1], depth + 1)) return false;
+            push(code, 0, depth);
+            return true;
+        }
+
+        case EXPR_FUNC: {
+            ExprOpCode code;
+            if (node.func_name == "contains") {
+                code = OP_CONTAINS;
+            } else if (node.func_name == "starts_with") {
+                code = OP_STARTS_WITH;
+            } else if (node.func_name == "ends_with") {
+                code = OP_ENDS_WITH;
+            } else if (node.func_name == "matches" || node.func_name == "contains_any" ||
+                       node.func_name == "equals_any") {
+                if (node.children.empty()) {
+                    push(OP_NIL, 0, depth);
+                    return true;
+                }
+                if (!node.matcher || !node.children[0]) {
+                    push(OP_CONST, static_cast<uint32_t>(constants_.size()), depth);
+                    constants_.push_back(Scalar::fromBool(false));
+                    return true;
+                }
+                if (!emit(*node.children[0], node.children[0], depth)) return false;
+                push(OP_MATCH, static_cast<uint32_t>(matchers_.size()), depth);
+                matchers_.push_back(node.matcher);
+                return true;
+            } else if (node.func_name == "time_between" || node.func_name == "day_of_week" ||
+                       ExprNode::isHistoryFunction(node.func_name)) {
+                // 时间和历史函数读取时钟快照或历史窗口，调用节点按Scalar求值；根节点不持有自身
+                if (!owner) return false;
+                push(OP_CALL, static_cast<uint32_t>(calls_.size()), depth);
+                calls_.push_back(owner);
+                return true;
+            } else {
+                push(OP_NIL, 0, depth);
+                return true;
+            }
+
+            if (node.children.size() < 2) {
+                push(OP_NIL, 0, depth);
+                return true;
+            }
+            if (!node.children[0] || !node.children[1]) return false;
+            if (!emit(*node.children[0], node.children[0], depth)) return false;
+            if (!emit(*node.children[1], node.children[1], depth + 1)) return false;
+            push(code, 0, depth);
+            return true;
+        }
+    }
+    return false;
+}
+
+Scalar ExprProgram::run(const Context& ctx) const {
+    // 栈不初始化，只在压栈时构造，出栈时析构
+    alignas(Scalar) unsigned char storage[MAX_STACK * sizeof(Scalar)];
+    Scalar* stack = reinterpret_cast<Scalar*>(storage);
+    size_t sp = 0;
+
+    const size_t count = code_.size();
+    for (size_t pc = 0; pc < count; ++pc) {
+        const ExprInstruction& ins = code_[pc];
+        switch (ins.op) {
+            case OP_CONST:
+                new (&stack[sp++]) Scalar(constants_[ins.arg]);
+                break;
+            case OP_LOAD:
+                new (&stack[sp++]) Scalar(ctx.getSlot(ins.arg));
+                break;
+            case OP_LOAD_KEY:
+                new (&stack[sp++]) Scalar(Scalar::fromJson(ctx.get(keys_[ins.arg])));
+                break;
+            case OP_NIL:
+                new (&stack[sp++]) Scalar();
+                break;
+            case OP_CALL:
+                new (&stack[sp++]) Scalar(calls_[ins.arg]->evaluateScalar(ctx));
+                break;
+            case OP_JUMP_FALSE:
+            case OP_JUMP_TRUE: {
+                bool value = stack[sp - 1].truthy();
+                if (value == (ins.op == OP_JUMP_TRUE)) {
+                    stack[sp - 1] = Scalar::fromBool(value);
+                    pc = ins.arg - 1;
+                } else {
+                    stack[--sp].~Scalar();
+                }
+                break;
+            }
+            case OP_BOOL:
+                stack[sp - 1] = Scalar::fromBool(stack[sp - 1].truthy());
+                break;
+            case OP_MATCH:
+                stack[sp - 1] = Scalar::fromBool(matchers_[ins.arg]->match(stack[sp - 1]));
+                break;
+            default: {
+                // 二元操作：结果覆盖左操作数
+                const Scalar& right = stack[--sp];
+                Scalar& left = stack[sp - 1];
+                switch (ins.op) {
+                    case OP_ADD: left = Eval::add(left, right); break;
+                    case OP_SUB: left = Eval::subtract(left, right); break;
+                    case OP_MUL: left = Eval::multiply(left, right); break;
+                    case OP_DIV: left = Eval::divide(left, right); break;
+                    case OP_MOD: left = Eval::modulo(left, right); break;
+                    case OP_EQ: left = Scalar::fromBool(left == right); break;
+                    case OP_NE: left = Scalar::fromBool(left != right); break;
+                    case OP_GT: left = Scalar::fromBool(left > right); break;
+                    case OP_LT: left = Scalar::fromBool(left < right); break;
+                    case OP_GE: left = Scalar::fromBool(left >= right); break;
+                    case OP_LE: left = Scalar::fromBool(left <= right); break;
+                    case OP_CONTAINS: left = Eval::string_contains(left, right); break;
+                    case OP_STARTS_WITH: left = Eval::string_starts_with(left, right); break;
+                    case OP_ENDS_WITH: left = Eval::string_ends_with(left, right); break;
+                    default: left = Scalar(); break;
+                }
+                stack[sp].~Scalar();
+                break;
+            }
+        }
+    }
+    Scalar result = sp ? stack[0] : Scalar();
+    while (sp) stack[--sp].~Scalar();
+    return result;
+}
+
+string ExprProgram::disassemble() const {
+    ostringstream out;
+    for (size_t i = 0; i < code_.size(); ++i) {
+        const ExprInstruction& ins = code_[i];
+        out << i << "\t" << opCodeName(ins.op);
+        switch (ins.op) {
+            case OP_CONST: out << "\t" << constants_[ins.arg].toJson().dump(); break;
+            case OP_LOAD: out << "\t" << SymbolTable::global().name(ins.arg); break;
+            case OP_LOAD_KEY: out << "\t" << keys_[ins.arg]; break;
+            case OP_CALL: out << "\t" << calls_[ins.arg]->func_name; break;
+            case OP_MATCH: out << "\t" << matchers_[ins.arg]->size() << " patterns"; break;
+            case OP_JUMP_FALSE:
+            case OP_JUMP_TRUE: out << "\t" << ins.arg; break;
+            default: break;
+        }
+        out << "\n";
+    }
+    return out.str();
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "expression.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+using namespace std;
+
+// 字节码操作码
+enum ExprOpCode : uint8_t {
+    OP_CONST,       // 压入常量池中的常量（参数：常量下标）
+    OP_LOAD,        // 压入槽位的值（参数：槽位）
+    OP_LOAD_KEY,    // 按键名读取Context（参数：键名下标），槽位未解析的变量
+    OP_NIL,         // 压入空值
+    OP_ADD,         // 以下二元操作弹出右、左操作数，压入结果
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_MOD,
+    OP_EQ,
+    OP_NE,
+    OP_GT,
+    OP_LT,
+    OP_GE,
+    OP_LE,
+    OP_CONTAINS,
+    OP_STARTS_WITH,
+    OP_ENDS_WITH,
+    OP_CALL,        // 对节点求值后压入结果（参数：节点下标），用于时间和历史函数以及共享子树（使用其缓存结果）
+    OP_JUMP_FALSE,  // &&短路：栈顶为假时改为false并跳转到参数处，否则弹出
+    OP_JUMP_TRUE,   // ||短路：栈顶为真时改为true并跳转到参数处，否则弹出
+    OP_BOOL,        // 栈顶转换为布尔值
+    OP_MATCH        // 栈顶替换为字符串匹配的结果（参数：匹配器下标）
+};
+
+// 一条指令（8字节）
+struct ExprInstruction {
+    ExprOpCode op;
+    uint32_t arg;
+};
+
+// 表达式字节码程序：由表达式树按后序编译得到，在栈式虚拟机上执行
+// 操作符和函数名在编译时解析为操作码，变量解析为槽位，常量放入常量池；执行时不分配内存
+class ExprProgram {
+public:
+    // 虚拟机栈深度上限，超过时不编译，继续使用树遍历
+    static constexpr size_t MAX_STACK = 64;
+
+    // 编译表达式树，无法编译时返回空
+    static shared_ptr<const ExprProgram> compile(const ExprNode& root);
+
+    // 执行程序，结果与ExprNode::evaluateTree相同
+    Scalar run(const Context& ctx) const;
+
+    // 指令数和所需栈深度
+    size_t size() const { return code_.size(); }
+    size_t stackDepth() const { return max_stack_; }
+
+    // 反汇编（调试用）
+    string disassemble() const;
+
+private:
+    vector<ExprInstruction> code_;
+    vector<Scalar> constants_;                  // 常量池
+    vector<string> keys_;                       // OP_LOAD_KEY的键名
+    vector<shared_ptr<const ExprNode>> calls_;  // OP_CALL的节点
+    vector<shared_ptr<const StringMatcher>> matchers_;  // OP_MATCH的匹配器
+    size_t max_stack_ = 0;
+
+    // 编译一个节点，结果压在深度depth处；owner为持有该节点的指针（根节点为空）
+    // 超过栈深度上限或根节点需要OP_CALL时返回false
+    bool emit(const ExprNode& node, const shared_ptr<ExprNode>& owner, size_t depth);
+    
+    // 追加一条指令，结果位于深度depth处
+    void push(ExprOpCode op, uint32_t arg, size_t depth);
+};
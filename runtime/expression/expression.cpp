@@ -1,93 +1,201 @@
 #include "expression.h"
+#include "expr_program.h"
+#include "expr_optimizer.h"
+#include "expr_infix_parser.h"
+#include "string_matcher.h"
 #include "../condition/operators.h"
 #include <iostream>
+#include <cstring>
+
+// ExprMemo 实现
+ExprMemo::ExprMemo() : state_(0) {
+    words_[0].store(0, memory_order_relaxed);
+    words_[1].store(0, memory_order_relaxed);
+}
+
+bool ExprMemo::load(uint64_t version, Scalar& value) const {
+    uint64_t before = state_.load(memory_order_acquire);
+    if (before != version * 2) return false;
+    
+    uint64_t words[2] = {
+        words_[0].load(memory_order_relaxed),
+        words_[1].load(memory_order_relaxed)
+    };
+    atomic_thread_fence(memory_order_acquire);
+    if (state_.load(memory_order_relaxed) != before) return false;
+    
+    // 缓存中只有不持有堆内存的值，按字节复制出来
+    Scalar cached;
+    memcpy(reinterpret_cast<char*>(&cached), words, sizeof(words));
+    value = cached;
+    return true;
+}
+
+void ExprMemo::store(uint64_t version, const Scalar& value) {
+    // 堆上的长字符串有引用计数，不能按字节缓存
+    if (value.ownsHeap()) return;
+    uint64_t state = state_.load(memory_order_relaxed);
+    if ((state & 1) || !state_.compare_exchange_strong(state, state | 1, memory_order_acquire)) {
+        return;
+    }
+    atomic_thread_fence(memory_order_release);
+    
+    uint64_t words[2];
+    memcpy(words, reinterpret_cast<const char*>(&value), sizeof(words));
+    words_[0].store(words[0], memory_order_relaxed);
+    words_[1].store(words[1], memory_order_relaxed);
+    state_.store(version * 2, memory_order_release);
+}
+
+static_assert(sizeof(Scalar) == 2 * sizeof(uint64_t), "ExprMemo stores Scalar as two words");
 
 // ExprNode 实现
-ExprNode::ExprNode() : type(EXPR_VALUE) {
+ExprNode::ExprNode() : type(EXPR_VALUE), slot(INVALID_SLOT), shared(false) {
 }
 
-ExprNode::ExprNode(ExprType t) : type(t) {
+ExprNode::ExprNode(ExprType t) : type(t), slot(INVALID_SLOT), shared(false) {
 }
 
 Value ExprNode::evaluate(const Context& ctx) const {
+    // 变量可能是对象/数组，直接取json
+    if (type == EXPR_VAR) {
+        return (slot != INVALID_SLOT) ? ctx.getSlotJson(slot) : ctx.get(value);
+    }
+    return evaluateScalar(ctx).toJson();
+}
+
+// 历史函数的变量参数：变量节点取其名称，其余取求值得到的字符串
+static SlotId historySlot(const ExprNode& arg, const Context& ctx) {
+    if (arg.type == EXPR_VAR && arg.slot != INVALID_SLOT) return arg.slot;
+    if (arg.type == EXPR_VAR) return SymbolTable::global().lookup(arg.value);
+    Scalar name = arg.evaluateScalar(ctx);
+    return name.isString() ? SymbolTable::global().lookup(string(name.str())) : INVALID_SLOT;
+}
+
+Scalar ExprNode::evaluateScalar(const Context& ctx) const {
+    if (!shared.load(memory_order_relaxed)) return evaluateNode(ctx);
+    
+    // 共享子树：同一Context版本只求值一次
+    Scalar value;
+    if (memo_.load(ctx.version(), value)) {
+        return value;
+    }
+    value = evaluateNode(ctx);
+    memo_.store(ctx.version(), value);
+    return value;
+}
+
+Scalar ExprNode::evaluateNode(const Context& ctx) const {
+    if (program) return program->run(ctx);
+    return evaluateTree(ctx);
+}
+
+Scalar ExprNode::evaluateTree(const Context& ctx) const {
     switch (type) {
         case EXPR_VALUE:
-            return Value(value);
+            return literal;
             
         case EXPR_VAR:
-            return ctx.get(value);
+            return (slot != INVALID_SLOT) ? ctx.getSlot(slot) : Scalar::fromJson(ctx.get(value));
             
         case EXPR_OP: {
-            if (children.size() < 2) return Value();
+            if (children.size() < 2) return Scalar();
             
-            Value left = children[0]->evaluate(ctx);
-            Value right = children[1]->evaluate(ctx);
+            // 逻辑运算短路：左操作数已决定结果时不再求值右操作数
+            if (op == "&&" || op == "||") {
+                bool is_and = (op == "&&");
+                bool left = children[0]->evaluateScalar(ctx).truthy();
+                if (left != is_and) return Scalar::fromBool(left);
+                return Scalar::fromBool(children[1]->evaluateScalar(ctx).truthy());
+            }
+            
+            Scalar left = children[0]->evaluateScalar(ctx);
+            Scalar right = children[1]->evaluateScalar(ctx);
             
             if (op == "+") return Eval::add(left, right);
             if (op == "-") return Eval::subtract(left, right);
             if (op == "*") return Eval::multiply(left, right);
             if (op == "/") return Eval::divide(left, right);
             if (op == "%") return Eval::modulo(left, right);
-            if (op == "&&") return Eval::logical_and(left, right);
-            if (op == "||") return Eval::logical_or(left, right);
-            if (op == "==") return left == right;
-            if (op == "!=") return left != right;
-            if (op == ">") return left > right;
-            if (op == "<") return left < right;
-            if (op == ">=") return left >= right;
-            if (op == "<=") return left <= right;
+            if (op == "==") return Scalar::fromBool(left == right);
+            if (op == "!=") return Scalar::fromBool(left != right);
+            if (op == ">") return Scalar::fromBool(left > right);
+            if (op == "<") return Scalar::fromBool(left < right);
+            if (op == ">=") return Scalar::fromBool(left >= right);
+            if (op == "<=") return Scalar::fromBool(left <= right);
             
-            return Value();
+            return Scalar();
         }
         
         case EXPR_FUNC: {
-            if (children.empty()) return Value();
+            if (children.empty()) return Scalar();
             
             if (func_name == "contains") {
                 if (children.size() >= 2) {
-                    return Eval::string_contains(children[0]->evaluate(ctx), children[1]->evaluate(ctx));
+                    return Eval::string_contains(children[0]->evaluateScalar(ctx), children[1]->evaluateScalar(ctx));
                 }
             } else if (func_name == "starts_with") {
                 if (children.size() >= 2) {
-                    return Eval::string_starts_with(children[0]->evaluate(ctx), children[1]->evaluate(ctx));
+                    return Eval::string_starts_with(children[0]->evaluateScalar(ctx), children[1]->evaluateScalar(ctx));
                 }
             } else if (func_name == "ends_with") {
                 if (children.size() >= 2) {
-                    return Eval::string_ends_with(children[0]->evaluate(ctx), children[1]->evaluate(ctx));
+                    return Eval::string_ends_with(children[0]->evaluateScalar(ctx), children[1]->evaluateScalar(ctx));
                 }
             } else if (func_name == "time_between") {
                 if (children.size() >= 3) {
-                    return Eval::time_between(children[0]->evaluate(ctx), children[1]->evaluate(ctx), children[2]->evaluate(ctx));
+                    return Eval::time_between(ctx, children[0]->evaluateScalar(ctx), children[1]->evaluateScalar(ctx),
+                                              children[2]->evaluateScalar(ctx));
                 }
             } else if (func_name == "day_of_week") {
                 if (children.size() >= 1) {
-                    return Eval::day_of_week(children[0]->evaluate(ctx));
+                    return Eval::day_of_week(ctx, children[0]->evaluateScalar(ctx));
                 }
             } else if (func_name == "avg_last_n") {
                 if (children.size() >= 2) {
-                    string var = children[0]->evaluate(ctx).get<string>();
-                    int n = children[1]->evaluate(ctx).get<int>();
-                    return Eval::avg_last_n(ctx, var, n);
+                    SlotId slot = historySlot(*children[0], ctx);
+                    int n = static_cast<int>(children[1]->evaluateScalar(ctx).asInt());
+                    return Eval::avg_last_n(ctx, slot, n);
                 }
             } else if (func_name == "max_last_n") {
                 if (children.size() >= 2) {
-                    string var = children[0]->evaluate(ctx).get<string>();
-                    int n = children[1]->evaluate(ctx).get<int>();
-                    return Eval::max_last_n(ctx, var, n);
+                    SlotId slot = historySlot(*children[0], ctx);
+                    int n = static_cast<int>(children[1]->evaluateScalar(ctx).asInt());
+                    return Eval::max_last_n(ctx, slot, n);
                 }
             } else if (func_name == "trend") {
                 if (children.size() >= 2) {
-                    string var = children[0]->evaluate(ctx).get<string>();
-                    int n = children[1]->evaluate(ctx).get<int>();
-                    return Eval::trend(ctx, var, n);
+                    SlotId slot = historySlot(*children[0], ctx);
+                    int n = static_cast<int>(children[1]->evaluateScalar(ctx).asInt());
+                    return Eval::trend(ctx, slot, n);
+                }
+            } else if (func_name == "matches" || func_name == "contains_any" || func_name == "equals_any") {
+                return Scalar::fromBool(matcher && children[0] && matcher->match(children[0]->evaluateScalar(ctx)));
+            } else if (func_name == "min_last_n") {
+                if (children.size() >= 2) {
+                    SlotId slot = historySlot(*children[0], ctx);
+                    int n = static_cast<int>(children[1]->evaluateScalar(ctx).asInt());
+                    return Eval::min_last_n(ctx, slot, n);
+                }
+            } else if (func_name == "stddev_last_n") {
+                if (children.size() >= 2) {
+                    SlotId slot = historySlot(*children[0], ctx);
+                    int n = static_cast<int>(children[1]->evaluateScalar(ctx).asInt());
+                    return Eval::stddev_last_n(ctx, slot, n);
+                }
+            } else if (func_name == "percentile_last_n") {
+                if (children.size() >= 3) {
+                    SlotId slot = historySlot(*children[0], ctx);
+                    int n = static_cast<int>(children[1]->evaluateScalar(ctx).asInt());
+                    return Eval::percentile_last_n(ctx, slot, n, children[2]->evaluateScalar(ctx).asDouble());
                 }
             }
             
-            return Value();
+            return Scalar();
         }
         
         default:
-            return Value();
+            return Scalar();
     }
 }
 
@@ -95,15 +203,72 @@ bool ExprNode::isValid() const {
     return type != EXPR_VALUE || !value.empty();
 }
 
+shared_ptr<ExprNode> ExprNode::clone() const {
+    auto node = make_shared<ExprNode>(type);
+    node->value = value;
+    node->slot = slot;
+    node->literal = literal;
+    node->op = op;
+    node->func_name = func_name;
+    node->matcher = matcher;
+    node->children.reserve(children.size());
+    for (const auto& child : children) {
+        node->children.push_back(child ? child->clone() : nullptr);
+    }
+    return node;
+}
+
+void ExprNode::collectInputs(vector<SlotId>& slots, bool& time_dependent) const {
+    if (type == EXPR_VAR) {
+        if (slot != INVALID_SLOT) {
+            slots.push_back(slot);
+        } else {
+            time_dependent = true;
+        }
+    } else if (type == EXPR_FUNC) {
+        if (func_name == "time_between" || func_name == "day_of_week") {
+            time_dependent = true;
+        } else if (isHistoryFunction(func_name) &&
+                   !children.empty() && children[0]->type != EXPR_VAR) {
+            // 历史函数的键名在运行时才能确定
+            time_dependent = true;
+        }
+    }
+    
+    for (const auto& child : children) {
+        if (child) child->collectInputs(slots, time_dependent);
+    }
+}
+
+bool ExprNode::isHistoryFunction(const string& name) {
+    return name == "avg_last_n" || name == "max_last_n" || name == "min_last_n" || name == "trend" ||
+           name == "stddev_last_n" || name == "percentile_last_n";
+}
+
 // ExpressionParser 实现
 shared_ptr<ExprNode> ExpressionParser::parse(const json& expr) {
-    return parseRecursive(expr);
+    shared_ptr<ExprNode> root = parseTree(expr);
+    if (root) root->program = ExprProgram::compile(*root);
+    return root;
 }
 
-shared_ptr<ExprNode> ExpressionParser::parseString(const string& expr) {
-    // 未来可以实现字符串表达式解析
-    // 目前返回空指针
-    return nullptr;
+shared_ptr<ExprNode> ExpressionParser::parseString(const string& expr, string* error) {
+    shared_ptr<ExprNode> root = parseTree(expr, error);
+    if (root) root->program = ExprProgram::compile(*root);
+    return root;
+}
+
+shared_ptr<ExprNode> ExpressionParser::parseTree(const json& expr, string* error) {
+    if (!expr.is_string()) {
+        return ExprOptimizer::optimize(parseRecursive(expr));
+    }
+    InfixParser parser(expr.get_ref<const string&>());
+    shared_ptr<ExprNode> root = parser.parse();
+    if (!root) {
+        if (error) *error = parser.error();
+        return nullptr;
+    }
+    return ExprOptimizer::optimize(root);
 }
 
 shared_ptr<ExprNode> ExpressionParser::parseRecursive(const json& expr) {
@@ -112,9 +277,11 @@ shared_ptr<ExprNode> ExpressionParser::parseRecursive(const json& expr) {
     if (expr.is_string()) {
         node->type = EXPR_VAR;
         node->value = expr.get<string>();
+        node->slot = SymbolTable::global().intern(node->value);
     } else if (expr.is_number() || expr.is_boolean()) {
         node->type = EXPR_VALUE;
         node->value = expr.dump();
+        node->literal = Scalar::fromJson(expr);
     } else if (expr.is_object()) {
         if (expr.contains("op")) {
             node->type = EXPR_OP;
@@ -142,3 +309,33 @@ shared_ptr<ExprNode> ExpressionParser::parseRecursive(const json& expr) {
     
     return node;
 }
+
+// ExpressionCache 实现
+shared_ptr<ExprNode> ExpressionCache::get(const string& text, string* error) {
+    auto it = entries_.find(text);
+    if (it != entries_.end()) {
+        hits_++;
+        it->second.used = true;
+        return it->second.root->clone();
+    }
+    shared_ptr<ExprNode> root = ExpressionParser::parseTree(text, error);
+    if (!root) return nullptr;
+    entries_.emplace(text, Entry{root, true});
+    return root->clone();
+}
+
+void ExpressionCache::prune() {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->second.used) {
+            it->second.used = false;
+            ++it;
+        } else {
+            it = entries_.erase(it);
+        }
+    }
+}
+
+void ExpressionCache::clear() {
+    entries_.clear();
+    hits_ = 0;
+}
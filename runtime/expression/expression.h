@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <atomic>
+#include <unordered_map>
 
 using namespace std;
 
@@ -15,35 +17,109 @@ enum ExprType {
     EXPR_FUNC       // 函数节点
 };
 
+// 按Context版本缓存的求值结果，支持多线程并发读写（序列锁）
+class ExprMemo {
+public:
+    ExprMemo();
+    
+    // 读取version对应的缓存结果，成功返回true
+    bool load(uint64_t version, Scalar& value) const;
+    
+    // 写入缓存；其他线程正在写入时或value持有堆上的字符串时放弃
+    void store(uint64_t version, const Scalar& value);
+    
+private:
+    atomic<uint64_t> state_;        // 0：空；奇数：写入中；偶数：版本号*2
+    atomic<uint64_t> words_[2];     // Scalar的两个字
+};
+
+class ExprProgram;
+class StringMatcher;
+
 // 表达式节点
 class ExprNode {
 public:
     ExprType type;
     string value;           // 值或变量名
+    SlotId slot;            // 变量槽位（解析时确定）
+    Scalar literal;         // 值节点的解码结果（解析时确定）
     string op;              // 操作符
     string func_name;       // 函数名
     vector<shared_ptr<ExprNode>> children;  // 子节点
+    atomic<bool> shared;    // 被多处引用的子树，按Context版本缓存结果（后台加载时可能修改）
+    shared_ptr<const ExprProgram> program;  // 根节点编译得到的字节码，为空时按树遍历求值
+    shared_ptr<const StringMatcher> matcher;    // matches/contains_any/equals_any的模式（加载时编译），为空时结果为false
     
     ExprNode();
     ExprNode(ExprType t);
     
-    // 评估表达式
+    // 评估表达式（json接口，内部走Scalar求值）
     Value evaluate(const Context& ctx) const;
     
+    // 评估表达式（热路径，不产生json）
+    Scalar evaluateScalar(const Context& ctx) const;
+    
+    // 逐节点遍历求值，不使用本节点的字节码（字节码的参考实现，用于差分测试）
+    Scalar evaluateTree(const Context& ctx) const;
+    
     // 检查节点是否有效
     bool isValid() const;
+    
+    // 深拷贝子树（不复制字节码和缓存结果，shared为false）
+    shared_ptr<ExprNode> clone() const;
+    
+    // 收集表达式读取的槽位；依赖时间或动态键名时置位time_dependent
+    void collectInputs(vector<SlotId>& slots, bool& time_dependent) const;
+    
+    // 按变量历史记录求值的函数（第一个参数为变量，第二个为窗口长度）
+    static bool isHistoryFunction(const string& name);
+    
+private:
+    mutable ExprMemo memo_;             // 共享子树的缓存结果
+    
+    // 不经缓存直接求值：有字节码时在虚拟机上执行，否则遍历
+    Scalar evaluateNode(const Context& ctx) const;
 };
 
 // 表达式解析器
 class ExpressionParser {
 public:
-    // 解析JSON表达式
+    // 解析JSON表达式：优化（常量折叠、布尔化简）后根节点编译为字节码
+    // 顶层为字符串时按中缀表达式解析（见parseString），语法错误时返回nullptr
     static shared_ptr<ExprNode> parse(const json& expr);
     
-    // 解析字符串表达式（未来扩展）
-    static shared_ptr<ExprNode> parseString(const string& expr);
+    // 解析中缀表达式文本，如 "(temp > 25) && contains(weather, 'sunny')"
+    // 得到的树与等价的JSON表达式相同，同样优化并编译；语法错误时返回nullptr并写入error
+    static shared_ptr<ExprNode> parseString(const string& expr, string* error = nullptr);
     
-private:
-    // 递归解析JSON
+    // 同parse/parseString，但不编译字节码：Engine在谓词网络合并之后再编译（见PredicateNetwork::compile）
+    static shared_ptr<ExprNode> parseTree(const json& expr, string* error = nullptr);
+    
+    // 递归解析JSON，不优化也不编译（保持与配置一致的结构，用于差分测试）
     static shared_ptr<ExprNode> parseRecursive(const json& expr);
 };
+
+// 表达式文本缓存：相同文本只解析一次（已优化、未编译，见ExpressionParser::parseTree）
+// 返回缓存树的副本：合并谓词网络时会改写子节点，缓存中的树不随规则集发布，后台构建时也不会被修改
+// 不加锁，由持有者保证串行访问（Engine在build_mutex_下使用）
+class ExpressionCache {
+public:
+    // 查找或解析表达式文本，返回副本；语法错误不缓存，返回nullptr并写入error
+    shared_ptr<ExprNode> get(const string& text, string* error = nullptr);
+    
+    // 删除上次prune之后没有再被查找的表达式（重新加载规则后调用）
+    void prune();
+    
+    void clear();
+    
+    size_t size() const { return entries_.size(); }
+    uint64_t hits() const { return hits_; }
+    
+private:
+    struct Entry {
+        shared_ptr<const ExprNode> root;
+        bool used;
+    };
+    unordered_map<string, Entry> entries_;
+    uint64_t hits_ = 0;
+};
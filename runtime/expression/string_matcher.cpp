@@ -0,0 +1,173 @@
+#include "string_matcher.h"
+#include <algorithm>
+
+// StringMatcher 实现
+bool StringMatcher::kindOf(const string& func_name, Kind& kind) {
+    if (func_name == "matches") {
+        kind = MATCH_REGEX;
+    } else if (func_name == "contains_any") {
+        kind = MATCH_CONTAINS_ANY;
+    } else if (func_name == "equals_any") {
+        kind = MATCH_EQUALS_ANY;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+shared_ptr<const StringMatcher> StringMatcher::compile(Kind kind, const vector<Scalar>& patterns, string* error) {
+    shared_ptr<StringMatcher> matcher(new StringMatcher(kind));
+    matcher->size_ = patterns.size();
+
+    switch (kind) {
+        case MATCH_REGEX: {
+            if (patterns.empty() || !patterns[0].isString()) {
+                if (error) *error = "matches requires a string pattern";
+                return nullptr;
+            }
+            try {
+                matcher->regex_ = regex(string(patterns[0].str()), regex::ECMAScript | regex::optimize);
+            } catch (const regex_error& e) {
+                if (error) *error = e.what();
+                return nullptr;
+            }
+            break;
+        }
+
+        case MATCH_CONTAINS_ANY: {
+            vector<string_view> texts;
+            for (const Scalar& pattern : patterns) {
+                if (pattern.isString()) texts.push_back(pattern.str());
+            }
+            matcher->buildAutomaton(texts);
+            break;
+        }
+
+        case MATCH_EQUALS_ANY: {
+            for (const Scalar& pattern : patterns) {
+                vector<Scalar>& values = pattern.isString() ? matcher->strings_ : matcher->others_;
+                if (find(values.begin(), values.end(), pattern) == values.end()) {
+                    values.push_back(pattern);
+                }
+            }
+            matcher->buildHashSet();
+            break;
+        }
+    }
+    return matcher;
+}
+
+void StringMatcher::buildAutomaton(const vector<string_view>& patterns) {
+    // 字符类：只区分模式中出现的字节
+    for (string_view pattern : patterns) {
+        for (unsigned char c : pattern) {
+            if (!classes_[c]) classes_[c] = static_cast<uint16_t>(class_count_++);
+        }
+        if (pattern.empty()) empty_pattern_ = true;
+    }
+
+    // 字典树，-1表示没有边
+    const size_t k = class_count_;
+    transitions_.assign(k, -1);
+    accepting_.assign(1, 0);
+    for (string_view pattern : patterns) {
+        int32_t state = 0;
+        for (unsigned char c : pattern) {
+            int32_t& next = transitions_[state * k + classes_[c]];
+            if (next < 0) {
+                next = static_cast<int32_t>(accepting_.size());
+                transitions_.resize(transitions_.size() + k, -1);
+                accepting_.push_back(0);
+            }
+            state = transitions_[state * k + classes_[c]];
+        }
+        accepting_[state] = 1;
+    }
+
+    // 按层序计算失败链接，把缺失的边补成失败状态上的转移
+    vector<int32_t> fail(accepting_.size(), 0);
+    vector<int32_t> queue;
+    queue.reserve(accepting_.size());
+    for (size_t c = 0; c < k; ++c) {
+        int32_t& next = transitions_[c];
+        if (next < 0) {
+            next = 0;
+        } else {
+            queue.push_back(next);
+        }
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int32_t state = queue[head];
+        accepting_[state] |= accepting_[fail[state]];
+        for (size_t c = 0; c < k; ++c) {
+            int32_t& next = transitions_[state * k + c];
+            int32_t via_fail = transitions_[fail[state] * k + c];
+            if (next < 0) {
+                next = via_fail;
+            } else {
+                fail[next] = via_fail;
+                queue.push_back(next);
+            }
+        }
+    }
+}
+
+void StringMatcher::buildHashSet() {
+    if (strings_.empty()) return;
+    size_t capacity = 2;
+    shift_ = 63;
+    while (capacity < strings_.size() * 2) {
+        capacity <<= 1;
+        shift_--;
+    }
+    slots_.assign(capacity, EMPTY);
+    for (uint32_t i = 0; i < strings_.size(); ++i) {
+        size_t slot = slotOf(strings_[i].str());
+        while (slots_[slot] != EMPTY) slot = (slot + 1) & (capacity - 1);
+        slots_[slot] = i;
+    }
+}
+
+size_t StringMatcher::slotOf(string_view text) const {
+    return (static_cast<uint64_t>(hash<string_view>()(text)) * 0x9E3779B97F4A7C15ULL) >> shift_;
+}
+
+bool StringMatcher::containsAny(string_view text) const {
+    if (empty_pattern_) return true;
+    const int32_t* transitions = transitions_.data();
+    const size_t k = class_count_;
+    int32_t state = 0;
+    for (unsigned char c : text) {
+        state = transitions[state * k + classes_[c]];
+        if (accepting_[state]) return true;
+    }
+    return false;
+}
+
+bool StringMatcher::equalsAny(const Scalar& value) const {
+    if (slots_.empty()) return false;
+    size_t mask = slots_.size() - 1;
+    for (size_t slot = slotOf(value.str());; slot = (slot + 1) & mask) {
+        if (slots_[slot] == EMPTY) return false;
+        if (strings_[slots_[slot]] == value) return true;
+    }
+}
+
+bool StringMatcher::match(const Scalar& value) const {
+    switch (kind_) {
+        case MATCH_REGEX:
+            if (!value.isString()) return false;
+            {
+                string_view text = value.str();
+                return regex_search(text.begin(), text.end(), regex_);
+            }
+
+        case MATCH_CONTAINS_ANY:
+            return value.isString() && containsAny(value.str());
+
+        case MATCH_EQUALS_ANY:
+            if (value.isString()) return equalsAny(value);
+            return find(others_.begin(), others_.end(), value) != others_.end();
+    }
+    return false;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../core/scalar.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <regex>
+#include <cstdint>
+
+using namespace std;
+
+// 加载时编译的字符串匹配，供表达式函数使用：
+//   matches(x, '正则')               正则表达式（ECMAScript语法，在x中搜索，用^$锚定整串）
+//   contains_any(x, 'a', 'b', ...)   x包含任一子串：Aho-Corasick自动机，一次扫描x
+//   equals_any(x, 'a', 'b', ...)     x等于任一值：按字符串内容的哈希查表（开放寻址，负载不超过一半），命中槽位后比较一次
+// 编译后只读，可被多个线程同时使用；contains_any和equals_any匹配时不分配内存
+class StringMatcher {
+public:
+    enum Kind {
+        MATCH_REGEX,
+        MATCH_CONTAINS_ANY,
+        MATCH_EQUALS_ANY
+    };
+
+    // 函数名对应的类型，不是匹配函数时返回false
+    static bool kindOf(const string& func_name, Kind& kind);
+
+    // 编译模式；正则语法错误时返回nullptr并给出error
+    // equals_any的模式可以是任意标量（数字按值比较），其余类型只取字符串模式
+    static shared_ptr<const StringMatcher> compile(Kind kind, const vector<Scalar>& patterns, string* error = nullptr);
+
+    // 匹配：contains_any/matches要求value为字符串，否则为false
+    bool match(const Scalar& value) const;
+
+    Kind kind() const { return kind_; }
+
+    // 模式数
+    size_t size() const { return size_; }
+
+private:
+    Kind kind_;
+    size_t size_ = 0;
+
+    // 正则
+    regex regex_;
+
+    // Aho-Corasick：出现在模式中的字节映射为字符类（0为其余字节），
+    // 状态转移表已按失败链接补全，每个字节一次查表
+    uint16_t classes_[256] = {};
+    size_t class_count_ = 1;
+    vector<int32_t> transitions_;   // 状态 * class_count_ + 字符类 -> 状态
+    vector<uint8_t> accepting_;     // 到达该状态时已匹配某个模式（含后缀）
+    bool empty_pattern_ = false;    // 空模式匹配任意字符串
+
+    // 字符串模式的哈希表：起始槽位 = (内容哈希 * 黄金比例常数) >> shift_，线性探测
+    vector<Scalar> strings_;        // 去重后的字符串模式
+    vector<uint32_t> slots_;        // strings_中的下标，空槽位为EMPTY
+    uint32_t shift_ = 64;
+    vector<Scalar> others_;         // 非字符串的值，逐个比较
+
+    static constexpr uint32_t EMPTY = 0xFFFFFFFFu;
+
+    StringMatcher(Kind kind) : kind_(kind) {}
+
+    void buildAutomaton(const vector<string_view>& patterns);
+    void buildHashSet();
+
+    bool containsAny(string_view text) const;
+    bool equalsAny(const Scalar& value) const;
+    size_t slotOf(string_view text) const;
+};
@@ -16,6 +16,43 @@ void PriorityManager::setRulePriority(vector<Rule>& rules, const string& rule_id
     }
 }
 
+void PriorityManager::sortOrder(const vector<Rule>& rules, vector<RuleHandle>& order, vector<uint32_t>& position) {
+    order.resize(rules.size());
+    for (size_t i = 0; i < rules.size(); ++i) {
+        order[i] = static_cast<RuleHandle>(i);
+    }
+    sort(order.begin(), order.end(), [&](RuleHandle a, RuleHandle b) {
+        return rules[a] < rules[b];
+    });
+    
+    position.resize(rules.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        position[order[i]] = static_cast<uint32_t>(i);
+    }
+}
+
+void PriorityManager::reorder(const vector<Rule>& rules, vector<RuleHandle>& order, vector<uint32_t>& position,
+                              RuleHandle handle) {
+    auto less = [&](RuleHandle a, RuleHandle b) { return rules[a] < rules[b]; };
+    size_t from = position[handle];
+    
+    // 在去掉自身的有序序列中二分查找新位置
+    size_t to;
+    if (from > 0 && less(handle, order[from - 1])) {
+        to = upper_bound(order.begin(), order.begin() + from, handle, less) - order.begin();
+        rotate(order.begin() + to, order.begin() + from, order.begin() + from + 1);
+    } else if (from + 1 < order.size() && less(order[from + 1], handle)) {
+        to = lower_bound(order.begin() + from + 1, order.end(), handle, less) - order.begin() - 1;
+        rotate(order.begin() + from, order.begin() + from + 1, order.begin() + to + 1);
+    } else {
+        return;
+    }
+    
+    for (size_t i = min(from, to); i <= max(from, to); ++i) {
+        position[order[i]] = static_cast<uint32_t>(i);
+    }
+}
+
 int PriorityManager::getRulePriority(const vector<Rule>& rules, const string& rule_id) {
     for (const auto& rule : rules) {
         if (rule.id == rule_id) {
@@ -63,3 +100,41 @@ bool RuleGroupManager::shouldExecuteRule(const Rule& rule) const {
     if (rule.group.empty()) return true; // 没有组的规则总是执行
     return isGroupEnabled(rule.group);
 }
+
+void RuleGroupManager::setGroupPolicy(const string& group_name, const GroupPolicy& policy) {
+    if (policy.mode == GROUP_ALL_MATCH) {
+        group_policies_.erase(group_name);
+    } else {
+        group_policies_[group_name] = policy;
+    }
+}
+
+GroupPolicy RuleGroupManager::getGroupPolicy(const string& group_name) const {
+    auto it = group_policies_.find(group_name);
+    return it != group_policies_.end() ? it->second : GroupPolicy();
+}
+
+// GroupPolicy 实现
+uint32_t GroupPolicy::maxFires() const {
+    switch (mode) {
+        case GROUP_FIRST_MATCH: return 1;
+        case GROUP_HIGHEST_N: return limit > 0 ? limit : 1;
+        default: return 0;
+    }
+}
+
+bool GroupPolicy::fromJson(const json& j, GroupPolicy& policy) {
+    if (!j.is_object()) return false;
+    string mode = j.value("mode", "all_match");
+    if (mode == "all_match") {
+        policy = GroupPolicy();
+    } else if (mode == "first_match") {
+        policy = GroupPolicy(GROUP_FIRST_MATCH);
+    } else if (mode == "highest_n") {
+        int64_t limit = (j.contains("limit") && j["limit"].is_number_integer()) ? j["limit"].get<int64_t>() : 1;
+        policy = GroupPolicy(GROUP_HIGHEST_N, static_cast<uint32_t>(min<int64_t>(max<int64_t>(limit, 1), UINT32_MAX)));
+    } else {
+        return false;
+    }
+    return true;
+}
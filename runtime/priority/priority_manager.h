@@ -16,6 +16,13 @@ public:
     // 设置规则优先级
     static void setRulePriority(vector<Rule>& rules, const string& rule_id, int priority);
     
+    // 按优先级排列规则句柄：order为执行顺序，position为句柄在order中的位置
+    static void sortOrder(const vector<Rule>& rules, vector<RuleHandle>& order, vector<uint32_t>& position);
+    
+    // 规则优先级修改后，只把该规则移动到新位置（移动的是句柄，不移动规则对象）
+    static void reorder(const vector<Rule>& rules, vector<RuleHandle>& order, vector<uint32_t>& position,
+                        RuleHandle handle);
+    
     // 获取规则优先级
     static int getRulePriority(const vector<Rule>& rules, const string& rule_id);
     
@@ -26,6 +33,28 @@ public:
     static int normalizePriority(int priority);
 };
 
+// 规则组内的冲突处理方式
+enum GroupMode {
+    GROUP_ALL_MATCH,    // 条件成立的规则全部触发（默认）
+    GROUP_FIRST_MATCH,  // 每次tick只触发优先级最高的一条，之后不再评估组内其余规则
+    GROUP_HIGHEST_N     // 每次tick最多触发优先级最高的N条
+};
+
+// 规则组的冲突处理策略
+struct GroupPolicy {
+    GroupMode mode;
+    uint32_t limit;     // GROUP_HIGHEST_N的N
+    
+    GroupPolicy() : mode(GROUP_ALL_MATCH), limit(0) {}
+    GroupPolicy(GroupMode m, uint32_t n = 1) : mode(m), limit(n) {}
+    
+    // 每次tick最多触发的规则数，0表示不限
+    uint32_t maxFires() const;
+    
+    // 从配置解析：{"mode": "first_match" | "all_match" | "highest_n", "limit": N}
+    static bool fromJson(const json& j, GroupPolicy& policy);
+};
+
 // 规则组管理器
 class RuleGroupManager {
 public:
@@ -44,6 +73,13 @@ public:
     // 检查规则是否应该执行（考虑组状态）
     bool shouldExecuteRule(const Rule& rule) const;
     
+    // 设置规则组的冲突处理策略
+    void setGroupPolicy(const string& group_name, const GroupPolicy& policy);
+    
+    // 获取规则组的冲突处理策略（未设置时为GROUP_ALL_MATCH）
+    GroupPolicy getGroupPolicy(const string& group_name) const;
+    
 private:
     unordered_map<string, bool> group_states_;
+    unordered_map<string, GroupPolicy> group_policies_;
 };
@@ -2,11 +2,18 @@
 
 // 统一包含所有runtime模块
 #include "core/context.h"
+#include "core/context_batch.h"
+#include "core/shared_context.h"
+#include "core/trace.h"
 #include "core/rule.h"
 #include "core/engine.h"
+#include "core/engine_loop.h"
+#include "core/window_kernels.h"
 #include "condition/condition_evaluator.h"
 #include "condition/operators.h"
 #include "expression/expression.h"
+#include "expression/expr_program.h"
+#include "expression/expr_optimizer.h"
 #include "priority/priority_manager.h"
 #include "behavior_tree/behavior_tree.h"
 #include "scheduler/scheduler.h"
@@ -25,6 +25,50 @@ CXX_FLAGS="-std=c++17 -Wall -Wextra"
 INCLUDE_FLAGS="-I$PROJECT_ROOT -I$BUILD_DIR/_deps/nlohmann_json-src/include"
 LINK_FLAGS="-pthread"
 
+# 运行时源文件（runtime/CMakeLists.txt中除持久化模块以外的部分），所有测试程序共用
+RUNTIME_SOURCES=(
+    "$PROJECT_ROOT/runtime/runtime.cpp"
+    "$PROJECT_ROOT/runtime/core/symbol_table.cpp"
+    "$PROJECT_ROOT/runtime/core/scalar.cpp"
+    "$PROJECT_ROOT/runtime/core/worker_pool.cpp"
+    "$PROJECT_ROOT/runtime/core/profiler.cpp"
+    "$PROJECT_ROOT/runtime/core/context.cpp"
+    "$PROJECT_ROOT/runtime/core/history.cpp"
+    "$PROJECT_ROOT/runtime/core/clock.cpp"
+    "$PROJECT_ROOT/runtime/core/window_kernels.cpp"
+    "$PROJECT_ROOT/runtime/core/trace.cpp"
+    "$PROJECT_ROOT/runtime/core/context_batch.cpp"
+    "$PROJECT_ROOT/runtime/core/shared_context.cpp"
+    "$PROJECT_ROOT/runtime/core/action_executor.cpp"
+    "$PROJECT_ROOT/runtime/core/rule.cpp"
+    "$PROJECT_ROOT/runtime/core/rule_set.cpp"
+    "$PROJECT_ROOT/runtime/core/engine.cpp"
+    "$PROJECT_ROOT/runtime/core/engine_loop.cpp"
+    "$PROJECT_ROOT/runtime/condition/condition_evaluator.cpp"
+    "$PROJECT_ROOT/runtime/condition/operators.cpp"
+    "$PROJECT_ROOT/runtime/condition/predicate_network.cpp"
+    "$PROJECT_ROOT/runtime/condition/batch_evaluator.cpp"
+    "$PROJECT_ROOT/runtime/expression/expression.cpp"
+    "$PROJECT_ROOT/runtime/expression/expr_program.cpp"
+    "$PROJECT_ROOT/runtime/expression/expr_optimizer.cpp"
+    "$PROJECT_ROOT/runtime/expression/expr_infix_parser.cpp"
+    "$PROJECT_ROOT/runtime/expression/string_matcher.cpp"
+    "$PROJECT_ROOT/runtime/priority/priority_manager.cpp"
+    "$PROJECT_ROOT/runtime/behavior_tree/bt_node.cpp"
+    "$PROJECT_ROOT/runtime/behavior_tree/bt_parser.cpp"
+    "$PROJECT_ROOT/runtime/behavior_tree/bt_executor.cpp"
+    "$PROJECT_ROOT/runtime/behavior_tree/bt_manager.cpp"
+)
+
+# 调度模块源文件
+SCHEDULER_SOURCES=(
+    "$PROJECT_ROOT/runtime/scheduler/cron_parser.cpp"
+    "$PROJECT_ROOT/runtime/scheduler/timer.cpp"
+    "$PROJECT_ROOT/runtime/scheduler/frequency_limiter.cpp"
+    "$PROJECT_ROOT/runtime/scheduler/resource_monitor.cpp"
+    "$PROJECT_ROOT/runtime/scheduler/scheduler.cpp"
+)
+
 # 创建测试输出目录
 mkdir -p "$TEST_DIR/bin"
 
@@ -35,18 +79,7 @@ echo "编译测试程序..."
 echo "  编译 test_simple..."
 g++ $CXX_FLAGS $INCLUDE_FLAGS \
     "$TEST_DIR/test_simple.cpp" \
-    "$PROJECT_ROOT/runtime/runtime.cpp" \
-    "$PROJECT_ROOT/runtime/core/context.cpp" \
-    "$PROJECT_ROOT/runtime/core/rule.cpp" \
-    "$PROJECT_ROOT/runtime/core/engine.cpp" \
-    "$PROJECT_ROOT/runtime/condition/condition_evaluator.cpp" \
-    "$PROJECT_ROOT/runtime/condition/operators.cpp" \
-    "$PROJECT_ROOT/runtime/expression/expression.cpp" \
-    "$PROJECT_ROOT/runtime/priority/priority_manager.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_node.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_parser.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_executor.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_manager.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
     $LINK_FLAGS \
     -o "$TEST_DIR/bin/test_simple"
 
@@ -54,18 +87,7 @@ g++ $CXX_FLAGS $INCLUDE_FLAGS \
 echo "  编译 test_priority_demo..."
 g++ $CXX_FLAGS $INCLUDE_FLAGS \
     "$TEST_DIR/test_priority_demo.cpp" \
-    "$PROJECT_ROOT/runtime/runtime.cpp" \
-    "$PROJECT_ROOT/runtime/core/context.cpp" \
-    "$PROJECT_ROOT/runtime/core/rule.cpp" \
-    "$PROJECT_ROOT/runtime/core/engine.cpp" \
-    "$PROJECT_ROOT/runtime/condition/condition_evaluator.cpp" \
-    "$PROJECT_ROOT/runtime/condition/operators.cpp" \
-    "$PROJECT_ROOT/runtime/expression/expression.cpp" \
-    "$PROJECT_ROOT/runtime/priority/priority_manager.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_node.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_parser.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_executor.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_manager.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
     $LINK_FLAGS \
     -o "$TEST_DIR/bin/test_priority_demo"
 
@@ -73,18 +95,7 @@ g++ $CXX_FLAGS $INCLUDE_FLAGS \
 echo "  编译 test_expression_simple..."
 g++ $CXX_FLAGS $INCLUDE_FLAGS \
     "$TEST_DIR/test_expression_simple.cpp" \
-    "$PROJECT_ROOT/runtime/runtime.cpp" \
-    "$PROJECT_ROOT/runtime/core/context.cpp" \
-    "$PROJECT_ROOT/runtime/core/rule.cpp" \
-    "$PROJECT_ROOT/runtime/core/engine.cpp" \
-    "$PROJECT_ROOT/runtime/condition/condition_evaluator.cpp" \
-    "$PROJECT_ROOT/runtime/condition/operators.cpp" \
-    "$PROJECT_ROOT/runtime/expression/expression.cpp" \
-    "$PROJECT_ROOT/runtime/priority/priority_manager.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_node.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_parser.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_executor.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_manager.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
     $LINK_FLAGS \
     -o "$TEST_DIR/bin/test_expression_simple"
 
@@ -92,18 +103,7 @@ g++ $CXX_FLAGS $INCLUDE_FLAGS \
 echo "  编译 test_behavior_tree..."
 g++ $CXX_FLAGS $INCLUDE_FLAGS \
     "$TEST_DIR/test_behavior_tree.cpp" \
-    "$PROJECT_ROOT/runtime/runtime.cpp" \
-    "$PROJECT_ROOT/runtime/core/context.cpp" \
-    "$PROJECT_ROOT/runtime/core/rule.cpp" \
-    "$PROJECT_ROOT/runtime/core/engine.cpp" \
-    "$PROJECT_ROOT/runtime/condition/condition_evaluator.cpp" \
-    "$PROJECT_ROOT/runtime/condition/operators.cpp" \
-    "$PROJECT_ROOT/runtime/expression/expression.cpp" \
-    "$PROJECT_ROOT/runtime/priority/priority_manager.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_node.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_parser.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_executor.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_manager.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
     $LINK_FLAGS \
     -o "$TEST_DIR/bin/test_behavior_tree"
 
@@ -111,18 +111,7 @@ g++ $CXX_FLAGS $INCLUDE_FLAGS \
 echo "  编译 test_clean_robot..."
 g++ $CXX_FLAGS $INCLUDE_FLAGS \
     "$TEST_DIR/test_clean_robot.cpp" \
-    "$PROJECT_ROOT/runtime/runtime.cpp" \
-    "$PROJECT_ROOT/runtime/core/context.cpp" \
-    "$PROJECT_ROOT/runtime/core/rule.cpp" \
-    "$PROJECT_ROOT/runtime/core/engine.cpp" \
-    "$PROJECT_ROOT/runtime/condition/condition_evaluator.cpp" \
-    "$PROJECT_ROOT/runtime/condition/operators.cpp" \
-    "$PROJECT_ROOT/runtime/expression/expression.cpp" \
-    "$PROJECT_ROOT/runtime/priority/priority_manager.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_node.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_parser.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_executor.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_manager.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
     $LINK_FLAGS \
     -o "$TEST_DIR/bin/test_clean_robot"
 
@@ -130,37 +119,199 @@ g++ $CXX_FLAGS $INCLUDE_FLAGS \
 echo "  编译 test_multi_condition..."
 g++ $CXX_FLAGS $INCLUDE_FLAGS \
     "$TEST_DIR/test_multi_condition.cpp" \
-    "$PROJECT_ROOT/runtime/runtime.cpp" \
-    "$PROJECT_ROOT/runtime/core/context.cpp" \
-    "$PROJECT_ROOT/runtime/core/rule.cpp" \
-    "$PROJECT_ROOT/runtime/core/engine.cpp" \
-    "$PROJECT_ROOT/runtime/condition/condition_evaluator.cpp" \
-    "$PROJECT_ROOT/runtime/condition/operators.cpp" \
-    "$PROJECT_ROOT/runtime/expression/expression.cpp" \
-    "$PROJECT_ROOT/runtime/priority/priority_manager.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_node.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_parser.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_executor.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_manager.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
     $LINK_FLAGS \
     -o "$TEST_DIR/bin/test_multi_condition"
 
+# 编译增量评估测试
+echo "  编译 test_incremental_eval..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_incremental_eval.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_incremental_eval"
+
+# 编译并行评估测试
+echo "  编译 test_parallel_tick..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_parallel_tick.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_parallel_tick"
+
+# 编译批量设备评估测试
+echo "  编译 test_batch_tick..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_batch_tick.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_batch_tick"
+
+# 编译异步动作测试
+echo "  编译 test_async_actions..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_async_actions.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_async_actions"
+
+# 编译事件驱动运行循环测试
+echo "  编译 test_engine_loop..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_engine_loop.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_engine_loop"
+
+# 编译共享Context快照测试
+echo "  编译 test_shared_context..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_shared_context.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_shared_context"
+
+# 编译规则句柄测试
+echo "  编译 test_rule_handles..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_rule_handles.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_rule_handles"
+
+# 编译规则集热替换测试
+echo "  编译 test_hot_swap..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_hot_swap.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_hot_swap"
+
+# 编译动作绑定测试
+echo "  编译 test_action_binding..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_action_binding.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_action_binding"
+
+# 编译规则唤醒测试
+echo "  编译 test_rule_wakeup..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_rule_wakeup.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_rule_wakeup"
+
+# 编译性能剖析测试
+echo "  编译 test_profiler..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_profiler.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_profiler"
+
+# 编译传感器轨迹录制测试
+echo "  编译 test_trace..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_trace.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_trace"
+
+# 编译规则组冲突处理测试
+echo "  编译 test_group_modes..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_group_modes.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_group_modes"
+
+# 编译表达式字节码测试
+echo "  编译 test_expr_bytecode..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_expr_bytecode.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_expr_bytecode"
+
+# 编译表达式优化测试
+echo "  编译 test_expr_optimizer..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_expr_optimizer.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_expr_optimizer"
+
+# 编译短路求值测试
+echo "  编译 test_short_circuit..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_short_circuit.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_short_circuit"
+
+# 编译中缀表达式测试
+echo "  编译 test_expr_infix..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_expr_infix.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_expr_infix"
+
+# 编译历史窗口测试
+echo "  编译 test_history_window..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_history_window.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_history_window"
+
+# 编译窗口聚合内核测试
+echo "  编译 test_window_kernels..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_window_kernels.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_window_kernels"
+
+# 编译时钟快照测试
+echo "  编译 test_clock_snapshot..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_clock_snapshot.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_clock_snapshot"
+
+# 编译字符串匹配测试
+echo "  编译 test_string_match..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_string_match.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_string_match"
+
+# 编译上下文槽位测试
+echo "  编译 test_context_slots..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_context_slots.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_context_slots"
+
+# 编译标量测试
+echo "  编译 test_scalar..."
+g++ $CXX_FLAGS $INCLUDE_FLAGS \
+    "$TEST_DIR/test_scalar.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    $LINK_FLAGS \
+    -o "$TEST_DIR/bin/test_scalar"
+
 # 编译路口红绿灯测试
 echo "  编译 test_junction_light..."
 g++ $CXX_FLAGS $INCLUDE_FLAGS \
     "$TEST_DIR/test_junction_light.cpp" \
-    "$PROJECT_ROOT/runtime/runtime.cpp" \
-    "$PROJECT_ROOT/runtime/core/context.cpp" \
-    "$PROJECT_ROOT/runtime/core/rule.cpp" \
-    "$PROJECT_ROOT/runtime/core/engine.cpp" \
-    "$PROJECT_ROOT/runtime/condition/condition_evaluator.cpp" \
-    "$PROJECT_ROOT/runtime/condition/operators.cpp" \
-    "$PROJECT_ROOT/runtime/expression/expression.cpp" \
-    "$PROJECT_ROOT/runtime/priority/priority_manager.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_node.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_parser.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_executor.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_manager.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
     $LINK_FLAGS \
     -o "$TEST_DIR/bin/test_junction_light"
 
@@ -168,23 +319,8 @@ g++ $CXX_FLAGS $INCLUDE_FLAGS \
 echo "  编译 test_scheduler..."
 g++ $CXX_FLAGS $INCLUDE_FLAGS \
     "$TEST_DIR/test_scheduler.cpp" \
-    "$PROJECT_ROOT/runtime/runtime.cpp" \
-    "$PROJECT_ROOT/runtime/core/context.cpp" \
-    "$PROJECT_ROOT/runtime/core/rule.cpp" \
-    "$PROJECT_ROOT/runtime/core/engine.cpp" \
-    "$PROJECT_ROOT/runtime/condition/condition_evaluator.cpp" \
-    "$PROJECT_ROOT/runtime/condition/operators.cpp" \
-    "$PROJECT_ROOT/runtime/expression/expression.cpp" \
-    "$PROJECT_ROOT/runtime/priority/priority_manager.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_node.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_parser.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_executor.cpp" \
-    "$PROJECT_ROOT/runtime/behavior_tree/bt_manager.cpp" \
-    "$PROJECT_ROOT/runtime/scheduler/cron_parser.cpp" \
-    "$PROJECT_ROOT/runtime/scheduler/timer.cpp" \
-    "$PROJECT_ROOT/runtime/scheduler/frequency_limiter.cpp" \
-    "$PROJECT_ROOT/runtime/scheduler/resource_monitor.cpp" \
-    "$PROJECT_ROOT/runtime/scheduler/scheduler.cpp" \
+    "${RUNTIME_SOURCES[@]}" \
+    "${SCHEDULER_SOURCES[@]}" \
     $LINK_FLAGS \
     -o "$TEST_DIR/bin/test_scheduler"
 
@@ -199,6 +335,29 @@ echo "  ./test/bin/test_behavior_tree"
 echo "  ./test/bin/test_clean_robot"
 echo "  ./test/bin/test_multi_condition"
 echo "  ./test/bin/test_junction_light"
+echo "  ./test/bin/test_incremental_eval"
+echo "  ./test/bin/test_parallel_tick"
+echo "  ./test/bin/test_batch_tick"
+echo "  ./test/bin/test_async_actions"
+echo "  ./test/bin/test_engine_loop"
+echo "  ./test/bin/test_shared_context"
+echo "  ./test/bin/test_rule_handles"
+echo "  ./test/bin/test_hot_swap"
+echo "  ./test/bin/test_action_binding"
+echo "  ./test/bin/test_rule_wakeup"
+echo "  ./test/bin/test_profiler"
+echo "  ./test/bin/test_trace"
+echo "  ./test/bin/test_group_modes"
+echo "  ./test/bin/test_expr_bytecode"
+echo "  ./test/bin/test_expr_optimizer"
+echo "  ./test/bin/test_short_circuit"
+echo "  ./test/bin/test_expr_infix"
+echo "  ./test/bin/test_history_window"
+echo "  ./test/bin/test_window_kernels"
+echo "  ./test/bin/test_clock_snapshot"
+echo "  ./test/bin/test_string_match"
+echo "  ./test/bin/test_context_slots"
+echo "  ./test/bin/test_scalar"
 echo "  ./test/bin/test_scheduler"
 echo ""
 echo "清理测试文件:"
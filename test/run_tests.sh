@@ -47,7 +47,56 @@ else
     echo "错误: test_expression_simple 不存在"
 fi
 
+# 运行一个自检测试程序（在bin目录下运行，临时文件留在bin中），检查其退出码
+FAILED=()
+run_check() {
+    local name="$1"
+    local title="$2"
+    echo ""
+    echo "运行${title} (${name})..."
+    echo "----------------------------------------"
+    if [ ! -f "$BIN_DIR/$name" ]; then
+        echo "错误: $name 不存在"
+        FAILED+=("$name")
+    elif (cd "$BIN_DIR" && "./$name"); then
+        echo "${title}通过 ✓"
+    else
+        echo "${title}失败 ✗"
+        FAILED+=("$name")
+    fi
+}
+
+echo ""
+echo "4. 运行运行时功能测试..."
+run_check test_incremental_eval "增量规则评估测试"
+run_check test_parallel_tick "并行规则评估测试"
+run_check test_batch_tick "批量设备规则评估测试"
+run_check test_async_actions "异步动作执行测试"
+run_check test_engine_loop "事件驱动运行循环测试"
+run_check test_shared_context "共享Context快照测试"
+run_check test_rule_handles "规则句柄与索引测试"
+run_check test_hot_swap "规则集热替换测试"
+run_check test_action_binding "动作绑定测试"
+run_check test_rule_wakeup "规则唤醒测试"
+run_check test_profiler "性能剖析测试"
+run_check test_trace "传感器轨迹录制测试"
+run_check test_group_modes "规则组冲突处理测试"
+run_check test_expr_bytecode "表达式字节码测试"
+run_check test_expr_optimizer "表达式优化测试"
+run_check test_short_circuit "短路求值与自适应排序测试"
+run_check test_expr_infix "中缀表达式解析测试"
+run_check test_history_window "历史窗口测试"
+run_check test_window_kernels "窗口聚合内核测试"
+run_check test_clock_snapshot "时钟快照测试"
+run_check test_string_match "字符串匹配测试"
+run_check test_context_slots "上下文槽位测试"
+run_check test_scalar "标量测试"
+
 echo ""
+if [ ${#FAILED[@]} -gt 0 ]; then
+    echo "=== 以下测试失败: ${FAILED[*]} ==="
+    exit 1
+fi
 echo "=== 所有测试完成 ==="
 echo ""
 echo "清理测试文件:"
@@ -0,0 +1,65 @@
+#include "../runtime/runtime.h"
+#include <iostream>
+#include <sstream>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+static size_t countOf(const string& text, const string& word) {
+    size_t count = 0;
+    for (size_t pos = text.find(word); pos != string::npos; pos = text.find(word, pos + word.size())) {
+        count++;
+    }
+    return count;
+}
+
+int main() {
+    cout << "=== 动作绑定测试 ===" << endl;
+    bool ok = true;
+
+    Engine engine;
+    int known = 0, late = 0;
+    engine.register_action("known", [&](const json&, Context&) { known++; });
+
+    json cfg = {{"rules", json::array({
+        {{"id", "r1"}, {"when", {{"left", "x"}, {"op", ">"}, {"right", 0}}},
+         {"do", json::array({{{"action", "missing"}}, {{"action", "known"}}, {{"action", "late"}}})}}
+    })}};
+
+    // 未注册的动作在加载时报告一次，tick时不再输出
+    stringstream err;
+    streambuf* old = cerr.rdbuf(err.rdbuf());
+    engine.load(cfg);
+    Context ctx;
+    const int TICKS = 100;
+    for (int i = 0; i < TICKS; ++i) {
+        ctx.set("x", i + 1);
+        engine.tick(ctx);
+    }
+    cerr.rdbuf(old);
+
+    bool reported = countOf(err.str(), "Unknown action: missing") == 1 &&
+                    countOf(err.str(), "Unknown action: late") == 1 && known == TICKS;
+    ok = ok && reported;
+    cout << "   " << (reported ? "✓" : "✗") << " 未注册的动作只在加载时报告一次，其余动作照常执行" << endl;
+
+    // 加载之后注册的动作无需重新加载即可生效
+    engine.register_action("late", [&](const json&, Context&) { late++; });
+    ctx.set("x", TICKS + 1);
+    engine.tick(ctx);
+    bool rebound = late == 1 && known == TICKS + 1;
+    ok = ok && rebound;
+    cout << "   " << (rebound ? "✓" : "✗") << " 加载后注册的动作自动绑定到已加载的规则" << endl;
+
+    // 重新注册替换原有的动作函数
+    engine.register_action("known", [&](const json&, Context&) { known += 100; });
+    ctx.set("x", TICKS + 2);
+    engine.tick(ctx);
+    bool replaced = known == TICKS + 101;
+    ok = ok && replaced;
+    cout << "   " << (replaced ? "✓" : "✗") << " 重新注册的动作函数替换原有绑定" << endl;
+
+    cout << "\n=== 动作绑定测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
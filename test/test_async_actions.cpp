@@ -0,0 +1,162 @@
+#include "../runtime/runtime.h"
+#include <iostream>
+#include <atomic>
+#include <mutex>
+#include <map>
+#include <thread>
+#include <chrono>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+// 多条规则共用动作，用于检查不同的顺序保证
+static const char* RULES = R"({
+    "rules": [
+        {"id": "a", "when": {"left": "seq", "op": ">", "right": 0},
+         "do": [{"action": "log", "params": {"rule": "a"}}, {"action": "serial", "params": {}}], "priority": 10},
+        {"id": "b", "when": {"left": "seq", "op": ">", "right": 0},
+         "do": [{"action": "log", "params": {"rule": "b"}}, {"action": "serial", "params": {}}], "priority": 20},
+        {"id": "c", "when": {"left": "seq", "op": ">", "right": 0},
+         "do": [{"action": "log", "params": {"rule": "c"}}, {"action": "serial", "params": {}}], "priority": 30},
+        {"id": "slow", "when": {"left": "slow", "op": "==", "right": true},
+         "do": [{"action": "slow", "params": {}}], "priority": 40},
+        {"id": "writer", "when": {"left": "seq", "op": "==", "right": 1},
+         "do": [{"action": "write", "params": {}}], "priority": 50}
+    ]
+})";
+
+int main() {
+    cout << "=== 异步动作执行测试 ===" << endl;
+    bool ok = true;
+
+    Engine engine;
+    mutex log_mutex;
+    map<string, vector<int>> sequences;     // 规则 -> 动作看到的seq
+    atomic<int> in_serial(0), max_serial(0);
+    atomic<int> slow_runs(0);
+
+    ActionOptions per_rule;
+    per_rule.async = true;
+    per_rule.ordering = ORDER_PER_RULE;
+    engine.register_action("log", [&](const json& params, Context& ctx) {
+        lock_guard<mutex> lock(log_mutex);
+        sequences[params["rule"]].push_back(ctx.get("seq").get<int>());
+    }, per_rule);
+
+    ActionOptions per_action;
+    per_action.async = true;
+    per_action.ordering = ORDER_PER_ACTION;
+    engine.register_action("serial", [&](const json&, Context&) {
+        int now = ++in_serial;
+        int seen = max_serial.load();
+        while (now > seen && !max_serial.compare_exchange_weak(seen, now)) {}
+        this_thread::sleep_for(chrono::microseconds(50));
+        --in_serial;
+    }, per_action);
+
+    ActionOptions dropping;
+    dropping.async = true;
+    dropping.ordering = ORDER_UNORDERED;
+    dropping.overflow = OVERFLOW_DROP;
+    engine.register_action("slow", [&](const json&, Context&) {
+        this_thread::sleep_for(chrono::milliseconds(20));
+        slow_runs++;
+    }, dropping);
+
+    ActionOptions writer;
+    writer.async = true;
+    engine.register_action("write", [](const json&, Context& ctx) {
+        ctx.set("written", "from_worker");
+    }, writer);
+
+    engine.load(json::parse(RULES));
+    engine.set_action_workers(4, 8);
+
+    // 1. 同一规则的动作按触发顺序执行；同一动作串行执行
+    Context ctx;
+    const int TICKS = 300;
+    for (int seq = 1; seq <= TICKS; ++seq) {
+        ctx.set("seq", seq);
+        engine.tick(ctx);
+    }
+    engine.flush_actions();
+
+    bool fifo = true;
+    for (const string rule : {"a", "b", "c"}) {
+        const vector<int>& seen = sequences[rule];
+        fifo = fifo && seen.size() == TICKS;
+        for (size_t i = 1; i < seen.size(); ++i) {
+            fifo = fifo && seen[i] == seen[i - 1] + 1;
+        }
+    }
+    ok = ok && fifo;
+    cout << "   " << (fifo ? "✓" : "✗") << " 按规则保序：每条规则的动作按触发顺序执行" << endl;
+
+    bool serial = (max_serial.load() == 1);
+    ok = ok && serial;
+    cout << "   " << (serial ? "✓" : "✗") << " 按动作串行：同一动作最大并发 " << max_serial.load() << endl;
+
+    // 2. 异步动作写入的值在下一次tick合并到Context
+    engine.tick(ctx);
+    bool merged = ctx.get("written") == "from_worker";
+    ok = ok && merged;
+    cout << "   " << (merged ? "✓" : "✗") << " 异步动作的写入在下一次tick合并" << endl;
+
+    // 3. 慢动作不阻塞tick，队列满时按策略丢弃
+    ctx.set("seq", 0);
+    ctx.set("slow", true);
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < 100; ++i) {
+        engine.tick(ctx);
+    }
+    double tick_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    json stats = engine.get_action_stats();
+    engine.flush_actions();
+    stats = engine.get_action_stats();
+
+    uint64_t dropped = stats["actions"]["slow"]["dropped"];
+    bool fast = tick_ms < 100 * 20;
+    ok = ok && fast && dropped > 0 && slow_runs.load() + dropped == 100;
+    cout << "   " << (fast ? "✓" : "✗") << " 100次tick耗时 " << static_cast<int>(tick_ms)
+         << "ms（慢动作每次20ms）" << endl;
+    cout << "   " << (dropped > 0 ? "✓" : "✗") << " 队列满时丢弃 " << dropped << " 次，执行 " << slow_runs.load() << " 次" << endl;
+
+    bool has_stats = stats["executor"]["workers"] == 4 && stats["executor"]["queue_depth"] == 0 &&
+                     stats["actions"]["log"]["executed"] == 3 * (TICKS + 1);
+    ok = ok && has_stats;
+    cout << "   " << (has_stats ? "✓" : "✗") << " 统计: 工作线程 " << stats["executor"]["workers"]
+         << ", 队列深度 " << stats["executor"]["queue_depth"]
+         << ", log执行 " << stats["actions"]["log"]["executed"] << " 次" << endl;
+
+    // 4. 按规则保序的动作队列满时等待空位，不在tick线程上越过队列中更早的调用
+    Engine inline_engine;
+    vector<int> order;
+    ActionOptions inlining;
+    inlining.async = true;
+    inlining.ordering = ORDER_PER_RULE;
+    inlining.overflow = OVERFLOW_INLINE;
+    inline_engine.register_action("record", [&](const json&, Context& ctx) {
+        this_thread::sleep_for(chrono::microseconds(500));
+        lock_guard<mutex> lock(log_mutex);
+        order.push_back(ctx.get("seq").get<int>());
+    }, inlining);
+    inline_engine.load(json::parse(R"({"rules": [{"id": "r", "when": {"left": "seq", "op": ">", "right": 0},
+        "do": [{"action": "record", "params": {}}], "throttle_ms": 0}]})"));
+    inline_engine.set_action_workers(1, 2);
+    Context inline_ctx;
+    for (int seq = 1; seq <= 50; ++seq) {
+        inline_ctx.set("seq", seq);
+        inline_engine.tick(inline_ctx);
+    }
+    inline_engine.flush_actions();
+    bool ordered = order.size() == 50 && inline_engine.get_action_stats()["actions"]["record"]["inlined"] == 0;
+    for (size_t i = 1; ordered && i < order.size(); ++i) {
+        ordered = order[i] == order[i - 1] + 1;
+    }
+    ok = ok && ordered;
+    cout << "   " << (ordered ? "✓" : "✗") << " 队列满时保序动作等待空位，" << order.size() << " 次调用按触发顺序执行" << endl;
+
+    cout << "\n=== 异步动作执行测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+#include "../runtime/runtime.h"
+#include <iostream>
+#include <random>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+// 覆盖可按列评估的数值条件、字符串比较、复合条件、表达式、ONCE、节流，
+// 以及修改Context并影响后续规则的动作
+static const char* RULES = R"({
+    "rules": [
+        {
+            "id": "hot",
+            "when": {"left": "temp", "op": ">", "right": 40},
+            "do": [{"action": "record", "params": {"rule": "hot"}}],
+            "priority": 10
+        },
+        {
+            "id": "hot_and_open",
+            "when": {
+                "all": [
+                    {"left": "temp", "op": ">=", "right": 30.5},
+                    {"left": "door", "op": "==", "right": "open"}
+                ]
+            },
+            "do": [
+                {"action": "record", "params": {"rule": "hot_and_open"}},
+                {"action": "bump", "params": {}}
+            ],
+            "priority": 20
+        },
+        {
+            "id": "humid_or_cold",
+            "when": {
+                "any": [
+                    {"left": "humidity", "op": ">=", "right": 80},
+                    {"left": "temp", "op": "<", "right": 5}
+                ]
+            },
+            "do": [{"action": "record", "params": {"rule": "humid_or_cold"}}],
+            "priority": 30
+        },
+        {
+            "id": "bump_seen",
+            "when": {
+                "expression": {
+                    "op": ">",
+                    "left": {"op": "%", "left": "bumps", "right": 3},
+                    "right": 1
+                }
+            },
+            "do": [{"action": "record", "params": {"rule": "bump_seen"}}],
+            "priority": 40
+        },
+        {
+            "id": "bumps_high",
+            "when": {"left": "bumps", "op": "!=", "right": 0},
+            "do": [{"action": "record", "params": {"rule": "bumps_high"}}],
+            "throttle_ms": 100000,
+            "priority": 45
+        },
+        {
+            "id": "once_rule",
+            "when": {"left": "humidity", "op": "<", "right": 20},
+            "do": [{"action": "record", "params": {"rule": "once_rule"}}],
+            "mode": "once",
+            "priority": 50
+        }
+    ]
+})";
+
+static const size_t DEVICES = 40;
+static const int TICKS = 500;
+
+// 为设备生成本次tick的传感器更新
+static void randomUpdate(mt19937& rng, function<void(const string&, const Value&)> set) {
+    switch (rng() % 6) {
+        case 0: set("temp", static_cast<int>(rng() % 60)); break;
+        case 1: set("temp", (rng() % 600) / 10.0); break;
+        case 2: set("door", (rng() % 2) ? "open" : "closed"); break;
+        case 3: set("humidity", static_cast<double>(rng() % 100)); break;
+        case 4: set("temp", "error"); break;
+        default: break;
+    }
+}
+
+static void registerActions(Engine& engine, vector<vector<string>>& logs, int& tick_no) {
+    engine.register_action("record", [&](const json& params, Context& ctx) {
+        size_t device = ctx.get("device").get<size_t>();
+        logs[device].push_back(to_string(tick_no) + ":" + params.value("rule", ""));
+    });
+    engine.register_action("bump", [](const json&, Context& ctx) {
+        Value bumps = ctx.get("bumps");
+        ctx.set("bumps", bumps.is_number() ? bumps.get<int>() + 1 : 1);
+    });
+}
+
+// 每个设备一个Engine和Context
+static vector<vector<string>> runSeparate(unsigned seed) {
+    vector<vector<string>> logs(DEVICES);
+    int tick_no = 0;
+    vector<unique_ptr<Engine>> engines;
+    vector<Context> contexts(DEVICES);
+    for (size_t d = 0; d < DEVICES; ++d) {
+        engines.emplace_back(new Engine());
+        registerActions(*engines.back(), logs, tick_no);
+        engines.back()->load(json::parse(RULES));
+        contexts[d].set("device", d);
+    }
+
+    mt19937 rng(seed);
+    for (tick_no = 0; tick_no < TICKS; ++tick_no) {
+        for (size_t d = 0; d < DEVICES; ++d) {
+            randomUpdate(rng, [&](const string& key, const Value& value) { contexts[d].set(key, value); });
+        }
+        for (size_t d = 0; d < DEVICES; ++d) {
+            engines[d]->tick(contexts[d]);
+        }
+    }
+    return logs;
+}
+
+// 一个Engine批量处理所有设备
+static vector<vector<string>> runBatch(unsigned seed) {
+    vector<vector<string>> logs(DEVICES);
+    int tick_no = 0;
+    Engine engine;
+    registerActions(engine, logs, tick_no);
+    engine.load(json::parse(RULES));
+
+    ContextBatch batch(DEVICES);
+    for (size_t d = 0; d < DEVICES; ++d) {
+        batch.set(d, "device", d);
+    }
+
+    mt19937 rng(seed);
+    for (tick_no = 0; tick_no < TICKS; ++tick_no) {
+        for (size_t d = 0; d < DEVICES; ++d) {
+            randomUpdate(rng, [&](const string& key, const Value& value) { batch.set(d, key, value); });
+        }
+        engine.tick_batch(batch);
+    }
+    return logs;
+}
+
+int main() {
+    cout << "=== 批量设备规则评估测试 ===" << endl;
+
+    bool ok = true;
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        vector<vector<string>> expected = runSeparate(seed);
+        vector<vector<string>> actual = runBatch(seed);
+        size_t fired = 0;
+        for (const auto& log : expected) fired += log.size();
+        bool same = (expected == actual);
+        ok = ok && same;
+        cout << "   随机序列 " << seed << ": " << DEVICES << " 个设备触发 " << fired << " 次, "
+             << (same ? "✓ 批量评估与逐设备评估一致" : "✗ 批量评估与逐设备评估不一致") << endl;
+    }
+
+    // 规则顺序变化后，设备的ONCE状态按规则ID保留
+    Engine engine;
+    vector<vector<string>> logs(2);
+    int tick_no = 0;
+    registerActions(engine, logs, tick_no);
+    engine.load(json::parse(RULES));
+    ContextBatch batch(2);
+    batch.set(0, "device", 0);
+    batch.set(1, "device", 1);
+    batch.set(0, "humidity", 10);
+    batch.set(1, "humidity", 50);
+    engine.tick_batch(batch);
+    engine.set_rule_priority("once_rule", 1);
+    batch.set(1, "humidity", 10);
+    tick_no = 1;
+    engine.tick_batch(batch);
+    // 只统计once_rule
+    auto onceFires = [](const vector<string>& log) {
+        vector<string> fires;
+        for (const auto& entry : log) {
+            if (entry.find("once_rule") != string::npos) fires.push_back(entry);
+        }
+        return fires;
+    };
+    bool kept = (onceFires(logs[0]) == vector<string>{"0:once_rule"}) &&
+                (onceFires(logs[1]) == vector<string>{"1:once_rule"});
+    ok = ok && kept;
+    cout << "   " << (kept ? "✓" : "✗") << " 调整优先级后设备的ONCE状态保持不变" << endl;
+
+    cout << "\n=== 批量设备规则评估测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+#include "../runtime/runtime.h"
+#include "test_util.h"
+#include <iostream>
+#include <chrono>
+#include <ctime>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+// 指定本地时间的时钟快照
+static ClockSnapshot clockAt(int hour, int minute, int day) {
+    ClockSnapshot clock;
+    clock.wall_time = 1;
+    clock.minute_of_day = hour * 60 + minute;
+    clock.day_of_week = day;
+    return clock;
+}
+
+static bool evalAt(const shared_ptr<ExprNode>& expr, Context& ctx, int hour, int minute) {
+    ctx.setClock(clockAt(hour, minute, 1));
+    return expr->evaluateScalar(ctx).truthy();
+}
+
+int main() {
+    cout << "=== 时钟快照测试 ===" << endl;
+    bool ok = true;
+
+    // 1. 时刻解析
+    check(ok, ClockSnapshot::parseTimeOfDay("08:00") == 480 && ClockSnapshot::parseTimeOfDay("9:05") == 545 &&
+              ClockSnapshot::parseTimeOfDay("23:59:59") == 1439 && ClockSnapshot::parseTimeOfDay("00:00") == 0,
+          "解析 HH:MM 和 HH:MM:SS");
+    check(ok, ClockSnapshot::parseTimeOfDay("24:00") < 0 && ClockSnapshot::parseTimeOfDay("8") < 0 &&
+              ClockSnapshot::parseTimeOfDay("08:60") < 0 && ClockSnapshot::parseTimeOfDay("08:00:") < 0 &&
+              ClockSnapshot::parseTimeOfDay("now") < 0 && ClockSnapshot::parseTimeOfDay("") < 0,
+          "拒绝格式错误的时刻");
+
+    // 2. 加载时换算边界：JSON形式（字符串参数为变量名）和文本形式结果相同
+    auto from_json = ExpressionParser::parse(json::parse(
+        R"({"func": "time_between", "args": ["now", "08:00", "18:00"]})"));
+    auto from_text = ExpressionParser::parseString("time_between(now, '08:00', '18:00')");
+    bool prepared = true;
+    for (const auto& expr : {from_json, from_text}) {
+        prepared = prepared && expr && expr->children.size() == 3 &&
+                   expr->children[0]->literal.isString() &&
+                   expr->children[1]->type == EXPR_VALUE && expr->children[1]->literal.asInt() == 480 &&
+                   expr->children[2]->type == EXPR_VALUE && expr->children[2]->literal.asInt() == 1080;
+    }
+    check(ok, prepared, "常量边界在加载时换算为分钟数，now 换成快照时间");
+
+    Context ctx;
+    bool daytime = true;
+    for (const auto& expr : {from_json, from_text}) {
+        daytime = daytime && !evalAt(expr, ctx, 7, 59) && evalAt(expr, ctx, 8, 0) &&
+                  evalAt(expr, ctx, 17, 59) && !evalAt(expr, ctx, 18, 0);
+    }
+    check(ok, daytime, "time_between 按快照时间判断 [08:00, 18:00)");
+
+    auto overnight = ExpressionParser::parseString("time_between(now, '22:00', '06:00')");
+    check(ok, evalAt(overnight, ctx, 23, 30) && evalAt(overnight, ctx, 5, 59) &&
+              !evalAt(overnight, ctx, 6, 0) && !evalAt(overnight, ctx, 12, 0),
+          "起点晚于终点的区间跨越午夜");
+
+    // 边界来自变量：运行时解析字符串或直接使用分钟数
+    ctx.set("open", "07:15");
+    ctx.set("close", 600);
+    ctx.set("arrival", "09:59");
+    auto dynamic = ExpressionParser::parseString("time_between(now, open, close) && time_between(arrival, open, close)");
+    check(ok, evalAt(dynamic, ctx, 7, 15) && !evalAt(dynamic, ctx, 10, 0),
+          "变量中的时刻字符串和分钟数");
+
+    auto weekday = ExpressionParser::parse(json::parse(R"({"func": "day_of_week", "args": ["now"]})"));
+    ctx.setClock(clockAt(12, 0, 6));
+    check(ok, weekday->evaluateScalar(ctx).asInt() == 6, "day_of_week 取快照的星期");
+
+    // 3. 引擎每次tick写入快照
+    Engine engine;
+    int fired = 0;
+    engine.register_action("count", [&](const json&, Context&) { fired++; });
+    ClockSnapshot live = ClockSnapshot::now();
+    auto hhmm = [](int minute) {
+        string hours = to_string(minute / 60), minutes = to_string(minute % 60);
+        return string(2 - hours.size(), '0') + hours + ":" + string(2 - minutes.size(), '0') + minutes;
+    };
+    string start = hhmm(live.minute_of_day);
+    string end = hhmm((live.minute_of_day + 2) % 1440);
+    json rules = {{"rules", json::array()}};
+    for (int i = 0; i < 300; ++i) {
+        rules["rules"].push_back({
+            {"id", "schedule_" + to_string(i)},
+            {"when", {{"expression", string("time_between(now, '") + start + "', '" + end + "') && day_of_week(now) >= 0"}}},
+            {"do", {{{"action", "count"}}}},
+            {"throttle_ms", 0}
+        });
+    }
+    engine.load(rules);
+    Context live_ctx;
+    engine.tick(live_ctx);
+    time_t now = time(nullptr);
+    struct tm local;
+    localtime_r(&now, &local);
+    check(ok, live_ctx.clock().valid() && live_ctx.clock().day_of_week == local.tm_wday,
+          "tick 写入的快照与本地时间一致");
+    check(ok, fired == 300, "300 条时间规则按快照触发（" + to_string(fired) + "）");
+
+    // 4. 求值耗时（仅供参考）
+    const int TICKS = 200;
+    auto begin = chrono::steady_clock::now();
+    for (int i = 0; i < TICKS; ++i) engine.tick(live_ctx);
+    double us = chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count() / TICKS;
+    cout << "   300 条时间规则：" << static_cast<int>(us) << "us/tick" << endl;
+
+    cout << "\n=== 时钟快照测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
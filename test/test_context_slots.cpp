@@ -0,0 +1,85 @@
+#include "../runtime/runtime.h"
+#include "test_util.h"
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+int main() {
+    cout << "=== 上下文槽位测试 ===" << endl;
+    bool ok = true;
+    SymbolTable& symbols = SymbolTable::global();
+
+    // 1. 符号表：intern分配稠密槽位，重复注册返回原槽位，lookup不注册
+    size_t before = symbols.size();
+    SlotId speed = symbols.intern("slots.speed");
+    SlotId mode = symbols.intern("slots.mode");
+    check(ok, speed == before && mode == before + 1 && symbols.size() == before + 2,
+          "新键名依次分配槽位");
+    check(ok, symbols.intern("slots.speed") == speed && symbols.size() == before + 2,
+          "重复intern返回原槽位，不增加数量");
+    check(ok, symbols.lookup("slots.mode") == mode && symbols.name(mode) == "slots.mode",
+          "lookup与name互为反向映射");
+    check(ok, symbols.lookup("slots.unknown") == INVALID_SLOT && symbols.size() == before + 2,
+          "未注册的键lookup返回INVALID_SLOT且不注册");
+
+    // 2. 多线程同时注册同一批键名，每个键只得到一个槽位
+    vector<vector<SlotId>> seen(4);
+    vector<thread> threads;
+    for (size_t t = 0; t < seen.size(); ++t) {
+        threads.emplace_back([&seen, t]() {
+            for (int i = 0; i < 100; ++i) {
+                seen[t].push_back(SymbolTable::global().intern("slots.concurrent" + to_string(i)));
+            }
+        });
+    }
+    for (auto& worker : threads) worker.join();
+    bool same = true;
+    for (const auto& slots : seen) same = same && slots == seen[0];
+    for (int i = 0; i < 100; ++i) {
+        same = same && symbols.name(seen[0][i]) == "slots.concurrent" + to_string(i);
+    }
+    check(ok, same && symbols.size() == before + 102, "并发intern结果一致");
+
+    // 3. 字符串键的set/get经过槽位
+    Context ctx;
+    ctx.set("slots.speed", 42);
+    ctx.set("slots.mode", Scalar::fromString("auto"));
+    ctx.set("slots.config", json{{"limit", 3}});
+    SlotId config = symbols.lookup("slots.config");
+    check(ok, config != INVALID_SLOT && ctx.hasSlot(speed) && ctx.hasSlot(config),
+          "set注册键名并写入对应槽位");
+    check(ok, ctx.getSlot(speed).asInt() == 42 && ctx.getSlot(mode).str() == "auto",
+          "按槽位读出字符串键写入的值");
+    ctx.setSlot(speed, Scalar::fromDouble(1.5));
+    check(ok, ctx.get("slots.speed") == 1.5 && ctx.get("slots.mode") == "auto" &&
+              ctx.get("slots.config") == json({{"limit", 3}}),
+          "按键名读出槽位写入的值（含对象）");
+    check(ok, ctx.get("slots.unknown").is_null() && !ctx.has("slots.unknown") &&
+              symbols.lookup("slots.unknown") == INVALID_SLOT,
+          "读取未注册的键返回null且不注册");
+
+    // 4. keys()按槽位列出已写入的键，注册过但未写入的槽位不出现
+    vector<string> keys = ctx.keys();
+    sort(keys.begin(), keys.end());
+    check(ok, keys == vector<string>({"slots.config", "slots.mode", "slots.speed"}) && ctx.size() == 3,
+          "keys()只包含已写入的键");
+
+    // 5. clear()清空全部槽位，符号表保持不变
+    size_t registered = symbols.size();
+    ctx.clear();
+    check(ok, ctx.keys().empty() && ctx.size() == 0 && !ctx.hasSlot(speed) &&
+              ctx.getSlot(mode).isNull() && ctx.get("slots.config").is_null(),
+          "clear()后所有槽位为空");
+    check(ok, symbols.size() == registered && symbols.lookup("slots.speed") == speed,
+          "clear()不影响符号表");
+    ctx.set("slots.mode", Scalar::fromString("manual"));
+    check(ok, ctx.keys() == vector<string>({"slots.mode"}) && ctx.getSlot(mode).str() == "manual",
+          "clear()后可重新写入");
+
+    cout << (ok ? "上下文槽位测试通过" : "上下文槽位测试失败") << endl;
+    return ok ? 0 : 1;
+}
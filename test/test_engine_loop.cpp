@@ -0,0 +1,105 @@
+#include "../runtime/runtime.h"
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+static const char* RULES = R"({
+    "rules": [
+        {
+            "id": "emergency",
+            "when": {"left": "emergency_button", "op": "==", "right": "pressed"},
+            "do": [{"action": "emergency_stop", "params": {"reason": "button"}}],
+            "priority": 0
+        }
+    ]
+})";
+
+static uint64_t nowUs() {
+    return chrono::duration_cast<chrono::microseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main() {
+    cout << "=== 事件驱动运行循环测试 ===" << endl;
+    bool ok = true;
+
+    Engine engine;
+    atomic<uint64_t> fired_at(0);
+    engine.register_action("emergency_stop", [&](const json&, Context&) {
+        fired_at.store(nowUs());
+    });
+    engine.load(json::parse(RULES));
+
+    Context ctx;
+    ctx.set("emergency_button", "not_pressed");
+    EngineLoop loop(engine, ctx);
+    loop.set_fallback_interval_ms(0);
+    loop.start();
+
+    // 1. 传感器更新到动作执行的延迟
+    vector<uint64_t> latencies;
+    for (int i = 0; i < 200; ++i) {
+        fired_at.store(0);
+        uint64_t start = nowUs();
+        loop.update("emergency_button", "pressed");
+        while (fired_at.load() == 0) {
+            this_thread::yield();
+        }
+        latencies.push_back(fired_at.load() - start);
+
+        loop.update("emergency_button", "not_pressed");
+        this_thread::sleep_for(chrono::microseconds(200));
+    }
+    sort(latencies.begin(), latencies.end());
+    uint64_t median = latencies[latencies.size() / 2];
+    bool fast = median < 1000;
+    ok = ok && fast;
+    cout << "   " << (fast ? "✓" : "✗") << " 更新到动作执行延迟: 中位数 " << median
+         << "us, 最大 " << latencies.back() << "us" << endl;
+
+    // 2. 没有更新时不tick
+    json before = loop.getStats();
+    this_thread::sleep_for(chrono::milliseconds(50));
+    json after = loop.getStats();
+    bool idle = before["ticks"] == after["ticks"];
+    ok = ok && idle;
+    cout << "   " << (idle ? "✓" : "✗") << " 关闭定时tick后空闲时不执行tick" << endl;
+
+    // 3. 最小间隔内的更新合并为一次tick
+    loop.set_min_interval_us(20000);
+    loop.notify();
+    this_thread::sleep_for(chrono::milliseconds(5));
+    before = loop.getStats();
+    for (int i = 0; i < 100; ++i) {
+        loop.update("temp", i);
+    }
+    this_thread::sleep_for(chrono::milliseconds(60));
+    after = loop.getStats();
+    uint64_t ticks = after["ticks"].get<uint64_t>() - before["ticks"].get<uint64_t>();
+    bool coalesced = ticks >= 1 && ticks <= 3 && ctx.get("temp") == 99;
+    ok = ok && coalesced;
+    cout << "   " << (coalesced ? "✓" : "✗") << " 100次更新合并为 " << ticks << " 次tick" << endl;
+
+    // 4. 定时tick
+    loop.set_min_interval_us(0);
+    loop.set_fallback_interval_ms(10);
+    before = loop.getStats();
+    this_thread::sleep_for(chrono::milliseconds(105));
+    after = loop.getStats();
+    uint64_t timer_ticks = after["timer_ticks"].get<uint64_t>() - before["timer_ticks"].get<uint64_t>();
+    bool timer = timer_ticks >= 5;
+    ok = ok && timer;
+    cout << "   " << (timer ? "✓" : "✗") << " 10ms定时tick在105ms内执行 " << timer_ticks << " 次" << endl;
+
+    loop.stop();
+    cout << "   统计: " << loop.getStats().dump() << endl;
+
+    cout << "\n=== 事件驱动运行循环测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+#include "../runtime/runtime.h"
+#include "test_util.h"
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+// 字节码虚拟机与树遍历的差分测试：随机生成表达式和Context，两种求值方式的结果必须一致
+
+// 含未知操作符/函数、缺失变量、参数个数不对和缺少右操作数的表达式
+static const RandomExprSpec EXPRS = {
+    {"+", "-", "*", "/", "%", "&&", "||", "==", "!=", ">", "<", ">=", "<=", "^"},
+    {"contains", "starts_with", "ends_with", "day_of_week", "avg_last_n", "unknown"},
+    {"a", "b", "c", "name", "flag", "missing"},
+    5, 6, 1, 3, 10
+};
+
+static void randomContext(mt19937& rng, Context& ctx) {
+    ctx.set("a", static_cast<int>(rng() % 21) - 10);
+    ctx.set("b", (static_cast<int>(rng() % 200) - 100) / 4.0);
+    ctx.set("c", rng() % 3 == 0 ? json(nullptr) : json(static_cast<int>(rng() % 5)));
+    ctx.set("name", rng() % 2 ? "sensor_a" : "a_sensor");
+    ctx.set("flag", rng() % 2 == 0);
+}
+
+int main() {
+    cout << "=== 表达式字节码测试 ===" << endl;
+    bool ok = true;
+
+    // 1. 编译结果：操作码、常量池和槽位
+    auto expr = ExpressionParser::parse({
+        {"op", ">"},
+        {"left", {{"op", "+"}, {"left", "a"}, {"right", "b"}}},
+        {"right", 10}
+    });
+    bool compiled = expr->program && expr->program->size() == 5 && expr->program->stackDepth() == 2;
+    ok = ok && compiled;
+    cout << "   " << (compiled ? "✓" : "✗") << " (a + b) > 10 编译为 " << (expr->program ? expr->program->size() : 0)
+         << " 条指令" << endl;
+    if (expr->program) cout << expr->program->disassemble();
+
+    // 2. 随机表达式差分测试
+    mt19937 rng(2024);
+    const int EXPRESSIONS = 3000, CONTEXTS = 20;
+    int mismatches = 0, programs = 0;
+    Context ctx;
+    for (int i = 0; i < EXPRESSIONS; ++i) {
+        json source = randomExpr(rng, 1 + static_cast<int>(rng() % 6), EXPRS);
+        auto node = ExpressionParser::parse(source);
+        if (node->program) programs++;
+        for (int c = 0; c < CONTEXTS; ++c) {
+            randomContext(rng, ctx);
+            string vm = node->evaluateScalar(ctx).toJson().dump();
+            string tree = node->evaluateTree(ctx).toJson().dump();
+            if (vm != tree) {
+                if (mismatches++ < 5) {
+                    cout << "     不一致: " << source.dump() << " 虚拟机=" << vm << " 树遍历=" << tree << endl;
+                }
+            }
+        }
+    }
+    bool same = mismatches == 0 && programs > EXPRESSIONS / 2;
+    ok = ok && same;
+    cout << "   " << (same ? "✓" : "✗") << " " << EXPRESSIONS << " 个随机表达式（" << programs << " 个已编译）× "
+         << CONTEXTS << " 个Context，结果一致" << endl;
+
+    // 3. 嵌套过深的表达式不编译，仍可按树求值
+    json deep = "a";
+    for (int i = 0; i < 100; ++i) {
+        deep = {{"op", "+"}, {"left", 1}, {"right", deep}};
+    }
+    auto deepNode = ExpressionParser::parse(deep);
+    ctx.set("a", 1);
+    bool fallback = !deepNode->program && deepNode->evaluateScalar(ctx).asInt() == 101;
+    ok = ok && fallback;
+    cout << "   " << (fallback ? "✓" : "✗") << " 超过栈深度上限的表达式回退到树遍历" << endl;
+
+    // 4. 规则条件使用字节码求值
+    Engine engine;
+    int fired = 0;
+    engine.register_action("count", [&](const json&, Context&) { fired++; });
+    engine.load(json::parse(R"({
+        "rules": [{
+            "id": "product",
+            "when": {"expression": {"op": ">", "left": {"op": "*", "left": "a", "right": "b"}, "right": 20}},
+            "do": [{"action": "count", "params": {}}]
+        }]
+    })"));
+    Context rule_ctx;
+    rule_ctx.set("a", 5);
+    rule_ctx.set("b", 5);
+    engine.tick(rule_ctx);
+    rule_ctx.set("b", 2);
+    engine.tick(rule_ctx);
+    bool rule = fired == 1;
+    ok = ok && rule;
+    cout << "   " << (rule ? "✓" : "✗") << " 表达式规则按字节码求值触发" << endl;
+
+    // 谓词网络合并后再编译：共享子树编译为调用，使用缓存结果
+    PredicateNetwork network;
+    vector<shared_ptr<Condition>> roots;
+    for (const char* text : {"a * b > 20 && flag", "a * b < 100"}) {
+        auto condition = make_shared<Condition>();
+        condition->use_expression = true;
+        condition->expression = ExpressionParser::parseTree(string(text));
+        roots.push_back(network.intern(condition));
+    }
+    network.markShared(roots);
+    network.compile();
+    const auto& first = roots[0]->expression;
+    const auto& second = roots[1]->expression;
+    bool consistent = true;
+    for (int i = 0; i < CONTEXTS; ++i) {
+        randomContext(rng, ctx);
+        consistent = consistent && first->program->run(ctx) == first->evaluateTree(ctx) &&
+                                  second->program->run(ctx) == second->evaluateTree(ctx);
+    }
+    bool shared = first->program && second->program &&
+                  first->program->disassemble().find("CALL") != string::npos &&
+                  second->program->disassemble().find("CALL") != string::npos &&
+                  first->children[0]->children[0] == second->children[0] && consistent;
+    ok = ok && shared;
+    cout << "   " << (shared ? "✓" : "✗") << " 合并后编译，共享子树不内联" << endl;
+
+    // 5. 耗时对比（仅供参考）
+    auto bench = ExpressionParser::parse({
+        {"op", "&&"},
+        {"left", {{"op", ">"}, {"left", {{"op", "+"}, {"left", "a"}, {"right", "b"}}}, {"right", 3}}},
+        {"right", {{"op", "<="}, {"left", {{"op", "*"}, {"left", "a"}, {"right", 2}}}, {"right", 100}}}
+    });
+    randomContext(rng, ctx);
+    const int ITERATIONS = 200000;
+    volatile int64_t sink = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i) sink = sink + bench->evaluateScalar(ctx).truthy();
+    double vm_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ITERATIONS;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i) sink = sink + bench->evaluateTree(ctx).truthy();
+    double tree_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / ITERATIONS;
+    cout << "   虚拟机 " << static_cast<int>(vm_ns) << "ns / 树遍历 " << static_cast<int>(tree_ns) << "ns" << endl;
+
+    cout << "\n=== 表达式字节码测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,178 @@
+#include "../runtime/runtime.h"
+#include "test_util.h"
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+// 随机JSON表达式及其中缀文本（只加必要的括号，检验优先级和结合性）
+static const RandomExprSpec EXPRS = {
+    {"+", "-", "*", "/", "%", "&&", "||", "==", "!=", ">", "<", ">=", "<="},
+    {"contains", "ends_with"},
+    {"a", "b"}
+};
+
+static int precedence(const string& op) {
+    if (op == "||") return 1;
+    if (op == "&&") return 2;
+    if (op == "==" || op == "!=") return 3;
+    if (op == "<" || op == ">" || op == "<=" || op == ">=") return 4;
+    if (op == "+" || op == "-") return 5;
+    return 6;
+}
+
+static string toInfix(const json& expr) {
+    if (expr.is_string()) return expr.get<string>();
+    if (!expr.is_object()) return expr.dump();
+    if (expr.contains("func")) {
+        return expr["func"].get<string>() + "(" + toInfix(expr["args"][0]) + ", " + toInfix(expr["args"][1]) + ")";
+    }
+    string op = expr["op"];
+    int prec = precedence(op);
+    auto side = [&](const json& child, bool right) {
+        string text = toInfix(child);
+        if (child.is_object() && child.contains("op")) {
+            int child_prec = precedence(child["op"]);
+            if (child_prec < prec || (right && child_prec == prec)) return "(" + text + ")";
+        }
+        return text;
+    };
+    return side(expr["left"], false) + " " + op + " " + side(expr["right"], true);
+}
+
+static json makeRules(size_t count, bool text) {
+    json rules = json::array();
+    for (size_t i = 0; i < count; ++i) {
+        int threshold = static_cast<int>(i % 10);
+        json when;
+        if (text) {
+            when = {{"expression", "(temp > " + to_string(threshold) + ") && (humidity < 60 || fan == 'off')"}};
+        } else {
+            when = {{"expression", {
+                {"op", "&&"},
+                {"left", {{"op", ">"}, {"left", "temp"}, {"right", threshold}}},
+                {"right", {{"op", "||"},
+                           {"left", {{"op", "<"}, {"left", "humidity"}, {"right", 60}}},
+                           {"right", {{"op", "=="}, {"left", "fan"}, {"right", "fan_off"}}}}}
+            }}};
+        }
+        rules.push_back({
+            {"id", "rule" + to_string(i)},
+            {"when", when},
+            {"do", json::array({{{"action", "count"}, {"params", json::object()}}})}
+        });
+    }
+    return {{"rules", rules}};
+}
+
+int main() {
+    cout << "=== 中缀表达式解析测试 ===" << endl;
+    bool ok = true;
+    Context ctx;
+    ctx.set("temp", 30);
+    ctx.set("humidity", 45);
+    ctx.set("weather", "sunny day");
+    ctx.set("a", 7);
+    ctx.set("b", 2);
+
+    // 1. 基本语法
+    auto weather = ExpressionParser::parseString("(temp > 25) && (humidity < 60) && contains(weather, 'sunny')");
+    check(ok, weather && weather->program && weather->evaluateScalar(ctx).asBool(),
+          "(temp > 25) && (humidity < 60) && contains(weather, 'sunny')");
+
+    auto folded = ExpressionParser::parseString("1 + 2 * 3 == 7");
+    auto left_assoc = ExpressionParser::parseString("a - b - 1");
+    auto unary = ExpressionParser::parseString("-a * 2 + -(b - 4)");
+    auto negation = ExpressionParser::parseString("!(a > 3) || !false");
+    check(ok, folded && ExprOptimizer::isConstant(*folded) && folded->literal.asBool(),
+          "乘法优先于加法，常量表达式折叠为 true");
+    check(ok, left_assoc && left_assoc->evaluateScalar(ctx).asInt() == 4, "a - b - 1 左结合 = 4");
+    check(ok, unary && unary->evaluateScalar(ctx).asInt() == -12, "-a * 2 + -(b - 4) = -12");
+    check(ok, negation && negation->evaluateScalar(ctx).isBool() && negation->evaluateScalar(ctx).asBool(),
+          "!(a > 3) || !false = true");
+
+    // 2. 与等价JSON表达式的差分测试
+    mt19937 rng(11);
+    const int EXPRESSIONS = 3000;
+    int mismatches = 0, failures = 0;
+    for (int i = 0; i < EXPRESSIONS; ++i) {
+        json source = randomExpr(rng, 1 + static_cast<int>(rng() % 5), EXPRS);
+        string text = toInfix(source);
+        string error;
+        auto from_text = ExpressionParser::parseString(text, &error);
+        auto from_json = ExpressionParser::parse(source);
+        if (!from_text) {
+            if (failures++ < 5) cout << "     解析失败: " << text << " " << error << endl;
+            continue;
+        }
+        for (int c = 0; c < 10; ++c) {
+            ctx.set("a", static_cast<int>(rng() % 21) - 10);
+            ctx.set("b", (static_cast<int>(rng() % 21) - 10) / 2.0);
+            string expected = from_json->evaluateScalar(ctx).toJson().dump();
+            string actual = from_text->evaluateScalar(ctx).toJson().dump();
+            if (expected != actual && mismatches++ < 5) {
+                cout << "     不一致: " << text << " 期望=" << expected << " 实际=" << actual << endl;
+            }
+        }
+    }
+    check(ok, mismatches == 0 && failures == 0,
+          to_string(EXPRESSIONS) + " 个随机表达式的文本形式与JSON形式结果一致");
+
+    // 3. 语法错误
+    const char* invalid[] = {"a >", "(a + 1", "a $ b", "'abc", "contains(a,", "a b", "* 2", "1.2.3"};
+    int rejected = 0;
+    for (const char* text : invalid) {
+        string error;
+        if (!ExpressionParser::parseString(text, &error) && !error.empty()) {
+            rejected++;
+            cout << "     " << text << " => " << error << endl;
+        }
+    }
+    check(ok, rejected == 8, "语法错误返回空指针并给出位置");
+
+    // 4. 引擎按文本缓存表达式：1000条规则只有10种表达式
+    Engine engine;
+    int fired = 0;
+    engine.register_action("count", [&](const json&, Context&) { fired++; });
+    engine.load(makeRules(1000, true));
+    json stats = engine.get_predicate_stats();
+    check(ok, stats["cached_expressions"] == 10 && stats["expression_cache_hits"] == 990,
+          "10 种表达式文本各解析一次，缓存命中 " + stats["expression_cache_hits"].dump() + " 次");
+
+    ExpressionCache cache;
+    auto first = cache.get("temp + 1 > humidity");
+    auto second = cache.get("temp + 1 > humidity");
+    check(ok, first && second && first != second && first->children[0] != second->children[0] &&
+              first->children[0]->children[1]->literal == second->children[0]->children[1]->literal && cache.hits() == 1,
+          "缓存返回树的副本，合并谓词网络时不会改写缓存中的节点");
+
+    Context rule_ctx;
+    rule_ctx.set("temp", 5);
+    rule_ctx.set("humidity", 80);
+    rule_ctx.set("fan", "off");
+    engine.tick(rule_ctx);
+    check(ok, fired == 500, "temp = 5 时 threshold < 5 的 500 条规则触发");
+
+    // 5. 加载耗时对比（仅供参考）
+    const size_t RULES = 5000;
+    json text_cfg = makeRules(RULES, true);
+    json json_cfg = makeRules(RULES, false);
+    string text_source = text_cfg.dump(), json_source = json_cfg.dump();
+    auto timeLoad = [](const string& source) {
+        Engine target;
+        target.register_action("count", [](const json&, Context&) {});
+        auto start = chrono::steady_clock::now();
+        target.load(json::parse(source));
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+    double json_ms = timeLoad(json_source);
+    double text_ms = timeLoad(text_source);
+    cout << "   " << RULES << " 条规则：JSON表达式 " << json_source.size() / 1024 << "KB " << static_cast<int>(json_ms)
+         << "ms，文本表达式 " << text_source.size() / 1024 << "KB " << static_cast<int>(text_ms) << "ms" << endl;
+
+    cout << "\n=== 中缀表达式解析测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
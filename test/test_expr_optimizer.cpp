@@ -0,0 +1,109 @@
+#include "../runtime/runtime.h"
+#include "test_util.h"
+#include <iostream>
+#include <random>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+static size_t countNodes(const ExprNode& node) {
+    size_t count = 1;
+    for (const auto& child : node.children) {
+        if (child) count += countNodes(*child);
+    }
+    return count;
+}
+
+// 常量较多的随机表达式，与配置工具生成的阈值类似
+static const RandomExprSpec EXPRS = {
+    {"+", "-", "*", "/", "%", "&&", "||", "==", "!=", ">", "<", ">=", "<=", "^"},
+    {"contains", "ends_with", "max_last_n", "nope"},
+    {"a", "b"},
+    6
+};
+
+int main() {
+    cout << "=== 表达式优化测试 ===" << endl;
+    bool ok = true;
+    Context ctx;
+    ctx.set("a", 40);
+    ctx.set("b", 2.5);
+
+    // 1. 常量折叠：a > 10 * 3 + 2 的右侧折叠为32
+    auto folded = ExpressionParser::parse(json::parse(R"(
+        {"op": ">", "left": "a", "right": {"op": "+", "left": {"op": "*", "left": 10, "right": 3}, "right": 2}}
+    )"));
+    check(ok, countNodes(*folded) == 3 && folded->children[1]->literal.asInt() == 32 &&
+              folded->program && folded->program->size() == 3 && folded->evaluateScalar(ctx).asBool(),
+          "常量子表达式折叠：a > 10 * 3 + 2 => a > 32");
+
+    // 2. 布尔恒等式
+    auto always_false = ExpressionParser::parse(json::parse(R"(
+        {"op": "&&", "left": {"op": ">", "left": "a", "right": 1}, "right": false}
+    )"));
+    auto always_true = ExpressionParser::parse(json::parse(R"(
+        {"op": "||", "left": true, "right": {"op": "<", "left": "b", "right": 0}}
+    )"));
+    auto identity = ExpressionParser::parse(json::parse(R"(
+        {"op": "&&", "left": true, "right": {"op": ">=", "left": "a", "right": 40}}
+    )"));
+    auto kept = ExpressionParser::parse(json::parse(R"(
+        {"op": "||", "left": "b", "right": false}
+    )"));
+    check(ok, ExprOptimizer::isConstant(*always_false) && !always_false->literal.asBool() &&
+              ExprOptimizer::isConstant(*always_true) && always_true->literal.asBool(),
+          "x && false => false，true || x => true");
+    check(ok, identity->type == EXPR_OP && identity->op == ">=" && countNodes(*identity) == 3,
+          "true && (a >= 40) => a >= 40");
+    check(ok, kept->type == EXPR_OP && kept->op == "||" && kept->evaluateScalar(ctx).asBool(),
+          "b || false 不化简为b（b不是布尔值，结果须转换为布尔）");
+
+    // 3. 恒定结果的分支：删除后不再依赖时间
+    auto dead = ExpressionParser::parse(json::parse(R"(
+        {"op": "&&",
+         "left": {"func": "time_between", "args": ["now", "08:00", "18:00"]},
+         "right": {"op": "==", "left": 1, "right": 2}}
+    )"));
+    vector<SlotId> inputs;
+    bool time_dependent = false;
+    dead->collectInputs(inputs, time_dependent);
+    auto unknown = ExpressionParser::parse(json::parse(R"({"op": "^", "left": "a", "right": "b"})"));
+    check(ok, ExprOptimizer::isConstant(*dead) && !time_dependent && inputs.empty() &&
+              ExprOptimizer::isConstant(*unknown) && unknown->literal.isNull(),
+          "结果恒定的分支被删除，条件不再依赖时间和输入");
+
+    // 4. 优化统计
+    ExprOptimizer::Stats stats;
+    ExprOptimizer::optimize(ExpressionParser::parseRecursive(json::parse(R"(
+        {"op": "||", "left": {"op": "<", "left": "a", "right": {"op": "/", "left": 100, "right": 4}}, "right": false}
+    )")), &stats);
+    check(ok, stats.folded == 1 && stats.simplified == 1, "统计折叠和化简的节点数");
+
+    // 5. 差分测试：优化后的表达式与未优化的树遍历结果一致
+    mt19937 rng(99);
+    const int EXPRESSIONS = 3000;
+    int mismatches = 0;
+    size_t before = 0, after = 0;
+    for (int i = 0; i < EXPRESSIONS; ++i) {
+        json source = randomExpr(rng, 1 + static_cast<int>(rng() % 5), EXPRS);
+        auto reference = ExpressionParser::parseRecursive(source);
+        auto optimized = ExpressionParser::parse(source);
+        before += countNodes(*reference);
+        after += countNodes(*optimized);
+        for (int c = 0; c < 10; ++c) {
+            ctx.set("a", static_cast<int>(rng() % 21) - 10);
+            ctx.set("b", (static_cast<int>(rng() % 21) - 10) / 2.0);
+            string expected = reference->evaluateTree(ctx).toJson().dump();
+            string actual = optimized->evaluateScalar(ctx).toJson().dump();
+            if (expected != actual && mismatches++ < 5) {
+                cout << "     不一致: " << source.dump() << " 期望=" << expected << " 实际=" << actual << endl;
+            }
+        }
+    }
+    check(ok, mismatches == 0 && after < before,
+          to_string(EXPRESSIONS) + " 个随机表达式优化后结果不变，节点数 " + to_string(before) + " => " + to_string(after));
+
+    cout << "\n=== 表达式优化测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
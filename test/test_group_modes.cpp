@@ -0,0 +1,132 @@
+#include "../runtime/runtime.h"
+#include <iostream>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+// 互斥的风扇档位：温度越高档位越高，同一时刻只应打开一个档位
+static const char* RULES = R"({
+    "groups": {
+        "fan": {"mode": "first_match"},
+        "alert": {"mode": "highest_n", "limit": 2}
+    },
+    "rules": [
+        {"id": "fan_high", "when": {"left": "temp", "op": ">", "right": 35},
+         "do": [{"action": "fan_on", "params": {"speed": "high"}}], "priority": 1, "group": "fan"},
+        {"id": "fan_mid", "when": {"left": "temp", "op": ">", "right": 28},
+         "do": [{"action": "fan_on", "params": {"speed": "mid"}}], "priority": 2, "group": "fan"},
+        {"id": "fan_low", "when": {"left": "temp", "op": ">", "right": 22},
+         "do": [{"action": "fan_on", "params": {"speed": "low"}}], "priority": 3, "group": "fan"},
+        {"id": "alert_a", "when": {"left": "temp", "op": ">", "right": 30},
+         "do": [{"action": "alert", "params": {"id": "a"}}], "priority": 10, "group": "alert"},
+        {"id": "alert_b", "when": {"left": "temp", "op": ">", "right": 30},
+         "do": [{"action": "alert", "params": {"id": "b"}}], "priority": 11, "group": "alert"},
+        {"id": "alert_c", "when": {"left": "temp", "op": ">", "right": 30},
+         "do": [{"action": "alert", "params": {"id": "c"}}], "priority": 12, "group": "alert"},
+        {"id": "log", "when": {"left": "temp", "op": ">", "right": 0},
+         "do": [{"action": "log", "params": {}}], "priority": 20}
+    ]
+})";
+
+static json makeLargeGroup(size_t count) {
+    json rules = json::array();
+    for (size_t i = 0; i < count; ++i) {
+        rules.push_back({
+            {"id", "level" + to_string(i)},
+            {"when", {{"left", "level"}, {"op", ">="}, {"right", static_cast<int>(count - i)}}},
+            {"do", json::array({{{"action", "count"}, {"params", json::object()}}})},
+            {"priority", static_cast<int>(i)},
+            {"group", "levels"}
+        });
+    }
+    return {{"groups", {{"levels", {{"mode", "first_match"}}}}}, {"rules", rules}};
+}
+
+int main() {
+    cout << "=== 规则组冲突处理测试 ===" << endl;
+    bool ok = true;
+
+    Engine engine;
+    vector<string> fan, alerts;
+    int logs = 0;
+    engine.register_action("fan_on", [&](const json& params, Context&) { fan.push_back(params["speed"]); });
+    engine.register_action("alert", [&](const json& params, Context&) { alerts.push_back(params["id"]); });
+    engine.register_action("log", [&](const json&, Context&) { logs++; });
+    engine.load(json::parse(RULES));
+
+    // 1. first_match：只触发条件成立的最高档位
+    Context ctx;
+    ctx.set("temp", 40);
+    engine.tick(ctx);
+    bool first = fan == vector<string>{"high"} && engine.get_rule_group_mode("fan").mode == GROUP_FIRST_MATCH;
+    fan.clear();
+    ctx.set("temp", 30);
+    engine.tick(ctx);
+    first = first && fan == vector<string>{"mid"};
+    ok = ok && first;
+    cout << "   " << (first ? "✓" : "✗") << " first_match组每次只触发优先级最高的一条规则" << endl;
+
+    // 2. highest_n：最多触发2条（第二次tick温度为30，报警规则不成立）；不属于任何组的规则不受影响
+    bool highest = alerts == vector<string>{"a", "b"} && logs == 2;
+    ok = ok && highest;
+    cout << "   " << (highest ? "✓" : "✗") << " highest_n组最多触发N条，未分组规则照常触发" << endl;
+
+    // 3. 通过接口切换为all_match后全部触发
+    engine.set_rule_group_mode("fan", GROUP_ALL_MATCH);
+    fan.clear();
+    ctx.set("temp", 36);
+    engine.tick(ctx);
+    bool all = fan == vector<string>{"high", "mid", "low"};
+    engine.set_rule_group_mode("fan", GROUP_FIRST_MATCH);
+    ok = ok && all;
+    cout << "   " << (all ? "✓" : "✗") << " 切换为all_match后组内规则全部触发" << endl;
+
+    // 4. 批量评估按设备分别计数
+    ContextBatch batch(3);
+    batch.set(0, "temp", 40);
+    batch.set(1, "temp", 25);
+    batch.set(2, "temp", 10);
+    fan.clear();
+    engine.tick_batch(batch);
+    bool batched = fan == vector<string>{"high", "low"};
+    ok = ok && batched;
+    cout << "   " << (batched ? "✓" : "✗") << " 批量评估时每个设备分别只触发一个档位" << endl;
+
+    // 5. 组内规则很多时，触发第一条后不再评估其余规则
+    const size_t COUNT = 1000;
+    Engine large;
+    size_t fired = 0;
+    large.register_action("count", [&](const json&, Context&) { fired++; });
+    large.load(makeLargeGroup(COUNT));
+    Context levels;
+    levels.set("level", static_cast<int>(COUNT));
+    large.tick(levels);
+    uint64_t evaluated = large.get_evaluation_count();
+    bool skipped = fired == 1 && evaluated == 1;
+
+    large.set_rule_group_mode("levels", GROUP_ALL_MATCH);
+    levels.set("level", static_cast<int>(COUNT) + 1);
+    large.tick(levels);
+    skipped = skipped && fired == 1 + COUNT && large.get_evaluation_count() - evaluated == COUNT;
+    ok = ok && skipped;
+    cout << "   " << (skipped ? "✓" : "✗") << " " << COUNT << " 条规则的first_match组只评估了 " << evaluated
+         << " 条（all_match评估 " << COUNT << " 条）" << endl;
+
+    // 6. 重新加载时以配置为准：配置中删除的组恢复为all_match
+    json reloaded = json::parse(RULES);
+    reloaded["groups"].erase("fan");
+    engine.load(reloaded);
+    fan.clear();
+    alerts.clear();
+    ctx.set("temp", 40);
+    engine.tick(ctx);
+    bool reverted = fan == vector<string>{"high", "mid", "low"} && alerts == vector<string>{"a", "b"} &&
+                    engine.get_rule_group_mode("fan").mode == GROUP_ALL_MATCH;
+    ok = ok && reverted;
+    cout << "   " << (reverted ? "✓" : "✗") << " 从配置中删除的组重新加载后恢复为all_match" << endl;
+
+    cout << "\n=== 规则组冲突处理测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
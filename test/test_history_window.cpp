@@ -0,0 +1,158 @@
+#include "../runtime/runtime.h"
+#include "test_util.h"
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+// 逐个扫描的参考实现
+struct Reference {
+    vector<double> samples;
+
+    vector<double> last(size_t n) const {
+        n = min(n, samples.size());
+        return vector<double>(samples.end() - n, samples.end());
+    }
+    double average(size_t n) const {
+        auto w = last(n);
+        double sum = 0;
+        for (double v : w) sum += v;
+        return w.empty() ? 0 : sum / w.size();
+    }
+    double maximum(size_t n) const {
+        auto w = last(n);
+        return w.empty() ? 0 : *max_element(w.begin(), w.end());
+    }
+    double minimum(size_t n) const {
+        auto w = last(n);
+        return w.empty() ? 0 : *min_element(w.begin(), w.end());
+    }
+    double trend(size_t n) const {
+        auto w = last(n);
+        if (w.size() < 2) return 0;
+        double m = w.size(), sx = 0, sy = 0, sxy = 0, sxx = 0;
+        for (size_t i = 0; i < w.size(); ++i) {
+            sx += i; sy += w[i]; sxy += i * w[i]; sxx += double(i) * i;
+        }
+        return (m * sxy - sx * sy) / (m * sxx - sx * sx);
+    }
+};
+
+static bool near(double a, double b) {
+    return fabs(a - b) <= 1e-6 * max(1.0, max(fabs(a), fabs(b)));
+}
+
+int main() {
+    cout << "=== 历史窗口测试 ===" << endl;
+    bool ok = true;
+
+    // 1. 增量聚合与逐个扫描结果一致（含中途注册窗口、未注册窗口）
+    HistoryBuffer history;
+    Reference reference;
+    history.addWindow(7);
+    history.addWindow(100);
+    mt19937 rng(5);
+    int mismatches = 0;
+    const size_t windows[] = {1, 3, 7, 50, 100, 1000};
+    for (int i = 0; i < 20000; ++i) {
+        if (i == 5000) history.addWindow(1000);
+        double value = (static_cast<int>(rng() % 2001) - 1000) / 10.0 + i * 0.01;
+        history.push(value);
+        reference.samples.push_back(value);
+        if (i % 37 != 0) continue;
+        for (size_t n : windows) {
+            // 窗口1000在第5000个样本时注册，扩大缓冲区前的样本只保留了128个
+            if (n == 1000 && i < 6000) continue;
+            if (!near(history.average(n), reference.average(n)) || !near(history.maximum(n), reference.maximum(n)) ||
+                !near(history.minimum(n), reference.minimum(n)) || !near(history.trend(n), reference.trend(n))) {
+                if (mismatches++ < 5) {
+                    cout << "     不一致: i=" << i << " n=" << n << " avg " << history.average(n) << "/" << reference.average(n)
+                         << " trend " << history.trend(n) << "/" << reference.trend(n) << endl;
+                }
+            }
+        }
+    }
+    check(ok, mismatches == 0, "20000 个样本上 avg/max/min/trend 与逐个扫描一致");
+
+    // 2. 规则中的历史函数：只为引用到的变量记录
+    Engine engine;
+    vector<string> fired;
+    engine.register_action("alert", [&](const json& params, Context&) { fired.push_back(params["id"]); });
+    engine.load(json::parse(R"({
+        "rules": [
+            {"id": "hot", "when": {"expression": "avg_last_n(temp, 5) > 30"},
+             "do": [{"action": "alert", "params": {"id": "hot"}}], "throttle_ms": 0},
+            {"id": "rising", "when": {"expression": "trend(level, 4) > 0.9 && max_last_n(level, 4) < 100"},
+             "do": [{"action": "alert", "params": {"id": "rising"}}]}
+        ]
+    })"));
+    Context ctx;
+    engine.tick(ctx);
+    ctx.set("temp", 20);
+    ctx.set("level", 0);
+    ctx.set("other", 1);
+    engine.tick(ctx);
+    SlotId other = SymbolTable::global().lookup("other");
+    check(ok, ctx.history(SymbolTable::global().lookup("temp")) && !ctx.history(other),
+          "只为表达式引用的变量注册历史记录");
+
+    // 温度：20 → 40 逐步升高，最近5个样本平均值超过30时触发
+    const int temps[] = {25, 30, 35, 40, 40, 40};
+    int hot_at = -1;
+    for (int i = 0; i < 6; ++i) {
+        ctx.set("temp", temps[i]);
+        fired.clear();
+        engine.tick(ctx);
+        if (hot_at < 0 && find(fired.begin(), fired.end(), "hot") != fired.end()) hot_at = i;
+    }
+    // 最近5个：30 35 40 40 40 = 37（i=5时）；25 30 35 40 40 = 34（i=4时）；20 25 30 35 40 = 30（i=3时不触发）
+    check(ok, hot_at == 4, "avg_last_n(temp, 5) 在第 " + to_string(hot_at) + " 个新样本时超过30");
+
+    // 水位：每次加1时趋势为1
+    bool rising = false;
+    for (int level = 1; level <= 4; ++level) {
+        ctx.set("level", level);
+        fired.clear();
+        engine.tick(ctx);
+        rising = find(fired.begin(), fired.end(), "rising") != fired.end();
+    }
+    check(ok, rising, "trend(level, 4) 对线性上升的水位为1");
+
+    // 3. 拷贝Context时一并拷贝历史记录
+    Context copy(ctx);
+    const HistoryBuffer* copied = copy.history(SymbolTable::global().lookup("temp"));
+    check(ok, copied && copied->size() == 7 && near(Eval::avg_last_n(copy, "temp", 5).get<double>(), 37),
+          "拷贝的Context保留历史记录");
+
+    // 4. 大窗口耗时：O(1)聚合与逐个扫描对比（仅供参考）
+    const size_t WINDOW = 5000;
+    const int SAMPLES = 50000;
+    HistoryBuffer large;
+    large.addWindow(WINDOW);
+    double sink = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < SAMPLES; ++i) {
+        large.push(i % 113);
+        sink += large.average(WINDOW) + large.maximum(WINDOW) + large.trend(WINDOW);
+    }
+    double incremental_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / SAMPLES;
+    HistoryBuffer scan;
+    scan.addWindow(WINDOW + 1);     // 查询的窗口长度未注册，按样本扫描
+    for (size_t i = 0; i <= WINDOW; ++i) scan.push(i % 113);
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < SAMPLES / 50; ++i) {
+        scan.push(i % 113);
+        sink += scan.average(WINDOW) + scan.maximum(WINDOW) + scan.trend(WINDOW);
+    }
+    double scan_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / (SAMPLES / 50);
+    cout << "   窗口 " << WINDOW << "：增量聚合 " << static_cast<int>(incremental_ns) << "ns/样本，扫描 "
+         << static_cast<int>(scan_ns) << "ns/样本" << (sink > 0 ? "" : " ") << endl;
+
+    cout << "\n=== 历史窗口测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+#include "../runtime/runtime.h"
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+static json makeRule(const string& id, const string& mode, uint64_t throttle_ms, int threshold = 0) {
+    return {
+        {"id", id},
+        {"when", {{"left", "x"}, {"op", ">"}, {"right", threshold}}},
+        {"do", json::array({{{"action", "record"}, {"params", {{"id", id}}}}})},
+        {"mode", mode},
+        {"throttle_ms", throttle_ms}
+    };
+}
+
+// count条重复规则，加上一条ONCE规则；variant不同时多出一条规则并调整其中一条的阈值
+static json makeConfig(size_t count, int variant) {
+    json rules = json::array();
+    rules.push_back(makeRule("once", "once", 0));
+    for (size_t i = 0; i < count; ++i) {
+        rules.push_back(makeRule("r" + to_string(i), "repeat", 0, (i == 0) ? -variant : 0));
+    }
+    if (variant % 2) {
+        rules.push_back(makeRule("extra" + to_string(variant), "repeat", 0));
+    }
+    return {{"rules", rules}};
+}
+
+int main() {
+    cout << "=== 规则集热替换测试 ===" << endl;
+    bool ok = true;
+
+    // 1. 重新加载后同ID规则保留上次触发时间和ONCE状态，未变化的规则复用原型
+    {
+        Engine engine;
+        vector<string> fired;
+        engine.register_action("record", [&](const json& params, Context&) {
+            fired.push_back(params["id"]);
+        });
+        json cfg = {{"rules", json::array({
+            makeRule("once", "once", 0),
+            makeRule("slow", "repeat", 60000),
+            makeRule("changed", "repeat", 0)
+        })}};
+        engine.load(cfg);
+        auto slow_source = engine.get_rule_by_id("slow")->source;
+        auto changed_source = engine.get_rule_by_id("changed")->source;
+
+        Context ctx;
+        ctx.set("x", 1);
+        engine.tick(ctx);
+        bool first = fired.size() == 3;
+
+        cfg["rules"][2] = makeRule("changed", "repeat", 0, -1);
+        cfg["rules"].push_back(makeRule("added", "repeat", 0));
+        engine.load(cfg);
+        fired.clear();
+        ctx.set("x", 2);
+        engine.tick(ctx);
+
+        sort(fired.begin(), fired.end());
+        bool carried = first && fired == vector<string>({"added", "changed"}) &&
+                       engine.get_rule_by_id("once")->disabled;
+        bool reused = engine.get_rule_by_id("slow")->source == slow_source &&
+                      engine.get_rule_by_id("changed")->source != changed_source;
+        ok = ok && carried && reused;
+        cout << "   " << (carried ? "✓" : "✗") << " 重新加载后保留节流时间和ONCE状态" << endl;
+        cout << "   " << (reused ? "✓" : "✗") << " 未变化的规则复用，变化的规则重新解析" << endl;
+    }
+
+    // 重新加载后规则组的启用状态重置
+    {
+        Engine engine;
+        int fired = 0;
+        engine.register_action("record", [&](const json&, Context&) { fired++; });
+        json grouped = makeRule("grouped", "repeat", 0);
+        grouped["group"] = "g";
+        json cfg = {{"rules", json::array({grouped})}};
+        engine.load(cfg);
+        engine.disable_rule_group("g");
+        Context ctx;
+        ctx.set("x", 1);
+        engine.tick(ctx);
+        bool disabled = fired == 0;
+        engine.load(cfg);
+        engine.tick(ctx);
+        bool reset = disabled && fired == 1;
+        ok = ok && reset;
+        cout << "   " << (reset ? "✓" : "✗") << " 重新加载后规则组恢复为启用" << endl;
+    }
+
+    // 2. 后台不断推送新配置，tick不等待构建，且每次tick都完整执行一个规则集
+    {
+        const size_t COUNT = 5000;
+        Engine engine;
+        atomic<size_t> repeat_fires(0), once_fires(0);
+        engine.register_action("record", [&](const json& params, Context&) {
+            const string& id = params["id"].get_ref<const string&>();
+            if (id == "once") {
+                once_fires++;
+            } else if (id[0] == 'r') {
+                repeat_fires++;
+            }
+        });
+        engine.load(makeConfig(COUNT, 0));
+
+        vector<json> configs;
+        for (int v = 1; v <= 8; ++v) {
+            configs.push_back(makeConfig(COUNT, v));
+        }
+
+        atomic<bool> done(false);
+        atomic<int> loads(0);
+        thread pusher([&] {
+            for (int i = 0; i < 20; ++i) {
+                engine.load_async(configs[i % configs.size()]);
+                engine.wait_for_load();
+                loads++;
+                this_thread::sleep_for(chrono::milliseconds(5));
+            }
+            done = true;
+        });
+
+        Context ctx;
+        size_t ticks = 0, misfires = 0;
+        double max_ms = 0, total_ms = 0;
+        while (!done || ticks < 10) {
+            ctx.set("x", static_cast<int>(ticks % 7) + 1);
+            repeat_fires = 0;
+            auto start = chrono::steady_clock::now();
+            engine.tick(ctx);
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            max_ms = max(max_ms, ms);
+            total_ms += ms;
+            if (repeat_fires != COUNT) misfires++;
+            ticks++;
+        }
+        pusher.join();
+
+        bool stable = misfires == 0 && once_fires == 1 && loads == 20;
+        ok = ok && stable;
+        cout << "   " << (stable ? "✓" : "✗") << " " << loads << " 次后台加载期间执行 " << ticks << " 次tick，"
+             << "漏触发/多触发 " << misfires << " 次，ONCE规则触发 " << once_fires << " 次" << endl;
+        cout << "     tick平均 " << total_ms / ticks << "ms，最长 " << max_ms << "ms" << endl;
+    }
+
+    cout << "\n=== 规则集热替换测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,151 @@
+#include "../runtime/runtime.h"
+#include <iostream>
+#include <random>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+// 规则配置：简单条件、复合条件、表达式，以及一个会修改Context的动作
+// 部分规则之间有相同的子条件，用于覆盖谓词网络的共享节点
+static const char* RULES = R"({
+    "rules": [
+        {
+            "id": "hot",
+            "when": {"left": "temp", "op": ">", "right": 40},
+            "do": [{"action": "record", "params": {"rule": "hot"}}],
+            "priority": 10
+        },
+        {
+            "id": "hot_and_open",
+            "when": {
+                "all": [
+                    {"left": "temp", "op": ">", "right": 30},
+                    {"left": "door", "op": "==", "right": "open"}
+                ]
+            },
+            "do": [
+                {"action": "record", "params": {"rule": "hot_and_open"}},
+                {"action": "bump", "params": {}}
+            ],
+            "priority": 20
+        },
+        {
+            "id": "humid_or_cold",
+            "when": {
+                "any": [
+                    {"left": "humidity", "op": ">=", "right": 80},
+                    {"left": "temp", "op": "<", "right": 5}
+                ]
+            },
+            "do": [{"action": "record", "params": {"rule": "humid_or_cold"}}],
+            "throttle_ms": 0,
+            "priority": 30
+        },
+        {
+            "id": "bump_seen",
+            "when": {
+                "expression": {
+                    "op": ">",
+                    "left": {"op": "%", "left": "bumps", "right": 3},
+                    "right": 1
+                }
+            },
+            "do": [{"action": "record", "params": {"rule": "bump_seen"}}],
+            "priority": 40
+        },
+        {
+            "id": "open_and_humid",
+            "when": {
+                "all": [
+                    {"left": "door", "op": "==", "right": "open"},
+                    {
+                        "any": [
+                            {"left": "humidity", "op": ">=", "right": 80},
+                            {"left": "temp", "op": "<", "right": 5}
+                        ]
+                    }
+                ]
+            },
+            "do": [{"action": "record", "params": {"rule": "open_and_humid"}}],
+            "priority": 45
+        },
+        {
+            "id": "bump_twice",
+            "when": {
+                "expression": {
+                    "op": "&&",
+                    "left": {"op": ">", "left": {"op": "%", "left": "bumps", "right": 3}, "right": 1},
+                    "right": {"op": ">", "left": "temp", "right": 30}
+                }
+            },
+            "do": [{"action": "record", "params": {"rule": "bump_twice"}}],
+            "priority": 46
+        },
+        {
+            "id": "once_rule",
+            "when": {"left": "humidity", "op": "<", "right": 20},
+            "do": [{"action": "record", "params": {"rule": "once_rule"}}],
+            "mode": "once",
+            "priority": 50
+        }
+    ]
+})";
+
+// 以给定模式运行随机传感器序列，返回每次tick触发的规则记录
+static vector<string> run(bool incremental, unsigned seed, json* stats = nullptr) {
+    Engine engine;
+    vector<string> log;
+    int tick_no = 0;
+
+    engine.register_action("record", [&](const json& params, Context&) {
+        log.push_back(to_string(tick_no) + ":" + params.value("rule", ""));
+    });
+    engine.register_action("bump", [](const json&, Context& ctx) {
+        Value bumps = ctx.get("bumps");
+        ctx.set("bumps", bumps.is_number() ? bumps.get<int>() + 1 : 1);
+    });
+
+    engine.load(json::parse(RULES));
+    engine.set_incremental(incremental);
+    if (stats) *stats = engine.get_predicate_stats();
+
+    mt19937 rng(seed);
+    Context ctx;
+    for (tick_no = 0; tick_no < 2000; ++tick_no) {
+        // 每次tick只修改少量传感器
+        switch (rng() % 5) {
+            case 0: ctx.set("temp", static_cast<int>(rng() % 60)); break;
+            case 1: ctx.set("door", (rng() % 2) ? "open" : "closed"); break;
+            case 2: ctx.set("humidity", static_cast<double>(rng() % 100)); break;
+            default: break;
+        }
+        engine.tick(ctx);
+    }
+    return log;
+}
+
+int main() {
+    cout << "=== 增量规则评估测试 ===" << endl;
+
+    bool ok = true;
+    json stats;
+    run(true, 0, &stats);
+    cout << "   谓词网络: " << stats.dump() << endl;
+    if (stats.value("shared_nodes", 0) == 0) {
+        cout << "   ✗ 未识别出共享的条件节点" << endl;
+        ok = false;
+    }
+
+    for (unsigned seed = 1; seed <= 5; ++seed) {
+        vector<string> full = run(false, seed);
+        vector<string> incremental = run(true, seed);
+        bool same = (full == incremental);
+        ok = ok && same;
+        cout << "   随机序列 " << seed << ": 触发 " << full.size() << " 次, "
+             << (same ? "✓ 增量评估结果与全量评估一致" : "✗ 增量评估结果不一致") << endl;
+    }
+
+    cout << "\n=== 增量规则评估测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+#include "../runtime/runtime.h"
+#include <iostream>
+#include <random>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+// 生成足够多的规则以触发并行评估；每隔若干条规则带一个修改Context的动作，
+// 用于验证动作修改Context后后续规则看到的是新值
+static json makeRules(size_t count) {
+    json rules = json::array();
+    mt19937 rng(2024);
+    for (size_t i = 0; i < count; ++i) {
+        string a = "s" + to_string(rng() % 16);
+        string b = "s" + to_string(rng() % 16);
+        int threshold = static_cast<int>(rng() % 100);
+
+        json when;
+        switch (i % 4) {
+            case 0:
+                when = {{"left", a}, {"op", ">"}, {"right", threshold}};
+                break;
+            case 1:
+                when = {{"any", json::array({
+                    {{"left", a}, {"op", "<"}, {"right", threshold / 4}},
+                    {{"left", "counter"}, {"op", "=="}, {"right", threshold % 8}}
+                })}};
+                break;
+            case 2:
+                when = {{"expression", {
+                    {"op", ">"},
+                    {"left", {{"op", "+"}, {"left", a}, {"right", b}}},
+                    {"right", threshold * 2}
+                }}};
+                break;
+            default:
+                when = {{"left", "counter"}, {"op", ">="}, {"right", threshold % 16}};
+                break;
+        }
+
+        json actions = json::array({{{"action", "record"}, {"params", {{"rule", i}}}}});
+        if (i % 97 == 0) {
+            actions.push_back({{"action", "bump"}, {"params", json::object()}});
+        }
+
+        json rule = {
+            {"id", "r" + to_string(i)},
+            {"when", when},
+            {"do", actions},
+            {"priority", static_cast<int>(rng() % 500)}
+        };
+        if (i % 50 == 0) rule["mode"] = "once";
+        rules.push_back(rule);
+    }
+    return {{"rules", rules}};
+}
+
+// 以给定线程数运行随机传感器序列，返回触发记录
+static vector<string> run(size_t threads, bool incremental, unsigned seed) {
+    Engine engine;
+    vector<string> log;
+    int tick_no = 0;
+
+    engine.register_action("record", [&](const json& params, Context&) {
+        log.push_back(to_string(tick_no) + ":" + params["rule"].dump());
+    });
+    engine.register_action("bump", [](const json&, Context& ctx) {
+        Value counter = ctx.get("counter");
+        ctx.set("counter", counter.is_number() ? (counter.get<int>() + 1) % 16 : 1);
+    });
+
+    engine.load(makeRules(1500));
+    engine.set_incremental(incremental);
+    engine.set_thread_count(threads);
+
+    mt19937 rng(seed);
+    Context ctx;
+    for (tick_no = 0; tick_no < 200; ++tick_no) {
+        for (int i = 0; i < 3; ++i) {
+            ctx.set("s" + to_string(rng() % 16), static_cast<int>(rng() % 100));
+        }
+        engine.tick(ctx);
+    }
+    return log;
+}
+
+int main() {
+    cout << "=== 并行规则评估测试 ===" << endl;
+
+    bool ok = true;
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        for (bool incremental : {false, true}) {
+            vector<string> expected = run(1, incremental, seed);
+            for (size_t threads : {2, 4, 8}) {
+                bool same = (run(threads, incremental, seed) == expected);
+                ok = ok && same;
+                cout << "   随机序列 " << seed << (incremental ? " (增量)" : " (全量)")
+                     << ", " << threads << " 线程: 触发 " << expected.size() << " 次, "
+                     << (same ? "✓ 与单线程结果一致" : "✗ 与单线程结果不一致") << endl;
+            }
+        }
+    }
+
+    cout << "\n=== 并行规则评估测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+#include "../runtime/runtime.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <chrono>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+static json makeRules(size_t count) {
+    json rules = json::array();
+    for (size_t i = 0; i < count; ++i) {
+        rules.push_back({
+            {"id", "r" + to_string(i)},
+            {"when", {{"left", "x"}, {"op", ">"}, {"right", static_cast<int>(i % 10)}}},
+            {"do", json::array({{{"action", (i % 2) ? "slow" : "fast"}}})}
+        });
+    }
+    return {{"rules", rules}};
+}
+
+static double tickUs(Engine& engine, Context& ctx, int ticks) {
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < ticks; ++i) {
+        ctx.set("x", i % 20);
+        engine.tick(ctx);
+    }
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / ticks;
+}
+
+int main() {
+    cout << "=== 性能剖析测试 ===" << endl;
+    bool ok = true;
+
+    Engine engine;
+    engine.register_action("fast", [](const json&, Context&) {});
+    ActionOptions async;
+    async.async = true;
+    engine.register_action("slow", [](const json&, Context&) {
+        this_thread::sleep_for(chrono::microseconds(50));
+    }, async);
+    engine.set_action_workers(1);
+    engine.load(makeRules(10));
+
+    // 1. 关闭时不记录
+    Context ctx;
+    tickUs(engine, ctx, 20);
+    engine.flush_actions();
+    bool silent = !engine.is_profiling() && engine.get_profile()["rules"].empty() &&
+                  engine.get_profile()["actions"].empty();
+    ok = ok && silent;
+    cout << "   " << (silent ? "✓" : "✗") << " 关闭时不记录任何数据" << endl;
+
+    // 2. 开启后记录每条规则的评估和触发次数，以及同步/异步动作的耗时直方图
+    engine.set_profiling(true);
+    const int TICKS = 20;
+    tickUs(engine, ctx, TICKS);
+    engine.flush_actions();
+    json profile = engine.get_profile();
+
+    // x依次取0..19，规则ri在x>i%10时触发
+    bool counted = profile["rules"].size() == 10;
+    for (size_t i = 0; i < 10 && counted; ++i) {
+        const json& rule = profile["rules"]["r" + to_string(i)];
+        counted = rule["evaluations"] == TICKS && rule["fires"] == 19 - i % 10;
+    }
+    uint64_t histogram_total = 0;
+    for (const auto& bucket : profile["actions"]["slow"]["histogram"]) {
+        histogram_total += bucket["count"].get<uint64_t>();
+    }
+    uint64_t slow_calls = profile["actions"]["slow"]["calls"];
+    counted = counted && slow_calls == histogram_total && slow_calls > 0 &&
+              profile["actions"]["slow"]["avg_us"].get<double>() >= 50 &&
+              profile["actions"].contains("fast");
+    ok = ok && counted;
+    cout << "   " << (counted ? "✓" : "✗") << " 规则评估/触发次数和动作耗时直方图正确"
+         << "（slow平均 " << profile["actions"]["slow"]["avg_us"].get<double>() << "us）" << endl;
+
+    // 3. 导出Prometheus文本
+    bool dumped = engine.dump_profile("profile_test.prom");
+    ifstream file("profile_test.prom");
+    stringstream text;
+    text << file.rdbuf();
+    string prom = text.str();
+    dumped = dumped &&
+             prom.find("# TYPE snipper_rule_eval_seconds_total counter") != string::npos &&
+             prom.find("snipper_rule_fires_total{rule=\"r0\"} 19") != string::npos &&
+             prom.find("snipper_action_duration_seconds_bucket{action=\"slow\",le=\"+Inf\"} " +
+                       to_string(slow_calls)) != string::npos &&
+             prom.find("le=\"0.000001000\"") != string::npos &&
+             prom.find("e-0") == string::npos && prom.find("e+0") == string::npos;
+    remove("profile_test.prom");
+    ok = ok && dumped;
+    cout << "   " << (dumped ? "✓" : "✗") << " 导出Prometheus文本文件，秒数按纳秒精度定点输出" << endl;
+
+    // 4. 开关开销（只输出参考数据）
+    Engine plain, profiled;
+    for (Engine* e : {&plain, &profiled}) {
+        e->register_action("fast", [](const json&, Context&) {});
+        e->register_action("slow", [](const json&, Context&) {});
+        e->load(makeRules(5000));
+    }
+    Context a, b;
+    tickUs(plain, a, 50);
+    tickUs(profiled, b, 50);
+    double off = tickUs(plain, a, 200);
+    profiled.set_profiling(true);
+    double on = tickUs(profiled, b, 200);
+    cout << "     5000条规则每次tick：关闭 " << off << "us，开启 " << on << "us" << endl;
+
+    cout << "\n=== 性能剖析测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+#include "../runtime/runtime.h"
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+static json makeRules(size_t count) {
+    json rules = json::array();
+    for (size_t i = 0; i < count; ++i) {
+        rules.push_back({
+            {"id", "r" + to_string(i)},
+            {"when", {{"left", "x"}, {"op", ">"}, {"right", 0}}},
+            {"do", json::array({{{"action", "record"}, {"params", {{"id", "r" + to_string(i)}}}}})},
+            {"priority", static_cast<int>((i * 7919) % 1000)},
+            {"group", "g" + to_string(i % 5)}
+        });
+    }
+    return {{"rules", rules}};
+}
+
+// 视图顺序是否与按(优先级, ID)完整排序的结果一致
+static bool isSorted(const RuleView& view) {
+    for (size_t i = 1; i < view.size(); ++i) {
+        if (!(view[i - 1] < view[i])) return false;
+    }
+    return true;
+}
+
+int main() {
+    cout << "=== 规则句柄与索引测试 ===" << endl;
+    bool ok = true;
+
+    Engine engine;
+    vector<string> fired;
+    engine.register_action("record", [&](const json& params, Context&) {
+        fired.push_back(params["id"]);
+    });
+    const size_t COUNT = 2000;
+    engine.load(makeRules(COUNT));
+
+    // 1. 句柄在调整优先级后保持不变
+    RuleHandle handle = engine.find_rule("r42");
+    Rule* before = engine.get_rule(handle);
+    engine.set_rule_priority("r42", 0);
+    bool stable = handle != INVALID_RULE && engine.find_rule("r42") == handle &&
+                  engine.get_rule(handle) == before && engine.get_rule_by_id("r42") == before &&
+                  engine.find_rule("missing") == INVALID_RULE;
+    ok = ok && stable;
+    cout << "   " << (stable ? "✓" : "✗") << " 调整优先级后规则句柄和地址不变" << endl;
+
+    // 2. 随机调整优先级后，执行顺序、全部规则视图和组视图都保持有序
+    mt19937 rng(7);
+    const int CHANGES = 20000;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < CHANGES; ++i) {
+        engine.set_rule_priority(static_cast<RuleHandle>(rng() % COUNT), static_cast<int>(rng() % 1001));
+    }
+    double us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / CHANGES;
+
+    bool sorted = isSorted(engine.get_all_rules()) && engine.get_all_rules().size() == COUNT;
+    size_t group_total = 0;
+    for (int g = 0; g < 5; ++g) {
+        RuleView group = engine.get_rules_by_group("g" + to_string(g));
+        sorted = sorted && isSorted(group);
+        for (const auto& rule : group) {
+            sorted = sorted && rule.group == "g" + to_string(g);
+        }
+        group_total += group.size();
+    }
+    sorted = sorted && group_total == COUNT && engine.get_rules_by_group("none").empty();
+    ok = ok && sorted;
+    cout << "   " << (sorted ? "✓" : "✗") << " " << CHANGES << " 次优先级调整后视图保持按优先级排列（平均每次 "
+         << static_cast<int>(us) << "us）" << endl;
+
+    Context ctx;
+    ctx.set("x", 1);
+    engine.tick(ctx);
+    vector<string> expected;
+    for (const auto& rule : engine.get_all_rules()) {
+        expected.push_back(rule.id);
+    }
+    bool order = fired == expected;
+    ok = ok && order;
+    cout << "   " << (order ? "✓" : "✗") << " tick按调整后的优先级顺序执行" << endl;
+
+    // 3. 按句柄禁用/启用
+    engine.disable_rule(handle);
+    fired.clear();
+    ctx.set("x", 2);
+    engine.tick(ctx);
+    bool disabled = find(fired.begin(), fired.end(), "r42") == fired.end() && fired.size() == COUNT - 1;
+    engine.enable_rule("r42");
+    ok = ok && disabled && !engine.get_rule(handle)->disabled;
+    cout << "   " << (disabled ? "✓" : "✗") << " 按句柄禁用规则" << endl;
+
+    cout << "\n=== 规则句柄与索引测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+#include "../runtime/runtime.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+static json makeRule(const string& id, uint64_t throttle_ms, const string& mode = "repeat",
+                     const string& group = "", const string& action = "record") {
+    return {
+        {"id", id},
+        {"when", {{"left", "x"}, {"op", ">"}, {"right", 0}}},
+        {"do", json::array({{{"action", action}, {"params", {{"id", id}}}}})},
+        {"throttle_ms", throttle_ms},
+        {"mode", mode},
+        {"group", group}
+    };
+}
+
+static double tickMs(Engine& engine, Context& ctx, int ticks) {
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < ticks; ++i) {
+        engine.tick(ctx);
+    }
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() / ticks;
+}
+
+int main() {
+    cout << "=== 规则唤醒测试 ===" << endl;
+    bool ok = true;
+
+    // 1. 节流中和已触发的ONCE规则不参与tick
+    {
+        const size_t COUNT = 100000;
+        json rules = json::array();
+        for (size_t i = 0; i < COUNT; ++i) {
+            rules.push_back(makeRule("slow" + to_string(i), 600000, (i % 2) ? "once" : "repeat"));
+        }
+        rules.push_back(makeRule("fast", 0));
+
+        Engine engine;
+        size_t fired = 0;
+        engine.register_action("record", [&](const json&, Context&) { fired++; });
+        engine.load({{"rules", rules}});
+
+        // 第一次tick前设定上次触发时间：偶数编号的规则节流已到期，奇数编号的规则仍在节流中
+        // （无符号减法回绕，开机不足节流时间时同样成立）
+        uint64_t now = Engine::now_ms();
+        for (size_t i = 0; i < COUNT; ++i) {
+            engine.get_rule_by_id("slow" + to_string(i))->last_fire = (i % 2) ? now : now - 600000;
+        }
+
+        Context ctx;
+        ctx.set("x", 1);
+        fired = 0;
+        double first = tickMs(engine, ctx, 1);
+        size_t first_fired = fired;
+        fired = 0;
+        const int TICKS = 1000;
+        double idle = tickMs(engine, ctx, TICKS);
+
+        bool skipped = fired == TICKS && first_fired == COUNT / 2 + 1;
+        ok = ok && skipped;
+        cout << "   " << (skipped ? "✓" : "✗") << " " << COUNT << " 条节流/ONCE规则之后的tick只执行未节流的规则"
+             << "（首次 " << first << "ms，之后每次 " << idle * 1000 << "us）" << endl;
+    }
+
+    // 2. 节流到期后规则重新执行
+    {
+        Engine engine;
+        vector<string> fired;
+        engine.register_action("record", [&](const json& params, Context&) {
+            fired.push_back(params["id"]);
+        });
+        engine.load({{"rules", json::array({makeRule("t", 30)})}});
+        Context ctx;
+        ctx.set("x", 1);
+
+        engine.tick(ctx);
+        size_t first = fired.size();
+        engine.tick(ctx);
+        bool throttled = fired.size() == first;
+        this_thread::sleep_for(chrono::milliseconds(40));
+        engine.tick(ctx);
+        bool woke = throttled && fired.size() == first + 1;
+        ok = ok && woke;
+        cout << "   " << (woke ? "✓" : "✗") << " 节流期间跳过，到期后重新执行" << endl;
+    }
+
+    // 3. 通过接口禁用/启用规则和规则组，动作中禁用规则组对同一次tick中排在后面的规则生效
+    {
+        Engine engine;
+        vector<string> fired;
+        engine.register_action("record", [&](const json& params, Context&) {
+            fired.push_back(params["id"]);
+        });
+        engine.register_action("stop_group", [&](const json& params, Context&) {
+            fired.push_back(params["id"]);
+            engine.disable_rule_group("g");
+        });
+        json rules = json::array({makeRule("a", 0, "repeat", "", "stop_group"), makeRule("b", 0, "repeat", "g")});
+        rules[0]["priority"] = 1;
+        engine.load({{"rules", rules}});
+        Context ctx;
+        ctx.set("x", 1);
+
+        engine.tick(ctx);
+        bool group_stopped = fired == vector<string>({"a"});
+        engine.enable_rule_group("g");
+        engine.disable_rule("a");
+        fired.clear();
+        engine.tick(ctx);
+        bool rule_disabled = fired == vector<string>({"b"});
+        engine.enable_rule("a");
+        fired.clear();
+        engine.tick(ctx);
+        bool reenabled = fired == vector<string>({"a"});
+
+        bool states = group_stopped && rule_disabled && reenabled;
+        ok = ok && states;
+        cout << "   " << (states ? "✓" : "✗") << " 规则和规则组的启用状态变化立即反映到就绪规则" << endl;
+    }
+
+    cout << "\n=== 规则唤醒测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
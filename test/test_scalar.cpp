@@ -0,0 +1,131 @@
+#include "../runtime/runtime.h"
+#include "test_util.h"
+#include <iostream>
+#include <utility>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+// 树遍历与字节码结果一致时返回树遍历的结果
+static bool evalBoth(const shared_ptr<ExprNode>& expr, const Context& ctx, bool& same) {
+    Scalar tree = expr->evaluateTree(ctx);
+    if (expr->program) same = same && (expr->program->run(ctx) == tree);
+    return tree.truthy();
+}
+
+int main() {
+    cout << "=== 标量测试 ===" << endl;
+    bool ok = true;
+    const string long_text = "a sensor reading longer than the inline capacity";
+
+    // 1. 三种字符串形式
+    Scalar inline_value = Scalar::fromString("door");
+    Scalar heap_value = Scalar::fromString(long_text);
+    Scalar pooled_value = Scalar::fromLiteral(long_text);
+    check(ok, !inline_value.ownsHeap() && heap_value.ownsHeap() && !pooled_value.ownsHeap() &&
+              inline_value.heapRefs() == 0 && heap_value.heapRefs() == 1 && pooled_value.heapRefs() == 0,
+          "短字符串内联，运行时长字符串在堆上，常量长字符串在池中");
+    check(ok, Scalar::fromString(string(Scalar::INLINE_CAPACITY, 'x')).heapRefs() == 0 &&
+              Scalar::fromString(string(Scalar::INLINE_CAPACITY + 1, 'x')).heapRefs() == 1,
+          "内联容量边界为" + to_string(Scalar::INLINE_CAPACITY) + "字节");
+
+    // 2. 堆字符串的引用计数：拷贝、移动、自赋值
+    {
+        Scalar copy(heap_value);
+        check(ok, heap_value.heapRefs() == 2 && copy.str() == long_text, "拷贝构造共享堆字符串，引用计数加一");
+        Scalar assigned = Scalar::fromInt(1);
+        assigned = copy;
+        check(ok, heap_value.heapRefs() == 3 && assigned.str() == long_text, "拷贝赋值引用计数加一");
+        Scalar moved(std::move(copy));
+        check(ok, heap_value.heapRefs() == 3 && copy.isNull() && !copy.ownsHeap() && moved.str() == long_text,
+              "移动构造不改变引用计数，源变为空值");
+        assigned = std::move(moved);
+        check(ok, heap_value.heapRefs() == 2 && moved.isNull() && assigned.str() == long_text,
+              "移动赋值释放原值，引用计数减一");
+        Scalar& self = assigned;
+        assigned = self;
+        check(ok, heap_value.heapRefs() == 2 && assigned.str() == long_text, "拷贝自赋值引用计数不变");
+        assigned = std::move(self);
+        check(ok, heap_value.heapRefs() == 2 && assigned.str() == long_text, "移动自赋值保持原值");
+        assigned = Scalar::fromString("short");
+        check(ok, heap_value.heapRefs() == 1 && assigned.str() == "short", "覆盖为内联字符串时释放堆字符串");
+    }
+    check(ok, heap_value.heapRefs() == 1, "副本析构后引用计数恢复为1");
+
+    // 3. 不同形式的字符串按内容比较
+    Scalar heap_b = Scalar::fromString("a sensor reading longer than the inline capacitz");
+    check(ok, heap_value == pooled_value && pooled_value == heap_value &&
+              Scalar::fromString(long_text) == heap_value && !(heap_value < pooled_value) &&
+              !(pooled_value < heap_value),
+          "等值的堆上和池中字符串相等");
+    check(ok, heap_value < heap_b && pooled_value < heap_b && heap_b > Scalar::fromLiteral(long_text) &&
+              heap_value != heap_b,
+          "堆上和池中字符串按字典序比较");
+    check(ok, Scalar::fromString("door") == Scalar::fromLiteral("door") &&
+              heap_value < inline_value && Scalar::fromString("b") > heap_value &&
+              Scalar::fromString("a sensor") < Scalar::fromLiteral(long_text) &&
+              Scalar::fromString("") < inline_value,
+          "内联字符串与堆上、池中字符串按内容比较");
+
+    // 4. 跨类型比较与json一致（数字按数值比较，其余按 null < bool < 数字 < 字符串）
+    vector<json> values = {nullptr, false, true, -3, 0, 2, 2.0, 2.5, -0.5, 1e18,
+                           json(uint64_t(7)), "", "2", "door", long_text, "zzz"};
+    int mismatches = 0;
+    for (const auto& a : values) {
+        for (const auto& b : values) {
+            Scalar x = Scalar::fromJson(a), y = Scalar::fromJson(b);
+            if ((x == y) != (a == b) || (x < y) != (a < b) || (x <= y) != (a <= b) ||
+                (x > y) != (a > b) || (x >= y) != (a >= b)) {
+                ++mismatches;
+                cout << "     不一致: " << a.dump() << " vs " << b.dump() << endl;
+            }
+        }
+    }
+    check(ok, mismatches == 0, to_string(values.size() * values.size()) + " 对值的比较结果与json相同");
+
+    // 5. fromJson/toJson往返
+    vector<json> round_trip = {nullptr, true, false, 0, -42, INT64_MAX, INT64_MIN, 3.25, -1e-9,
+                               json(uint64_t(42)), json(uint64_t(INT64_MAX)), json(UINT64_MAX),
+                               "", "door", long_text};
+    bool same = true;
+    for (const auto& value : round_trip) same = same && Scalar::fromJson(value).toJson() == value;
+    check(ok, same, "标量json往返后相等");
+    check(ok, Scalar::fromJson(json(uint64_t(42))).type() == ScalarType::INT &&
+              Scalar::fromJson(json(UINT64_MAX)).asDouble() > 1e19,
+          "uint64在int64范围内转为整数，超出范围转为浮点而不是负数");
+    Scalar object = Scalar::fromJson(json{{"limit", 3}});
+    check(ok, object.isJson() && Scalar::fromJson(json::array({1, 2})).isJson() && object.toJson().is_null(),
+          "对象和数组只保留类型标签");
+    Context ctx;
+    ctx.set("scalar.config", json{{"limit", 3}, {"modes", {"auto", "manual"}}});
+    ctx.set("scalar.big", json(UINT64_MAX));
+    SlotId config = SymbolTable::global().lookup("scalar.config");
+    check(ok, ctx.getSlot(config).isJson() &&
+              ctx.get("scalar.config") == json({{"limit", 3}, {"modes", {"auto", "manual"}}}) &&
+              ctx.get("scalar.big") == json(UINT64_MAX),
+          "对象内容经Context完整往返");
+
+    // 6. 运行时的字符串不进入字符串池，长字符串与等值的常量比较结果不变
+    auto joined = ExpressionParser::parseString("door + '_sensor_state' == 'front_door_sensor_state'");
+    auto listed = ExpressionParser::parseString("equals_any(door, 'front_door_left_open', 'back_door')");
+    size_t pooled = Scalar::pooledStrings();
+    Context doors;
+    bool runtime_same = true;
+    int joined_hits = 0, listed_hits = 0;
+    for (int i = 0; i < 10000; ++i) {
+        string door = (i % 100 == 0) ? "front_door" : (i % 100 == 1) ? "front_door_left_open" : "door reading #" + to_string(i);
+        doors.set("door", door);
+        joined_hits += evalBoth(joined, doors, runtime_same);
+        listed_hits += evalBoth(listed, doors, runtime_same);
+    }
+    check(ok, runtime_same && joined_hits == 100 && listed_hits == 100 && Scalar::pooledStrings() == pooled,
+          "10000 个不同的传感器值和拼接结果未进入字符串池，比较和 equals_any 结果正确");
+    check(ok, Scalar::fromString("front_door_sensor_state") == Scalar::fromLiteral("front_door_sensor_state") &&
+              Scalar::fromString("front_door_sensor_a") < Scalar::fromLiteral("front_door_sensor_b") &&
+              Scalar::fromString("door") == Scalar::fromLiteral("door"),
+          "堆上、池中和内联的字符串按内容比较");
+
+    cout << (ok ? "标量测试通过" : "标量测试失败") << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+#include "../runtime/runtime.h"
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+static const char* RULES = R"({
+    "rules": [
+        {"id": "hot", "when": {"left": "temp", "op": ">", "right": 40},
+         "do": [{"action": "record", "params": {"rule": "hot"}}, {"action": "count", "params": {}}], "priority": 10},
+        {"id": "open", "when": {"left": "door", "op": "==", "right": "open"},
+         "do": [{"action": "record", "params": {"rule": "open"}}], "priority": 20},
+        {"id": "many", "when": {"left": "hot_count", "op": ">", "right": 3},
+         "do": [{"action": "record", "params": {"rule": "many"}}], "priority": 30}
+    ]
+})";
+
+// 在普通Context或共享Context上运行同一组更新，返回触发记录
+static vector<string> runRules(bool shared_mode, unsigned seed) {
+    Engine engine;
+    vector<string> log;
+    int tick_no = 0;
+    engine.register_action("record", [&](const json& params, Context&) {
+        log.push_back(to_string(tick_no) + ":" + params.value("rule", ""));
+    });
+    engine.register_action("count", [](const json&, Context& ctx) {
+        Value count = ctx.get("hot_count");
+        ctx.set("hot_count", count.is_number() ? count.get<int>() + 1 : 1);
+    });
+    engine.load(json::parse(RULES));
+
+    Context ctx;
+    SharedContext shared;
+    mt19937 rng(seed);
+    for (tick_no = 0; tick_no < 500; ++tick_no) {
+        string key;
+        Value value;
+        switch (rng() % 3) {
+            case 0: key = "temp"; value = static_cast<int>(rng() % 60); break;
+            case 1: key = "door"; value = (rng() % 2) ? "open" : "closed"; break;
+            default: break;
+        }
+        if (shared_mode) {
+            if (!key.empty()) shared.set(key, value);
+            engine.tick(shared);
+        } else {
+            if (!key.empty()) ctx.set(key, value);
+            engine.tick(ctx);
+        }
+    }
+    return log;
+}
+
+int main() {
+    cout << "=== 共享Context快照测试 ===" << endl;
+    bool ok = true;
+
+    // 1. 并发读写：写入方成对更新a、b，读取方的快照中两者始终相等，版本号单调递增
+    SharedContext shared(4);
+    shared.update([](Context& ctx) { ctx.set("a", 0); ctx.set("b", 0); });
+    atomic<bool> done(false);
+    atomic<int> torn(0), regressions(0);
+    atomic<uint64_t> reads(0);
+
+    vector<thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            uint64_t last = 0;
+            while (!done.load()) {
+                SharedContext::Snapshot snapshot = shared.snapshot();
+                if (snapshot->get("a") != snapshot->get("b")) torn++;
+                if (snapshot.version() < last) regressions++;
+                last = snapshot.version();
+                reads++;
+            }
+        });
+    }
+    const int WRITES = 20000;
+    for (int i = 1; i <= WRITES; ++i) {
+        shared.update([i](Context& ctx) { ctx.set("a", i); ctx.set("b", i); });
+    }
+    done.store(true);
+    for (auto& t : readers) t.join();
+
+    bool consistent = torn.load() == 0 && regressions.load() == 0 &&
+                      shared.snapshot()->get("a") == WRITES;
+    ok = ok && consistent;
+    cout << "   " << (consistent ? "✓" : "✗") << " " << WRITES << " 次发布、" << reads.load()
+         << " 次快照读取，数据不一致 " << torn.load() << " 次，版本回退 " << regressions.load() << " 次" << endl;
+
+    // 2. 快照携带版本号，只有发布新版本后才变化
+    uint64_t version = shared.version();
+    SharedContext::Snapshot held = shared.snapshot();
+    shared.set("c", 1);
+    bool versioned = held.version() == version && shared.version() == version + 1 && !held->has("c");
+    ok = ok && versioned;
+    cout << "   " << (versioned ? "✓" : "✗") << " 持有的快照不受之后的发布影响" << endl;
+
+    // 3. Engine在共享Context上运行的结果与普通Context一致，动作写入发布回共享Context
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        bool same = runRules(false, seed) == runRules(true, seed);
+        ok = ok && same;
+        cout << "   " << (same ? "✓" : "✗") << " 随机序列 " << seed << ": 共享Context上的规则触发与普通Context一致" << endl;
+    }
+
+    // 4. 行为树在共享Context的快照上执行
+    BTExecutor executor;
+    auto root = make_shared<BTSequence>("root");
+    root->addChild(make_shared<BTCondition>("door_open", [](Context& ctx) {
+        return ctx.get("door") == "open";
+    }));
+    root->addChild(make_shared<BTAction>("close_door", [](Context& ctx) {
+        ctx.set("door", "closed");
+        return BTStatus::SUCCESS;
+    }));
+    executor.setRoot(root);
+
+    SharedContext world;
+    world.set("door", "open");
+    BTStatus first = executor.execute(world);
+    BTStatus second = executor.execute(world);
+    bool bt_ok = first == BTStatus::SUCCESS && second == BTStatus::FAILURE &&
+                 world.snapshot()->get("door") == "closed";
+    ok = ok && bt_ok;
+    cout << "   " << (bt_ok ? "✓" : "✗") << " 行为树读取快照，写入发布回共享Context" << endl;
+
+    // 5. 单键写入只复制变化的槽位，各版本内容与普通Context一致
+    SharedContext wide(3);
+    Context reference;
+    mt19937 rng(7);
+    bool synced = true;
+    for (int i = 0; i < 3000; ++i) {
+        string key = "k" + to_string(rng() % 200);
+        Value value = (i % 7 == 0) ? Value({{"n", i}}) : Value(i);
+        wide.set(key, value);
+        reference.set(key, value);
+        if (i % 100 == 99) {
+            SharedContext::Snapshot snapshot = wide.snapshot();
+            synced = synced && snapshot->size() == reference.size();
+            for (const string& name : reference.keys()) {
+                synced = synced && snapshot->get(name) == reference.get(name);
+            }
+        }
+    }
+    ok = ok && synced;
+    cout << "   " << (synced ? "✓" : "✗") << " 3000 次单键发布后各版本内容与普通Context一致" << endl;
+
+    // 6. 写回时保留同步之后其他写入方对同一槽位的修改
+    SharedContext sensors;
+    sensors.set("door", "closed");
+    Context local;
+    uint64_t base = 0;
+    sensors.snapshot().syncTo(local, base);
+    uint64_t before = local.version();
+    sensors.set("door", "open");
+    local.set("door", "closed");
+    local.set("alarm", true);
+    sensors.merge(local, before, base);
+    bool kept = sensors.snapshot()->get("door") == "open" && sensors.snapshot()->get("alarm") == true;
+    ok = ok && kept;
+    cout << "   " << (kept ? "✓" : "✗") << " 写回不覆盖同步之后其他写入方写入的槽位" << endl;
+
+    cout << "\n=== 共享Context快照测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
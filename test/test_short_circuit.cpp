@@ -0,0 +1,135 @@
+#include "../runtime/runtime.h"
+#include "test_util.h"
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+// 计算量较大的表达式：a + a + ... + a > threshold
+static json expensiveExpr(int terms, int threshold) {
+    json sum = "a";
+    for (int i = 1; i < terms; ++i) {
+        sum = {{"op", "+"}, {"left", sum}, {"right", "a"}};
+    }
+    return {{"expression", {{"op", ">"}, {"left", sum}, {"right", threshold}}}};
+}
+
+// 配置顺序是先昂贵、后廉价：all中昂贵表达式总是成立，从不决定结果；
+// any中昂贵表达式（a > 16）与廉价条件（b < 2）成立的概率相近
+static json makeRules() {
+    json rules = json::array();
+    rules.push_back({
+        {"id", "guarded"},
+        {"when", {{"all", json::array({expensiveExpr(40, -1000), {{"left", "b"}, {"op", ">"}, {"right", 8}}})}}},
+        {"do", json::array({{{"action", "count"}, {"params", json::object()}}})}
+    });
+    rules.push_back({
+        {"id", "alarm"},
+        {"when", {{"any", json::array({expensiveExpr(30, 500), {{"left", "b"}, {"op", "<"}, {"right", 2}}})}}},
+        {"do", json::array({{{"action", "count"}, {"params", json::object()}}})}
+    });
+    return {{"rules", rules}};
+}
+
+static string orderString(const vector<size_t>& order) {
+    string text;
+    for (size_t index : order) text += to_string(index);
+    return text;
+}
+
+int main() {
+    cout << "=== 短路求值与自适应排序测试 ===" << endl;
+    bool ok = true;
+    Context ctx;
+
+    // 1. 表达式短路：&&/|| 编译为跳转，右操作数不再计算
+    auto guarded = ExpressionParser::parse(json::parse(R"(
+        {"op": "&&", "left": {"op": ">", "left": "a", "right": 0},
+                     "right": {"op": "<", "left": {"op": "/", "left": 100, "right": "a"}, "right": 5}}
+    )"));
+    string code = guarded->program ? guarded->program->disassemble() : "";
+    check(ok, code.find("JUMP_FALSE") != string::npos, "&& 编译为 JUMP_FALSE 跳转");
+    if (guarded->program) cout << code;
+
+    ctx.set("a", 0);
+    check(ok, !guarded->evaluateScalar(ctx).asBool() && !guarded->evaluateTree(ctx).asBool(),
+          "a > 0 不成立时不计算 100 / a");
+    ctx.set("a", 50);
+    check(ok, guarded->evaluateScalar(ctx).asBool() && guarded->evaluateTree(ctx).asBool(),
+          "a > 0 成立时计算右操作数");
+
+    auto either = ExpressionParser::parse(json::parse(R"({"op": "||", "left": "a", "right": "missing"})"));
+    auto both = ExpressionParser::parse(json::parse(R"({"op": "&&", "left": "a", "right": "b"})"));
+    ctx.set("b", 0);
+    check(ok, either->evaluateScalar(ctx).isBool() && either->evaluateScalar(ctx).asBool() &&
+              both->evaluateScalar(ctx).isBool() && !both->evaluateScalar(ctx).asBool(),
+          "短路结果仍为布尔值：50 || missing => true，50 && 0 => false");
+
+    // 2. 自适应排序：廉价且经常决定结果的子条件调到前面
+    Engine adaptive, plain;
+    int adaptive_fired = 0, plain_fired = 0;
+    adaptive.register_action("count", [&](const json&, Context&) { adaptive_fired++; });
+    plain.register_action("count", [&](const json&, Context&) { plain_fired++; });
+    adaptive.load(makeRules());
+    plain.load(makeRules());
+    adaptive.set_adaptive_ordering(true);
+
+    const Condition& all = *adaptive.get_rule_by_id("guarded")->condition;
+    const Condition& any = *adaptive.get_rule_by_id("alarm")->condition;
+    check(ok, orderString(all.evaluationOrder()) == "01" && orderString(any.evaluationOrder()) == "01",
+          "初始按配置顺序评估");
+
+    mt19937 rng(7);
+    Context adaptive_ctx, plain_ctx;
+    const int TICKS = 4096;
+    for (int i = 0; i < TICKS; ++i) {
+        int a = static_cast<int>(rng() % 20);
+        int b = static_cast<int>(rng() % 10);
+        adaptive_ctx.set("a", a);
+        adaptive_ctx.set("b", b);
+        plain_ctx.set("a", a);
+        plain_ctx.set("b", b);
+        adaptive.tick(adaptive_ctx);
+        plain.tick(plain_ctx);
+    }
+    check(ok, all.isAdaptive() && orderString(all.evaluationOrder()) == "10",
+          "all：不成立率高的 b > 8 排到昂贵表达式之前，顺序 " + orderString(all.evaluationOrder()));
+    check(ok, orderString(any.evaluationOrder()) == "10",
+          "any：成立率高的 b < 2 排到昂贵表达式之前，顺序 " + orderString(any.evaluationOrder()));
+    check(ok, adaptive_fired == plain_fired && adaptive_fired > 0,
+          "重排后触发次数与配置顺序一致（" + to_string(adaptive_fired) + " 次）");
+
+    // 3. 耗时对比（仅供参考）
+    auto timeTicks = [&](Engine& engine, Context& c) {
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < TICKS; ++i) {
+            c.set("a", i % 20);
+            c.set("b", i % 10);
+            engine.tick(c);
+        }
+        return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / TICKS;
+    };
+    double plain_ns = timeTicks(plain, plain_ctx);
+    double adaptive_ns = timeTicks(adaptive, adaptive_ctx);
+    cout << "   配置顺序 " << static_cast<int>(plain_ns) << "ns/tick，自适应顺序 "
+         << static_cast<int>(adaptive_ns) << "ns/tick" << endl;
+
+    // 4. 关闭后恢复配置顺序
+    adaptive.set_adaptive_ordering(false);
+    adaptive.tick(adaptive_ctx);
+    check(ok, !all.isAdaptive() && orderString(all.evaluationOrder()) == "01",
+          "关闭自适应排序后恢复配置顺序");
+
+    // 5. 子条件超过上限时不开启统计
+    Condition wide;
+    for (size_t i = 0; i <= Condition::MAX_ADAPTIVE_CHILDREN; ++i) {
+        wide.all.push_back(make_shared<Condition>());
+    }
+    check(ok, !wide.setAdaptive(true) && !wide.isAdaptive(), "超过16个子条件的复合条件保持配置顺序");
+
+    cout << "\n=== 短路求值与自适应排序测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
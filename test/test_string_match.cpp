@@ -0,0 +1,175 @@
+#include "../runtime/runtime.h"
+#include "../runtime/expression/string_matcher.h"
+#include "test_util.h"
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+static vector<Scalar> strings(const vector<string>& values) {
+    vector<Scalar> result;
+    for (const auto& value : values) result.push_back(Scalar::fromString(value));
+    return result;
+}
+
+static string randomText(mt19937& rng, size_t max_length, const string& alphabet) {
+    string text(rng() % (max_length + 1), ' ');
+    for (char& c : text) c = alphabet[rng() % alphabet.size()];
+    return text;
+}
+
+// 树遍历与字节码结果一致时返回树遍历的结果
+static bool evalBoth(const shared_ptr<ExprNode>& expr, const Context& ctx, bool& same) {
+    Scalar tree = expr->evaluateTree(ctx);
+    if (expr->program) same = same && (expr->program->run(ctx) == tree);
+    return tree.truthy();
+}
+
+int main() {
+    cout << "=== 字符串匹配测试 ===" << endl;
+    bool ok = true;
+
+    // 1. 原有字符串操作
+    auto s = [](const string& v) { return Scalar::fromString(v); };
+    check(ok, Eval::string_starts_with(s("temperature"), s("temp")).truthy() &&
+              !Eval::string_starts_with(s("te"), s("temp")).truthy() &&
+              Eval::string_starts_with(s("abc"), s("")).truthy() &&
+              Eval::string_ends_with(s("sensor.error"), s(".error")).truthy() &&
+              !Eval::string_ends_with(s("error"), s("an error")).truthy() &&
+              Eval::string_contains(s("overheat warning"), s("heat")).truthy() &&
+              Eval::string_contains(s("same"), s("same")).truthy() &&
+              !Eval::string_contains(s("cold"), s("heat")).truthy() &&
+              !Eval::string_contains(Scalar::fromInt(1), s("1")).truthy(),
+          "contains / starts_with / ends_with 结果不变");
+
+    // 2. contains_any：自动机与逐个查找一致（含重叠模式、前缀模式和小字母表上的大量匹配）
+    mt19937 rng(17);
+    int mismatches = 0;
+    for (int round = 0; round < 200; ++round) {
+        vector<string> patterns;
+        size_t count = 1 + rng() % 12;
+        for (size_t i = 0; i < count; ++i) patterns.push_back(randomText(rng, 5, "abcd"));
+        if (round % 10 == 0) patterns = {"he", "she", "his", "hers"};
+        auto matcher = StringMatcher::compile(StringMatcher::MATCH_CONTAINS_ANY, strings(patterns));
+        for (int t = 0; t < 50; ++t) {
+            string text = randomText(rng, 30, round % 10 == 0 ? "hersi" : "abcdef");
+            bool expected = false;
+            for (const auto& pattern : patterns) expected = expected || text.find(pattern) != string::npos;
+            if (matcher->match(Scalar::fromString(text)) != expected && mismatches++ < 5) {
+                cout << "     不一致: \"" << text << "\"" << endl;
+            }
+        }
+    }
+    check(ok, mismatches == 0, "contains_any 与逐个子串查找一致（200组模式）");
+
+    string all_bytes;
+    for (int c = 1; c < 256; ++c) all_bytes += static_cast<char>(c);
+    auto binary = StringMatcher::compile(StringMatcher::MATCH_CONTAINS_ANY, strings({all_bytes.substr(200), "\xff\x01"}));
+    check(ok, binary->match(s("x" + all_bytes.substr(200) + "y")) && binary->match(s("\xff\x01")) &&
+              !binary->match(s(all_bytes.substr(0, 200))),
+          "模式中包含任意字节");
+
+    // 3. equals_any：驻留编号哈希表
+    vector<string> words;
+    for (int i = 0; i < 1000; ++i) words.push_back("device_" + to_string(i * 7));
+    vector<Scalar> values = strings(words);
+    values.push_back(Scalar::fromInt(404));
+    auto equals = StringMatcher::compile(StringMatcher::MATCH_EQUALS_ANY, values);
+    bool exact = true;
+    for (int i = 0; i < 7000; ++i) {
+        bool expected = i % 7 == 0;
+        exact = exact && equals->match(s("device_" + to_string(i))) == expected;
+    }
+    exact = exact && equals->match(Scalar::fromInt(404)) && equals->match(Scalar::fromDouble(404.0)) &&
+            !equals->match(Scalar::fromInt(500)) && !equals->match(Scalar());
+    check(ok, exact, "equals_any 在1000个字符串和数字中精确查找");
+
+    // 4. matches：正则在加载时编译
+    auto regex_ok = StringMatcher::compile(StringMatcher::MATCH_REGEX, strings({"^E[0-9]{3}$"}));
+    string error;
+    auto regex_bad = StringMatcher::compile(StringMatcher::MATCH_REGEX, strings({"([0-9"}), &error);
+    check(ok, regex_ok && regex_ok->match(s("E042")) && !regex_ok->match(s("E42")) && !regex_ok->match(s("xE042")) &&
+              !regex_bad && !error.empty(),
+          "matches 锚定匹配，语法错误在编译时报告");
+
+    // 5. 表达式：文本与JSON形式、树遍历与字节码一致
+    Context ctx;
+    ctx.set("message", "pump overheat: E117");
+    ctx.set("code", "E117");
+    ctx.set("status", 404);
+    auto text_form = ExpressionParser::parseString(
+        "contains_any(message, 'leak', 'overheat', 'fire') && matches(code, '^E1[0-9]{2}$') && equals_any(status, 404, 500)");
+    auto json_form = ExpressionParser::parse(json::parse(R"({
+        "op": "&&",
+        "left": {"func": "contains_any", "args": ["message", "leak", "overheat", "fire"]},
+        "right": {"func": "equals_any", "args": ["code", "E117", "E118"]}
+    })"));
+    bool same = true;
+    bool matched = evalBoth(text_form, ctx, same) && evalBoth(json_form, ctx, same);
+    ctx.set("message", "pump ok");
+    matched = matched && !evalBoth(text_form, ctx, same) && !evalBoth(json_form, ctx, same);
+    check(ok, matched && same, "文本与JSON形式求值正确，字节码与树遍历一致");
+    check(ok, text_form->program && text_form->program->disassemble().find("MATCH") != string::npos,
+          "匹配函数编译为 MATCH 指令");
+
+    auto folded = ExpressionParser::parseString("contains_any('disk full', 'full', 'empty')");
+    auto bad = ExpressionParser::parseString("matches(code, '([0-9')");
+    check(ok, folded && folded->type == EXPR_VALUE && folded->literal.truthy() && bad && !bad->evaluateScalar(ctx).truthy(),
+          "常量输入在加载时折叠，无效正则结果为false");
+
+    // 6. 引擎中的规则：一个 contains_any 代替长 any 链
+    vector<string> keywords;
+    for (int i = 0; i < 50; ++i) keywords.push_back("fault" + to_string(i));
+    string expression = "contains_any(log";
+    json any_chain = json::array();
+    for (const auto& keyword : keywords) {
+        expression += ", '" + keyword + "'";
+        any_chain.push_back({{"expression", "contains(log, '" + keyword + "')"}});
+    }
+    expression += ")";
+    Engine engine;
+    int automaton_fires = 0, chain_fires = 0;
+    engine.register_action("automaton", [&](const json&, Context&) { automaton_fires++; });
+    engine.register_action("chain", [&](const json&, Context&) { chain_fires++; });
+    engine.load({{"rules", {
+        {{"id", "automaton"}, {"when", {{"expression", expression}}}, {"do", {{{"action", "automaton"}}}}, {"throttle_ms", 0}},
+        {{"id", "chain"}, {"when", {{"any", any_chain}}}, {"do", {{{"action", "chain"}}}}, {"throttle_ms", 0}}
+    }}});
+    Context logs;
+    for (int i = 0; i < 200; ++i) {
+        logs.set("log", "line " + to_string(i) + ((i % 4 == 0) ? " fault" + to_string(i % 60) : " ok"));
+        engine.tick(logs);
+    }
+    check(ok, automaton_fires == chain_fires && automaton_fires > 0,
+          "contains_any 与 any 链触发次数相同（" + to_string(automaton_fires) + "）");
+
+    // 7. 耗时：50个关键字（仅供参考）
+    auto any_expr = ExpressionParser::parseString(expression);
+    Context line;
+    line.set("log", "2024-05-01 12:00:00 pump station 3: pressure nominal, temperature nominal, flow nominal");
+    const Scalar& text = line.getSlot(SymbolTable::global().lookup("log"));
+    vector<Scalar> needles = strings(keywords);
+    const int N = 20000;
+    size_t sink = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < N; ++i) sink += any_expr->evaluateScalar(line).truthy();
+    double automaton_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / N;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < N; ++i) {
+        for (const auto& needle : needles) {
+            if (Eval::string_contains(text, needle).truthy()) {
+                sink++;
+                break;
+            }
+        }
+    }
+    double chain_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / N;
+    cout << "   50个关键字：contains_any " << static_cast<int>(automaton_ns) << "ns，逐个contains "
+         << static_cast<int>(chain_ns) << "ns" << (sink ? " " : "") << endl;
+
+    cout << "\n=== 字符串匹配测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
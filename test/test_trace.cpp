@@ -0,0 +1,131 @@
+#include "../runtime/runtime.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+static void writeFile(const string& path, const string& bytes) {
+    ofstream file(path, ios::binary | ios::trunc);
+    file.write(bytes.data(), bytes.size());
+}
+
+static size_t fileSize(const string& path) {
+    ifstream file(path, ios::binary | ios::ate);
+    return file ? static_cast<size_t>(file.tellg()) : 0;
+}
+
+int main() {
+    cout << "=== 传感器轨迹录制测试 ===" << endl;
+    bool ok = true;
+    const string path = "trace_test.snt";
+
+    // 1. 录制挂接了录制器的Context的所有写入
+    Context ctx;
+    TraceRecorder recorder;
+    recorder.open(path);
+    ctx.setRecorder(&recorder);
+    ctx.set("temp", 25);
+    ctx.set("temp", -1234567890123LL);
+    ctx.set("humidity", 55.5);
+    ctx.set("door", "open");
+    ctx.set("alarm", true);
+    ctx.set("position", json({{"x", 1.5}, {"y", -2}}));
+    this_thread::sleep_for(chrono::milliseconds(20));
+    ctx.setSlot(SymbolTable::global().intern("temp"), Scalar());
+
+    // 拷贝出的Context不录制
+    Context copy = ctx;
+    copy.set("temp", 99);
+    recorder.close();
+
+    // 2. 读回后与原写入一致，时间单调
+    vector<TraceEvent> events;
+    bool read = TraceReader::readAll(path, events) && events.size() == 7 && recorder.count() == 7;
+    bool same = read &&
+                events[0].value == Scalar::fromInt(25) &&
+                events[1].value == Scalar::fromInt(-1234567890123LL) &&
+                events[2].value == Scalar::fromDouble(55.5) &&
+                events[3].value == Scalar::fromString("open") &&
+                events[4].value == Scalar::fromBool(true) &&
+                events[5].object == json({{"x", 1.5}, {"y", -2}}) &&
+                events[6].value.isNull() &&
+                SymbolTable::global().name(events[2].slot) == "humidity" &&
+                events[6].time_us >= events[5].time_us + 20000;
+    ok = ok && same;
+    cout << "   " << (same ? "✓" : "✗") << " 录制 " << events.size() << " 次写入，读回的键、值和时间一致" << endl;
+
+    // 3. 回放到新的Context得到相同的数据
+    Context replayed;
+    for (const auto& event : events) {
+        applyTraceEvent(replayed, event);
+    }
+    bool applied = replayed.get("humidity") == 55.5 && replayed.get("door") == "open" &&
+                   replayed.get("position") == ctx.get("position") && replayed.get("temp").is_null();
+    ok = ok && applied;
+    cout << "   " << (applied ? "✓" : "✗") << " 回放后Context内容与录制时一致" << endl;
+
+    // 4. 格式错误的文件
+    FILE* file = fopen(path.c_str(), "wb");
+    fputs("not a trace", file);
+    fclose(file);
+    vector<TraceEvent> none;
+    bool rejected = !TraceReader::readAll(path, none);
+    remove(path.c_str());
+    ok = ok && rejected;
+    cout << "   " << (rejected ? "✓" : "✗") << " 拒绝格式错误的文件" << endl;
+
+    // 5. 未关闭的录制器按批刷新，文件中已有完整的记录
+    TraceRecorder open_recorder;
+    open_recorder.open(path);
+    Context live;
+    live.setRecorder(&open_recorder);
+    for (int i = 0; i < 500; ++i) live.set("temp", i);
+    vector<TraceEvent> flushed;
+    bool partial = TraceReader::readAll(path, flushed) && flushed.size() >= TraceRecorder::FLUSH_EVENTS;
+    ok = ok && partial;
+    cout << "   " << (partial ? "✓" : "✗") << " 未关闭时已刷新 " << flushed.size() << " 次写入" << endl;
+    open_recorder.close();
+
+    // 6. 末尾记录不完整时保留之前的完整记录；文件中间的错误仍然拒绝
+    Context many;
+    TraceRecorder many_recorder;
+    many_recorder.open(path);
+    many.setRecorder(&many_recorder);
+    for (int i = 0; i < 20000; ++i) many.set("temp", i);
+    many_recorder.close();
+    ifstream whole(path, ios::binary);
+    string bytes((istreambuf_iterator<char>(whole)), istreambuf_iterator<char>());
+    writeFile(path, bytes.substr(0, bytes.size() - 3));
+    vector<TraceEvent> kept;
+    bool tail = fileSize(path) + 3 == bytes.size() && TraceReader::readAll(path, kept) && kept.size() == 19999 &&
+                kept.back().value == Scalar::fromInt(19998);
+    string middle = bytes;
+    size_t tag = bytes.rfind('S', bytes.size() / 2);
+    middle[tag] = 'X';
+    writeFile(path, middle);
+    vector<TraceEvent> broken;
+    tail = tail && !TraceReader::readAll(path, broken);
+    ok = ok && tail;
+    cout << "   " << (tail ? "✓" : "✗") << " 截断的末尾记录被丢弃，读回 " << kept.size() << " 次写入；中间损坏时拒绝" << endl;
+
+    // 7. 键编号必须按顺序出现，过大的编号和长度不会越界或分配内存
+    string header(TRACE_MAGIC, sizeof(TRACE_MAGIC) - 1);
+    string huge_id = header + "K" + string(9, '\xff') + '\x01' + '\x01' + "a";
+    string huge_length = header + "K" + '\x00' + string(9, '\xff') + '\x01';
+    vector<TraceEvent> ignored;
+    writeFile(path, huge_id);
+    bool bounded = !TraceReader::readAll(path, ignored);
+    writeFile(path, huge_length);
+    bounded = bounded && !TraceReader::readAll(path, ignored) && ignored.empty();
+    remove(path.c_str());
+    ok = ok && bounded;
+    cout << "   " << (bounded ? "✓" : "✗") << " 拒绝乱序的键编号和超长的字符串" << endl;
+
+    cout << "\n=== 传感器轨迹录制测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+// 测试程序共用的辅助函数
+
+// 输出一项检查的结果，失败时把ok置为false
+inline void check(bool& ok, bool passed, const string& message) {
+    ok = ok && passed;
+    cout << "   " << (passed ? "✓" : "✗") << " " << message << endl;
+}
+
+// 随机JSON表达式的组成，用于不同求值/解析方式之间的差分测试
+struct RandomExprSpec {
+    vector<string> ops;         // 二元操作符
+    vector<string> funcs;       // 函数名
+    vector<string> vars;        // 变量名
+    int leaf_rate = 5;          // 每层以1/leaf_rate的概率提前生成叶子
+    int func_rate = 8;          // 以1/func_rate的概率生成函数调用
+    int min_args = 2;           // 函数参数个数
+    int max_args = 2;
+    int unary_rate = 0;         // 以1/unary_rate的概率省略右操作数，0表示总是二元
+};
+
+// 叶子：整数、小数、布尔或变量
+inline json randomLeaf(mt19937& rng, const RandomExprSpec& spec) {
+    switch (rng() % 5) {
+        case 0: return static_cast<int>(rng() % 21) - 10;
+        case 1: return (static_cast<int>(rng() % 80) - 40) / 8.0;
+        case 2: return rng() % 2 == 0;
+        default: return spec.vars[rng() % spec.vars.size()];
+    }
+}
+
+inline json randomExpr(mt19937& rng, int depth, const RandomExprSpec& spec) {
+    if (depth == 0 || rng() % spec.leaf_rate == 0) return randomLeaf(rng, spec);
+    if (!spec.funcs.empty() && rng() % spec.func_rate == 0) {
+        json args = json::array();
+        int count = spec.min_args + static_cast<int>(rng() % (spec.max_args - spec.min_args + 1));
+        for (int i = 0; i < count; ++i) args.push_back(randomExpr(rng, depth - 1, spec));
+        return {{"func", spec.funcs[rng() % spec.funcs.size()]}, {"args", args}};
+    }
+    json expr = {{"op", spec.ops[rng() % spec.ops.size()]}, {"left", randomExpr(rng, depth - 1, spec)}};
+    if (spec.unary_rate == 0 || rng() % spec.unary_rate != 0) expr["right"] = randomExpr(rng, depth - 1, spec);
+    return expr;
+}
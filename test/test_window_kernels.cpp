@@ -0,0 +1,145 @@
+#include "../runtime/runtime.h"
+#include "test_util.h"
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+static bool near(double a, double b) {
+    return fabs(a - b) <= 1e-9 * max(1.0, max(fabs(a), fabs(b)));
+}
+
+// 排序后线性插值的参考实现
+static double referencePercentile(vector<double> values, double p) {
+    sort(values.begin(), values.end());
+    double rank = p / 100.0 * (values.size() - 1);
+    size_t lower = static_cast<size_t>(rank);
+    if (lower + 1 >= values.size()) return values[lower];
+    return values[lower] + (rank - lower) * (values[lower + 1] - values[lower]);
+}
+
+int main() {
+    cout << "=== 窗口聚合内核测试 ===" << endl;
+    bool ok = true;
+    KernelLevel best = WindowKernels::detect();
+    cout << "   CPU支持: " << WindowKernels::levelName(best) << endl;
+
+    // 1. 各级别与标量实现一致（含不足一个向量的长度和尾部）
+    mt19937 rng(3);
+    int mismatches = 0;
+    for (size_t size : {1, 2, 3, 5, 7, 8, 15, 16, 17, 31, 100, 1023, 4096}) {
+        vector<double> data(size);
+        for (double& value : data) value = (static_cast<int>(rng() % 20001) - 10000) / 7.0;
+
+        double sum = 0, mean, deviation = 0;
+        for (double value : data) sum += value;
+        mean = sum / size;
+        for (double value : data) deviation += (value - mean) * (value - mean);
+        double lo = *min_element(data.begin(), data.end());
+        double hi = *max_element(data.begin(), data.end());
+
+        for (int level = KERNEL_SCALAR; level <= best; ++level) {
+            WindowKernels::setLevel(static_cast<KernelLevel>(level));
+            vector<double> scratch = data;
+            double p = (rng() % 1001) / 10.0;
+            bool same = near(WindowKernels::sum(data.data(), size), sum) &&
+                        WindowKernels::min(data.data(), size) == lo &&
+                        WindowKernels::max(data.data(), size) == hi &&
+                        near(WindowKernels::stddev(data.data(), size), sqrt(deviation / size)) &&
+                        near(WindowKernels::percentile(scratch.data(), size, p), referencePercentile(data, p));
+            if (!same && mismatches++ < 5) {
+                cout << "     不一致: level=" << WindowKernels::levelName(static_cast<KernelLevel>(level))
+                     << " n=" << size << endl;
+            }
+        }
+    }
+    WindowKernels::setLevel(best);
+    check(ok, mismatches == 0, "各指令集级别的 sum/min/max/stddev/percentile 与参考实现一致");
+    check(ok, WindowKernels::sum(nullptr, 0) == 0 && WindowKernels::stddev(nullptr, 0) == 0,
+          "空数组返回0");
+
+    // 2. 环形缓冲区回绕后按两段计算
+    HistoryBuffer history;
+    history.addWindow(50);
+    vector<double> samples;
+    for (int i = 0; i < 1000; ++i) {
+        double value = (i * 37) % 101;
+        history.push(value);
+        samples.push_back(value);
+    }
+    bool wrapped = true;
+    for (size_t n : {1, 10, 50, 64}) {
+        vector<double> last(samples.end() - n, samples.end());
+        double mean = 0, deviation = 0;
+        for (double value : last) mean += value;
+        mean /= n;
+        for (double value : last) deviation += (value - mean) * (value - mean);
+        wrapped = wrapped && near(history.stddev(n), sqrt(deviation / n)) &&
+                  near(history.percentile(n, 90), referencePercentile(last, 90)) &&
+                  history.minimum(n) == *min_element(last.begin(), last.end()) &&
+                  near(history.average(n), mean);
+    }
+    check(ok, wrapped, "回绕后的窗口（注册与未注册长度）stddev/percentile/min/avg 正确");
+
+    // 3. 规则中的新函数
+    Engine engine;
+    vector<string> fired;
+    engine.register_action("alert", [&](const json& params, Context&) { fired.push_back(params["id"]); });
+    engine.load(json::parse(R"({
+        "rules": [
+            {"id": "noisy", "when": {"expression": "stddev_last_n(load, 8) > 10"},
+             "do": [{"action": "alert", "params": {"id": "noisy"}}], "throttle_ms": 0},
+            {"id": "p90", "when": {"expression": "percentile_last_n(load, 8, 90) >= 80 && min_last_n(load, 8) > 5"},
+             "do": [{"action": "alert", "params": {"id": "p90"}}], "throttle_ms": 0}
+        ]
+    })"));
+    Context ctx;
+    engine.tick(ctx);
+    bool steady_quiet = true;
+    for (int i = 0; i < 8; ++i) {
+        ctx.set("load", 50);
+        fired.clear();
+        engine.tick(ctx);
+        steady_quiet = steady_quiet && fired.empty();
+    }
+    check(ok, steady_quiet && ctx.history(SymbolTable::global().lookup("load")),
+          "平稳负载不触发，load 注册了历史记录");
+
+    const int spikes[] = {90, 10, 90, 10};
+    for (int value : spikes) {
+        ctx.set("load", value);
+        fired.clear();
+        engine.tick(ctx);
+    }
+    // 最近8个：50 50 50 50 90 10 90 10，标准差 ≈ 25，第90百分位 = 90，最小值 10
+    bool noisy = find(fired.begin(), fired.end(), "noisy") != fired.end();
+    bool p90 = find(fired.begin(), fired.end(), "p90") != fired.end();
+    check(ok, noisy && p90, "stddev_last_n / percentile_last_n / min_last_n 在规则中求值");
+
+    auto missing = ExpressionParser::parseString("percentile_last_n(load, 8)");
+    check(ok, missing && missing->type == EXPR_VALUE, "percentile_last_n 缺少百分位参数时折叠为null");
+
+    // 4. 大窗口扫描耗时：各级别对比（仅供参考）
+    vector<double> large(65536);
+    for (double& value : large) value = (rng() % 100000) / 100.0;
+    for (int level = KERNEL_SCALAR; level <= best; ++level) {
+        WindowKernels::setLevel(static_cast<KernelLevel>(level));
+        double sink = 0;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < 200; ++i) {
+            sink += WindowKernels::sum(large.data(), large.size()) + WindowKernels::stddev(large.data(), large.size());
+        }
+        double us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / 200;
+        cout << "   " << WindowKernels::levelName(static_cast<KernelLevel>(level)) << "：sum+stddev(65536) "
+             << static_cast<int>(us) << "us" << (sink > 0 ? "" : " ") << endl;
+    }
+    WindowKernels::setLevel(best);
+
+    cout << "\n=== 窗口聚合内核测试" << (ok ? "通过" : "失败") << " ===" << endl;
+    return ok ? 0 : 1;
+}
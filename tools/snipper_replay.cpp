@@ -0,0 +1,336 @@
+// 轨迹回放工具：把录制的传感器轨迹回放给规则引擎或行为树，统计吞吐量和tick延迟
+//
+// 用法：
+//   snipper_replay <配置.json> <轨迹文件> [--realtime] [--speed 倍数] [--loops 次数]
+//   snipper_replay --generate <配置.json> <轨迹文件> [--events 数量] [--interval-us 微秒] [--batch 每次tick的写入数] [--seed 种子]
+//
+// 配置含"rules"时加载到Engine，含"root"时作为行为树加载到BTManager（tasks/下的任务文件）
+// 配置中的"context"作为回放前的初始数据
+// 同一时间戳的写入合并后执行一次tick；默认以最快速度回放，--realtime按录制时的时间间隔回放
+//
+// 轨迹可以在运行snipper时设置环境变量SNIPPER_TRACE录制，也可以用--generate根据配置生成
+
+#include "../runtime/runtime.h"
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <set>
+#include <map>
+#include <nlohmann/json.hpp>
+
+using namespace nlohmann;
+using namespace std;
+
+// 丢弃输出（行为树默认节点会打印每次执行）
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+static void usage() {
+    cerr << "用法:" << endl;
+    cerr << "  snipper_replay <配置.json> <轨迹文件> [--realtime] [--speed 倍数] [--loops 次数]" << endl;
+    cerr << "  snipper_replay --generate <配置.json> <轨迹文件> [--events 数量] [--interval-us 微秒] "
+         << "[--batch 每次tick的写入数] [--seed 种子]" << endl;
+}
+
+static bool loadConfig(const string& path, json& cfg) {
+    ifstream file(path);
+    if (!file.is_open()) {
+        cerr << "Error: Cannot open " << path << endl;
+        return false;
+    }
+    cfg = json::parse(file, nullptr, false);
+    if (cfg.is_discarded() || (!cfg.contains("rules") && !cfg.contains("root"))) {
+        cerr << "Error: " << path << " is neither a rule set nor a behavior tree" << endl;
+        return false;
+    }
+    return true;
+}
+
+// 收集规则条件中出现的键和比较值
+static void collectRuleKeys(const json& when, map<string, vector<json>>& keys) {
+    if (when.contains("all") && when["all"].is_array()) {
+        for (const auto& child : when["all"]) collectRuleKeys(child, keys);
+    } else if (when.contains("any") && when["any"].is_array()) {
+        for (const auto& child : when["any"]) collectRuleKeys(child, keys);
+    } else if (when.contains("left") && when["left"].is_string()) {
+        keys[when["left"].get<string>()].push_back(when.value("right", json()));
+    }
+}
+
+// 收集行为树条件节点中出现的键和比较值
+static void collectTreeKeys(const json& node, map<string, vector<json>>& keys) {
+    if (!node.is_object()) return;
+    if (node.value("type", "") == "condition" && node.contains("params")) {
+        const json& params = node["params"];
+        if (params.contains("key") && params["key"].is_string()) {
+            json value = params.contains("threshold") ? params["threshold"] : params.value("expected", json());
+            keys[params["key"].get<string>()].push_back(value);
+        }
+    }
+    if (node.contains("children")) {
+        for (const auto& child : node["children"]) collectTreeKeys(child, keys);
+    }
+    if (node.contains("child")) collectTreeKeys(node["child"], keys);
+}
+
+// 在候选值附近随机取值：数字在候选值范围两侧各扩展一半，其余从候选值中选
+static json randomValue(const vector<json>& candidates, mt19937& rng) {
+    double low = 0, high = 0;
+    bool numeric = false;
+    vector<json> others;
+    for (const auto& value : candidates) {
+        if (value.is_number()) {
+            double v = value.get<double>();
+            low = numeric ? min(low, v) : v;
+            high = numeric ? max(high, v) : v;
+            numeric = true;
+        } else if (!value.is_null()) {
+            others.push_back(value);
+        }
+    }
+
+    if (numeric && (others.empty() || rng() % 2)) {
+        double span = max(1.0, (high - low) / 2);
+        uniform_real_distribution<double> dist(low - span, high + span);
+        bool integral = true;
+        for (const auto& value : candidates) {
+            integral = integral && (!value.is_number() || value.is_number_integer());
+        }
+        double v = dist(rng);
+        return integral ? json(static_cast<int64_t>(v)) : json(v);
+    }
+    if (!others.empty()) {
+        return others[rng() % others.size()];
+    }
+    return json(static_cast<int>(rng() % 100));
+}
+
+static int generate(const string& config_path, const string& trace_path, size_t events,
+                    uint64_t interval_us, size_t batch, uint32_t seed) {
+    json cfg;
+    if (!loadConfig(config_path, cfg)) return 1;
+
+    map<string, vector<json>> keys;
+    if (cfg.contains("rules")) {
+        for (const auto& rule : cfg["rules"]) {
+            if (rule.contains("when")) collectRuleKeys(rule["when"], keys);
+        }
+    } else {
+        collectTreeKeys(cfg["root"], keys);
+    }
+    // 初始数据中有的键只取与初始值同类型的候选值，避免条件函数因类型不符失败
+    if (cfg.contains("context") && cfg["context"].is_object()) {
+        for (const auto& item : cfg["context"].items()) {
+            const json& initial = item.value();
+            if (initial.is_structured()) continue;
+            vector<json>& candidates = keys[item.key()];
+            candidates.erase(remove_if(candidates.begin(), candidates.end(), [&](const json& value) {
+                return value.is_number() != initial.is_number() || value.is_string() != initial.is_string() ||
+                       value.is_boolean() != initial.is_boolean();
+            }), candidates.end());
+            candidates.push_back(initial);
+            if (initial.is_boolean()) candidates.push_back(!initial.get<bool>());
+        }
+    }
+    if (keys.empty()) {
+        cerr << "Error: no sensor keys found in " << config_path << endl;
+        return 1;
+    }
+
+    vector<pair<SlotId, const vector<json>*>> slots;
+    for (const auto& pair : keys) {
+        slots.emplace_back(SymbolTable::global().intern(pair.first), &pair.second);
+    }
+
+    TraceRecorder recorder;
+    if (!recorder.open(trace_path)) {
+        cerr << "Error: Cannot create " << trace_path << endl;
+        return 1;
+    }
+    mt19937 rng(seed);
+    batch = max<size_t>(batch, 1);
+    for (size_t i = 0; i < events; ++i) {
+        const auto& slot = slots[rng() % slots.size()];
+        recorder.recordAt((i / batch) * interval_us, slot.first, Scalar::fromJson(randomValue(*slot.second, rng)));
+    }
+    recorder.close();
+
+    cout << "Generated " << events << " events over " << keys.size() << " keys to " << trace_path << endl;
+    return 0;
+}
+
+static double percentile(vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[min(index, sorted.size() - 1)];
+}
+
+static int replay(const string& config_path, const string& trace_path, bool realtime, double speed, int loops) {
+    json cfg;
+    if (!loadConfig(config_path, cfg)) return 1;
+
+    vector<TraceEvent> events;
+    if (!TraceReader::readAll(trace_path, events)) {
+        cerr << "Error: Cannot read trace " << trace_path << endl;
+        return 1;
+    }
+
+    // 按规则集或行为树加载；动作只计数
+    bool rules_mode = cfg.contains("rules");
+    Engine engine;
+    BTManager trees;
+    uint64_t actions_fired = 0;
+    if (rules_mode) {
+        set<string> names;
+        for (const auto& rule : cfg["rules"]) {
+            if (!rule.contains("do")) continue;
+            for (const auto& step : rule["do"]) names.insert(step.value("action", ""));
+        }
+        for (const auto& name : names) {
+            engine.register_action(name, [&](const json&, Context&) { actions_fired++; });
+        }
+        engine.load(cfg);
+    } else if (!trees.loadTree("replay", cfg)) {
+        return 1;
+    }
+
+    Context ctx;
+    if (cfg.contains("context") && cfg["context"].is_object()) {
+        for (const auto& item : cfg["context"].items()) {
+            ctx.set(item.key(), item.value());
+        }
+    }
+
+    // 同一时间戳的写入为一组
+    vector<size_t> groups;
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (i == 0 || events[i].time_us != events[i - 1].time_us) groups.push_back(i);
+    }
+    groups.push_back(events.size());
+    size_t ticks_per_loop = groups.size() - 1;
+
+    vector<double> latencies;
+    latencies.reserve(ticks_per_loop * loops);
+    uint64_t tree_status[3] = {0, 0, 0};
+    uint64_t tree_errors = 0;
+    uint64_t evaluations_before = engine.get_evaluation_count();
+
+    NullBuffer null_buffer;
+    streambuf* cout_buffer = cout.rdbuf(&null_buffer);
+    auto start = chrono::steady_clock::now();
+    for (int loop = 0; loop < loops; ++loop) {
+        auto loop_start = chrono::steady_clock::now();
+        for (size_t g = 0; g < ticks_per_loop; ++g) {
+            if (realtime) {
+                auto due = chrono::microseconds(static_cast<int64_t>(events[groups[g]].time_us / speed));
+                this_thread::sleep_until(loop_start + due);
+            }
+            for (size_t i = groups[g]; i < groups[g + 1]; ++i) {
+                applyTraceEvent(ctx, events[i]);
+            }
+
+            auto tick_start = chrono::steady_clock::now();
+            if (rules_mode) {
+                engine.tick(ctx);
+            } else {
+                try {
+                    tree_status[static_cast<int>(trees.executeTree("replay", ctx))]++;
+                } catch (const exception& e) {
+                    tree_errors++;
+                }
+            }
+            latencies.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - tick_start).count());
+        }
+    }
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout.rdbuf(cout_buffer);
+
+    uint64_t ticks = latencies.size();
+    double tick_total = 0;
+    for (double us : latencies) tick_total += us;
+    sort(latencies.begin(), latencies.end());
+
+    cout << "=== 回放结果 ===" << endl;
+    cout << "配置: " << config_path << " (" << (rules_mode ? to_string(engine.get_rule_count()) + " 条规则" : string("行为树"))
+         << ")" << endl;
+    cout << "轨迹: " << trace_path << " (" << events.size() << " 次写入, " << ticks_per_loop << " 次tick"
+         << (loops > 1 ? ", 回放 " + to_string(loops) + " 遍" : string()) << ")" << endl;
+    cout << "模式: ";
+    if (realtime) {
+        cout << "按录制时间回放 x" << speed << endl;
+    } else {
+        cout << "最快速度" << endl;
+    }
+    cout << "总耗时: " << elapsed << " s, tick耗时合计 " << tick_total / 1e6 << " s" << endl;
+    cout << "吞吐量: " << ticks / max(tick_total / 1e6, 1e-9) << " tick/s, "
+         << events.size() * loops / max(elapsed, 1e-9) << " 写入/s" << endl;
+    if (rules_mode) {
+        uint64_t evaluations = engine.get_evaluation_count() - evaluations_before;
+        cout << "规则评估: " << evaluations << " 次, " << evaluations / max(tick_total / 1e6, 1e-9) << " 次/s" << endl;
+        cout << "动作触发: " << actions_fired << " 次" << endl;
+    } else {
+        cout << "行为树结果: 成功 " << tree_status[0] << ", 失败 " << tree_status[1] << ", 运行中 " << tree_status[2];
+        if (tree_errors) cout << ", 异常 " << tree_errors;
+        cout << endl;
+    }
+    cout << "tick延迟(us): p50 " << percentile(latencies, 0.50) << ", p90 " << percentile(latencies, 0.90)
+         << ", p99 " << percentile(latencies, 0.99) << ", max " << (latencies.empty() ? 0 : latencies.back()) << endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    vector<string> args(argv + 1, argv + argc);
+    if (args.empty()) {
+        usage();
+        return 1;
+    }
+
+    bool generating = args[0] == "--generate";
+    vector<string> positional;
+    bool realtime = false;
+    double speed = 1.0;
+    int loops = 1;
+    size_t events = 100000, batch = 4;
+    uint64_t interval_us = 1000;
+    uint32_t seed = 1;
+
+    for (size_t i = generating ? 1 : 0; i < args.size(); ++i) {
+        const string& arg = args[i];
+        bool has_value = i + 1 < args.size();
+        if (arg == "--realtime") {
+            realtime = true;
+        } else if (arg == "--speed" && has_value) {
+            speed = max(stod(args[++i]), 1e-3);
+        } else if (arg == "--loops" && has_value) {
+            loops = max(stoi(args[++i]), 1);
+        } else if (arg == "--events" && has_value) {
+            events = stoul(args[++i]);
+        } else if (arg == "--interval-us" && has_value) {
+            interval_us = stoull(args[++i]);
+        } else if (arg == "--batch" && has_value) {
+            batch = stoul(args[++i]);
+        } else if (arg == "--seed" && has_value) {
+            seed = static_cast<uint32_t>(stoul(args[++i]));
+        } else if (arg.compare(0, 2, "--") == 0) {
+            cerr << "Unknown option: " << arg << endl;
+            usage();
+            return 1;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() != 2) {
+        usage();
+        return 1;
+    }
+
+    if (generating) {
+        return generate(positional[0], positional[1], events, interval_us, batch, seed);
+    }
+    return replay(positional[0], positional[1], realtime, speed, loops);
+}